@@ -43,6 +43,10 @@ open class DrawClip : DrawAspect {
         return nil
     }
 
+    open override var canDrawTranslatedPath: Bool {
+        return true
+    }
+
     // MARK: - AJRXMLCoding
 
     open class override var ajr_nameForXMLArchiving: String {
@@ -77,6 +77,21 @@ typedef NSString *DrawAspectId NS_EXTENSIBLE_STRING_ENUM;
  */
 @property (nonatomic,readonly) BOOL rendersToCanvas;
 
+/**
+ Whether the aspect still draws when its graphic is drawn at `DrawGraphicLevelOfDetailReduced`, which happens when the graphic covers only a few device pixels. Aspects that cost a lot to draw for what they add at that size, such as shadows, reflections, and text, return NO. The default is YES.
+ */
+@property (nonatomic,readonly) BOOL drawsAtReducedDetail;
+
+/**
+ The color that best stands in for the aspect when its graphic is small enough to be drawn as a filled box, or `nil` if the aspect doesn't contribute a color. The default is `nil`.
+ */
+@property (nonatomic,readonly,nullable) NSColor *reducedDetailColor;
+
+/**
+ Whether the aspect draws only from the path it's handed. When every aspect of a large graphic does, moving the graphic doesn't rewrite its path. Instead, the aspects are handed the path from before the move, drawn into a context translated into place. Aspects that also draw from their graphic's frame or bounds must return NO. The default is NO.
+ */
+@property (nonatomic,readonly) BOOL canDrawTranslatedPath;
+
 - (_Nullable DrawGraphicCompletionBlock)drawPath:(AJRBezierPath *)path withPriority:(DrawAspectPriority)priority;
 - (AJRBezierPath *)renderPathForPath:(AJRBezierPath *)path withPriority:(DrawAspectPriority)priority;
 
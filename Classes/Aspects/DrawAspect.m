@@ -123,6 +123,18 @@ static NSMutableDictionary  *_aspects = nil;
     return YES;
 }
 
+- (BOOL)drawsAtReducedDetail {
+    return YES;
+}
+
+- (NSColor *)reducedDetailColor {
+    return nil;
+}
+
+- (BOOL)canDrawTranslatedPath {
+    return NO;
+}
+
 #pragma mark - AJREditableObject
 
 //+ (NSSet<NSString *> *)propertiesToIgnore {
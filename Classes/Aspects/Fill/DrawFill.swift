@@ -197,9 +197,16 @@ open class DrawFill : DrawAspect, AJREquatable {
     
     open override func isPoint(_ point: NSPoint, in path: AJRBezierPath, with priority: DrawAspectPriority) -> Bool {
         if let graphic = graphic {
-            path.flatness = graphic.flatness
-            path.windingRule = windingRule
-            return path.isHit(by: point)
+            let flattened = graphic.path === path ? graphic.flattenedPath : DrawFlattenedPath(path: path, flatness: graphic.flatness)
+            return flattened.contains(point, evenOdd: windingRule == .evenOdd)
+        }
+        return false
+    }
+
+    open override func doesRect(_ rect: NSRect, intersect path: AJRBezierPath, with priority: DrawAspectPriority) -> Bool {
+        if let graphic = graphic {
+            let flattened = graphic.path === path ? graphic.flattenedPath : DrawFlattenedPath(path: path, flatness: graphic.flatness)
+            return flattened.intersects(rect, evenOdd: windingRule == .evenOdd)
         }
         return false
     }
@@ -214,9 +221,24 @@ open class DrawFill : DrawAspect, AJREquatable {
     }
 
     open override func draw(_ path: AJRBezierPath, with priority: DrawAspectPriority) -> DrawGraphicCompletionBlock? {
+        // Gradients and images are expensive to draw, so at reduced detail, such as during a drag, they're approximated with a solid color.
+        if graphic?.drawingLevelOfDetail == .reduced, !(filler is DrawFillColor) {
+            (filler.reducedDetailColor ?? NSColor.lightGray).set()
+            path.windingRule = windingRule
+            path.fill()
+            return nil
+        }
         return filler.draw(path, with: priority)
     }
 
+    open override var reducedDetailColor: NSColor? {
+        return filler.reducedDetailColor
+    }
+
+    open override var canDrawTranslatedPath: Bool {
+        return true
+    }
+
     // MARK: - AJRXMLCoding
 
     internal class DrawFillError : DrawFiller {
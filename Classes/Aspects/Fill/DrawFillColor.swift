@@ -84,6 +84,10 @@ open class DrawFillColor : DrawFiller {
         return nil
     }
 
+    open override var reducedDetailColor: NSColor? {
+        return color
+    }
+
     // MARK: - NSCopying
 
     open override func copy(with zone: NSZone?) -> Any {
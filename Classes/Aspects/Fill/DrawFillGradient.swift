@@ -125,6 +125,10 @@ open class DrawFillGradient : DrawFiller {
         return nil
     }
 
+    open override var reducedDetailColor: NSColor? {
+        return gradient?.interpolatedColor(atLocation: 0.5)
+    }
+
     // MARK: - AJRXMLCoding
 
     open override func encode(with coder: AJRXMLCoder) {
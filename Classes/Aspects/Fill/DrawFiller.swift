@@ -36,6 +36,11 @@ open class DrawFiller : NSObject, AJRXMLCoding, NSCopying {
         return nil
     }
 
+    /// The color to draw the fill with when its graphic is only a placeholder. See `DrawAspect.reducedDetailColor`.
+    open var reducedDetailColor : NSColor? {
+        return nil
+    }
+
     // MARK: - AJRXMLCoding
 
     public func encode(with coder: AJRXMLCoder) {
@@ -96,6 +96,10 @@ open class DrawReflection : DrawAspect {
         return bounds
     }
 
+    override open var drawsAtReducedDetail: Bool {
+        return false
+    }
+
     override class open func defaultAspect(for graphic: DrawGraphic) -> DrawAspect? {
         let reflection = DrawReflection(graphic: graphic)
         reflection.isActive = false
@@ -119,6 +119,10 @@ open class DrawShadow : DrawAspect {
         return true
     }
 
+    open override var drawsAtReducedDetail: Bool {
+        return false
+    }
+
     open class override func defaultAspect(for graphic: DrawGraphic) -> DrawAspect? {
         return DrawShadow(graphic: graphic)
     }
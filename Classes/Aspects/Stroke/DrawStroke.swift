@@ -203,23 +203,39 @@ open class DrawStroke : DrawAspect, AJREquatable {
         return nil
     }
     
+    open override var reducedDetailColor: NSColor? {
+        return color
+    }
+
+    open override var canDrawTranslatedPath: Bool {
+        return true
+    }
+
     open override func renderPath(for path: AJRBezierPath, with priority: DrawAspectPriority) -> AJRBezierPath {
         return configurePath(path).fromStroked()
     }
     
-    open override func isPoint(_ point: NSPoint, in path: AJRBezierPath, with priority: DrawAspectPriority) -> Bool {
-        let path = configurePath(path)
-        let savedLineWidth = path.lineWidth
-        if savedLineWidth < 5.0 {
-            path.lineWidth = 5.0
+    /// The width the stroke is hit tested at. This matches `configurePath(_:)`, which never strokes thinner than the page's error.
+    internal var hitWidth : CGFloat {
+        let error = graphic?.page?.error ?? 0.0
+        return width < error ? error : width
+    }
+
+    /// Returns the graphic's cached flattened path when `path` is the graphic's own path, which it almost always is, otherwise flattens `path`.
+    internal func flattenedPath(for path: AJRBezierPath) -> DrawFlattenedPath {
+        if let graphic, graphic.path === path {
+            return graphic.flattenedPath
         }
-        let hit = path.isStrokeHit(by: point)
-        path.lineWidth = savedLineWidth
-        return hit
+        return DrawFlattenedPath(path: path, flatness: graphic?.flatness ?? 1.0)
+    }
+
+    open override func isPoint(_ point: NSPoint, in path: AJRBezierPath, with priority: DrawAspectPriority) -> Bool {
+        // Thin strokes are hard to hit, so treat them as at least 5 points wide.
+        return flattenedPath(for: path).isStrokeHit(by: point, width: max(hitWidth, 5.0))
     }
     
     open override func doesRect(_ rect: NSRect, intersect path: AJRBezierPath, with priority: DrawAspectPriority) -> Bool {
-        return configurePath(path).isStrokeHit(by: rect)
+        return flattenedPath(for: path).isStrokeHit(by: rect, width: hitWidth)
     }
     
     open override var boundsAdjustment: AJRRectAdjustment {
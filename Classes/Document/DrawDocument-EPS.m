@@ -32,6 +32,7 @@
 #import "DrawDocument.h"
 
 #import "DrawGraphic.h"
+#import <Draw/Draw-Swift.h>
 
 #import <AJRInterfaceFoundation/AJRInterfaceFoundation.h>
 #import <AJRInterface/AJRInterface.h>
@@ -98,6 +99,7 @@
     NSMutableData *data;
 
     if ([graphics count]) {
+        [DrawLinkUpdater flush];
         for (DrawGraphic *graphic in graphics) {
             if (NSEqualRects(bounds, NSZeroRect)) {
                 bounds = [graphic dirtyBounds];
@@ -47,32 +47,7 @@ static inline CGFloat SNAP(CGFloat a, CGFloat b) {
 }
 
 - (void)updateGrid {
-    NSInteger x, y, i;
-    short w, h;
-    NSRect bounds = {{0.0, 0.0}, [self.paper sizeForOrientation:self.orientation]};
-
-    if (_storage.gridSpacing <= (0.1 * [self scale])) return;
-
-    x = (NSInteger)floor(bounds.size.width / _storage.gridSpacing);
-    y = (NSInteger)floor(bounds.size.height / _storage.gridSpacing);
-
-    if (_grid) {
-        [_grid removeAllPoints];
-    } else {
-        _grid = [[AJRBezierPath alloc] init];
-        [_grid setLineWidth:AJRHairLineWidth];
-    }
-    w = bounds.size.width;
-    h = bounds.size.height;
-    for (i = 1; i <= y; i++) {
-        [_grid moveToPoint:(NSPoint){0, i * _storage.gridSpacing}];
-        [_grid lineToPoint:(NSPoint){w, i * _storage.gridSpacing}];
-    }
-    for (i = 1; i <= x; i++) {
-        [_grid moveToPoint:(NSPoint){i * _storage.gridSpacing, 0}];
-        [_grid lineToPoint:(NSPoint){i * _storage.gridSpacing, h}];
-    }
-
+    // The grid itself is drawn from tiles cached by DrawGridRenderer, keyed on spacing and scale, so there's nothing to rebuild here.
     [self.gridSegments setSelected:self.gridVisible forSegment:0];
     [self.gridSegments setSelected:self.gridEnabled forSegment:1];
 }
@@ -219,17 +194,8 @@ static inline CGFloat SNAP(CGFloat a, CGFloat b) {
 
 - (void)drawGridInRect:(NSRect)rect inView:(NSView *)page {
     if (_storage.gridVisible && (_storage.gridSpacing * [self scale]) > 3.0) {
-        CGFloat	scale = [self scale];
-
-        [_storage.gridColor set];
-        [_grid setStrokePointTransform:^(NSPoint point) {
-            NSRect	rect = (NSRect){point, {1.0, 1.0}};
-            CGFloat	offset = (1.0 / scale) / 2.0;
-            rect = [page centerScanRect:rect];
-            return (NSPoint){rect.origin.x - offset, rect.origin.y - offset};
-        }];
-        [_grid stroke];
-        [_grid setStrokePointTransform:NULL];
+        NSRect paperBounds = {NSZeroPoint, [self.paper sizeForOrientation:self.orientation]};
+        [DrawGridRenderer drawGridWithSpacing:_storage.gridSpacing color:_storage.gridColor in:rect paperBounds:paperBounds];
     }
 }
 
@@ -83,9 +83,7 @@
     
     subgroup = [[NSArray alloc] initWithArray:[self sortedSelection]];
     
-    for (DrawGraphic *graphic in subgroup) {
-        [self removeGraphicFromSelection:graphic];
-    }
+    [self removeGraphicsFromSelection:subgroup];
     for (DrawGraphic *graphic in subgroup) {
         [group addSubgraphic:graphic];
     }
@@ -115,8 +113,10 @@
     for (DrawGraphic *graphic in subgraphics) {
         [[self page] addGraphic:graphic];
     }
+    [self beginSelectionChanges];
     [self clearSelection];
     [self addGraphicsToSelection:subgraphics];
+    [self endSelectionChanges];
     
     [self ping];
 }
@@ -152,8 +152,11 @@
         _storage.group = [_storage.group supergraphic];
         [_storage.group setEditing:YES];
         
+        // Go through the selection methods, so observers, the inspectors and the selection summary all hear about it.
+        [self beginSelectionChanges];
         [self clearSelection];
-        [_storage.selection addObject:oldGroup];
+        [self addGraphicToSelection:oldGroup];
+        [self endSelectionChanges];
         
         [_storage.group	setNeedsDisplay];
         [oldGroup setNeedsDisplay];
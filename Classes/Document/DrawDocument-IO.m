@@ -115,6 +115,9 @@ NSString * const DrawViewNewURLKey = @"DrawViewNewURLKey";
     DrawFilter *filter = nil;
     NSFileWrapper *fileWrapper = nil;
     
+    // Don't save links that are still waiting to catch up with their graphics.
+    [DrawLinkUpdater flush];
+
     filter = [DrawFilter writeFilterForType:typeName];
     if (filter == nil) {
         localError = [NSError errorWithDomain:DrawDocumentErrorDomain format:@"There is not registered output filter for the file type '%@'.", typeName];
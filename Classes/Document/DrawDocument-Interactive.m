@@ -0,0 +1,108 @@
+/*
+ DrawDocument-Interactive.m
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "DrawDocument.h"
+
+#import "DrawGraphic.h"
+#import "DrawPage.h"
+
+@implementation DrawDocument (Interactive)
+
++ (NSTimeInterval)interactiveSettleDelay {
+    return [[NSUserDefaults standardUserDefaults] doubleForKey:DrawInteractiveSettleDelayKey];
+}
+
+- (void)beginInteractiveDrawingOfGraphics:(id <NSFastEnumeration>)graphics {
+    // If we were waiting to settle from a previous interaction, we're not any more.
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(_settleInteractiveDrawing) object:nil];
+
+    if (graphics == nil) {
+        _drawsAllGraphicsInteractively = YES;
+    } else {
+        if (_interactiveGraphics == nil) {
+            // Graphics may override -isEqual:, but we care about identity.
+            _interactiveGraphics = [[NSHashTable alloc] initWithOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality capacity:0];
+        }
+        for (DrawGraphic *graphic in graphics) {
+            [_interactiveGraphics addObject:graphic];
+        }
+    }
+    _interactiveDrawingDepth += 1;
+}
+
+- (void)endInteractiveDrawing {
+    if (_interactiveDrawingDepth > 0) {
+        _interactiveDrawingDepth -= 1;
+        if (_interactiveDrawingDepth == 0) {
+            [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(_settleInteractiveDrawing) object:nil];
+            [self performSelector:@selector(_settleInteractiveDrawing) withObject:nil afterDelay:[DrawDocument interactiveSettleDelay]];
+        }
+    }
+}
+
+- (void)_settleInteractiveDrawing {
+    if (_interactiveDrawingDepth == 0) {
+        NSArray<DrawGraphic *> *graphics = [_interactiveGraphics allObjects];
+        BOOL drewAllGraphics = _drawsAllGraphicsInteractively;
+
+        _interactiveGraphics = nil;
+        _drawsAllGraphicsInteractively = NO;
+
+        // Now redraw at full quality.
+        if (drewAllGraphics) {
+            [self setPagesNeedDisplay:YES];
+        } else {
+            for (DrawGraphic *graphic in graphics) {
+                [graphic setNeedsDisplay];
+            }
+        }
+    }
+}
+
+- (BOOL)isDrawingInteractively {
+    return _drawsAllGraphicsInteractively || _interactiveGraphics.count > 0;
+}
+
+- (BOOL)isDrawingGraphicInteractively:(DrawGraphic *)graphic {
+    if (_drawsAllGraphicsInteractively) {
+        return YES;
+    }
+    if (_interactiveGraphics.count > 0) {
+        for (DrawGraphic *ancestor = graphic; ancestor != nil; ancestor = [ancestor supergraphic]) {
+            if ([_interactiveGraphics containsObject:ancestor]) {
+                return YES;
+            }
+        }
+    }
+    return NO;
+}
+
+@end
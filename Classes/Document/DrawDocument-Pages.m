@@ -128,6 +128,7 @@
         NSInteger savedPageNumber = _storage.pageNumber;
         
         _isPrinting = YES;
+        [DrawLinkUpdater flush];
         [[NSPrintOperation printOperationWithView:self.pagedView printInfo:self.printInfo] runOperation];
         _isPrinting = NO;
         _storage.pageNumber = savedPageNumber;
@@ -57,9 +57,8 @@ NSString * const DrawGraphicPboardType = @"com.ajr.draw.graphic";
     _storage.copyOffset = (NSSize){spacing, -spacing};
 }
 
-- (void)copy:(id)sender {
+- (BOOL)copyToPasteboard:(NSPasteboard *)pasteboard {
     if ([_storage.selection count]) {
-        NSPasteboard *pasteboard = [NSPasteboard generalPasteboard];
         NSArray *selection = [self sortedSelection];
 
         [pasteboard declareTypes:[NSArray arrayWithObjects:DrawGraphicPboardType, NSPasteboardTypePDF, nil] owner:nil];
@@ -69,32 +68,31 @@ NSString * const DrawGraphicPboardType = @"com.ajr.draw.graphic";
         _useShallowEncode = NO;
 
         [self _resetCopyParameters];
-    } else {
+
+        return YES;
+    }
+    return NO;
+}
+
+- (void)copy:(id)sender {
+    if (![self copyToPasteboard:[NSPasteboard generalPasteboard]]) {
         NSBeep();
     }
 }
 
 - (void)cut:(id)sender {
-    if ([_storage.selection count]) {
-        NSPasteboard *pasteboard = [NSPasteboard generalPasteboard];
-        NSArray *selection = [self sortedSelection];
-
-        [pasteboard declareTypes:[NSArray arrayWithObjects:DrawGraphicPboardType, NSPasteboardTypePDF, nil] owner:nil];
-        _useShallowEncode = YES;
-        [pasteboard setDrawGraphics:selection forType:DrawGraphicPboardType];
-        [pasteboard setDrawGraphics:selection forType:NSPasteboardTypePDF];
-        _useShallowEncode = NO;
-
+    if ([self copyToPasteboard:[NSPasteboard generalPasteboard]]) {
         [self deleteSelection];
-
-        [self _resetCopyParameters];
     } else {
         NSBeep();
     }
 }
 
 - (void)paste:(id)sender {
-    NSPasteboard *pasteboard = [NSPasteboard generalPasteboard];
+    [self pasteFromPasteboard:[NSPasteboard generalPasteboard]];
+}
+
+- (void)pasteFromPasteboard:(NSPasteboard *)pasteboard {
     NSString *type;
 
     type = [pasteboard availableTypeFromArray:[NSArray arrayWithObjects:DrawGraphicPboardType, nil]];
@@ -116,8 +114,10 @@ NSString * const DrawGraphicPboardType = @"com.ajr.draw.graphic";
             }
             _storage.copyOffset = (NSSize){_storage.copyOffset.width + _storage.copyDelta.x, _storage.copyOffset.height + _storage.copyDelta.y};
 
+            [self beginSelectionChanges];
             [self clearSelection];
             [self addGraphicsToSelection:graphics];
+            [self endSelectionChanges];
         }
     }
 }
@@ -82,38 +82,131 @@ static NSComparisonResult _compareGraphics(DrawGraphic *first, DrawGraphic *seco
 }
 
 - (void)addGraphicsToSelection:(id <NSFastEnumeration,NSCopying>)graphics {
-    [self willChangeValueForKey:@"selection"];
-    NSArray<DrawGraphic *> *currentSelection = _storage.selection.allObjects;
+    [self beginSelectionChanges];
     for (DrawGraphic *graphic in [graphics copyWithZone:NULL]) {
-        [_storage.selection addObject:graphic];
-        [graphic.page setNeedsDisplayInRect:graphic.dirtyBounds];
-    }
-    if (currentSelection.count > 0) {
-        [self.inspectorGroupsViewController pop:currentSelection for:DrawInspectorIdentifierGraphic];
+        if (![_storage.selection containsObject:graphic]) {
+            [self _noteSelectionWillChange];
+            [_storage.selection addObject:graphic];
+            [_selectionSummary addGraphic:graphic];
+            [self _noteSelectionChangeForGraphic:graphic];
+        }
     }
-    [self.inspectorGroupsViewController push:_storage.selection.allObjects for:AJRInspectorContentIdentifierAny];
-    [self didChangeValueForKey:@"selection"];
+    [self endSelectionChanges];
 }
 
 - (void)removeGraphicsFromSelection:(id <NSFastEnumeration,NSCopying>)graphics {
-    [self willChangeValueForKey:@"selection"];
-    NSArray<DrawGraphic *> *currentSelection = _storage.selection.allObjects;
+    [self beginSelectionChanges];
     for (DrawGraphic *graphic in [graphics copyWithZone:NULL]) {
-        [graphic.page setNeedsDisplayInRect:graphic.dirtyBounds];
-        [graphic setEditing:NO];
-        [_storage.selection removeObject:graphic];
+        if ([_storage.selection containsObject:graphic]) {
+            [self _noteSelectionWillChange];
+            [self _noteSelectionChangeForGraphic:graphic];
+            [graphic setEditing:NO];
+            [_storage.selection removeObject:graphic];
+            [_selectionSummary removeGraphic:graphic];
+        }
     }
-    if (currentSelection.count > 0) {
-        [self.inspectorGroupsViewController pop:currentSelection for:AJRInspectorContentIdentifierAny];
+    [self endSelectionChanges];
+}
+
+#pragma mark - Selection Changes
+
+- (void)beginSelectionChanges {
+    _selectionChangeDepth += 1;
+}
+
+- (void)endSelectionChanges {
+    if (_selectionChangeDepth > 0) {
+        _selectionChangeDepth -= 1;
+        if (_selectionChangeDepth == 0 && _selectionDidChange) {
+            [self _commitSelectionChanges];
+        }
     }
-    if (_storage.selection.count > 0) {
-        [self.inspectorGroupsViewController push:_storage.selection.allObjects for:AJRInspectorContentIdentifierAny];
-    } else {
-        [self.inspectorGroupsViewController push:@[_storage.templateGraphic] for:AJRInspectorContentIdentifierAny];
+}
+
+- (void)changeSelection:(void (^)(void))block {
+    [self beginSelectionChanges];
+    @try {
+        block();
+    } @finally {
+        // Otherwise an exception would leave the selection changing forever, and observers would never hear about it again.
+        [self endSelectionChanges];
+    }
+}
+
+- (BOOL)isChangingSelection {
+    return _selectionChangeDepth > 0;
+}
+
+- (void)_noteSelectionWillChange {
+    // Observers hear about the change once, no matter how many graphics it covers.
+    if (!_selectionDidChange) {
+        _selectionDidChange = YES;
+        [self willChangeValueForKey:@"selection"];
+    }
+}
+
+- (void)_noteSelectionChangeForGraphic:(DrawGraphic *)graphic {
+    DrawPage *page = graphic.page;
+    if (page != nil) {
+        if (_selectionDirtyRects == nil) {
+            _selectionDirtyRects = [NSMapTable strongToStrongObjectsMapTable];
+        }
+        NSValue *dirtyRect = [_selectionDirtyRects objectForKey:page];
+        NSRect rect = graphic.dirtyBounds;
+        if (dirtyRect != nil) {
+            rect = NSUnionRect(rect, dirtyRect.rectValue);
+        }
+        [_selectionDirtyRects setObject:[NSValue valueWithRect:rect] forKey:page];
+    }
+}
+
+- (void)_commitSelectionChanges {
+    NSMapTable<DrawPage *, NSValue *> *dirtyRects = _selectionDirtyRects;
+
+    _selectionDirtyRects = nil;
+    for (DrawPage *page in dirtyRects) {
+        [page setOverlayNeedsDisplayInRect:[[dirtyRects objectForKey:page] rectValue]];
+        // Hover snapshots include the selected graphics' handles.
+        [page.hoverTester invalidate];
     }
+    [self _setInspectorsNeedUpdate];
+
+    _selectionDidChange = NO;
     [self didChangeValueForKey:@"selection"];
 }
 
+#pragma mark - Inspector Updates
+
+- (NSTimeInterval)_inspectorUpdateInterval {
+    NSInteger framesPerSecond = self.windowForSheet.screen.maximumFramesPerSecond;
+    return 1.0 / (framesPerSecond > 0 ? framesPerSecond : 60.0);
+}
+
+- (void)_setInspectorsNeedUpdate {
+    if (!_inspectorUpdatePending) {
+        // Rebuilding the inspectors costs far more than changing the selection, so they catch up at most once a frame. Use the common modes, so they still do while a tool is tracking the mouse.
+        NSTimeInterval sinceLastUpdate = [NSDate timeIntervalSinceReferenceDate] - _lastInspectorUpdateTime;
+        NSTimeInterval delay = MAX(0.0, [self _inspectorUpdateInterval] - sinceLastUpdate);
+        _inspectorUpdatePending = YES;
+        [self performSelector:@selector(updateInspectorsForSelection) withObject:nil afterDelay:delay inModes:@[NSRunLoopCommonModes]];
+    }
+}
+
+- (void)updateInspectorsForSelection {
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(updateInspectorsForSelection) object:nil];
+    _inspectorUpdatePending = NO;
+    _lastInspectorUpdateTime = [NSDate timeIntervalSinceReferenceDate];
+
+    NSArray<DrawGraphic *> *inspected = _storage.selection.count > 0 ? _storage.selection.allObjects : @[_storage.templateGraphic];
+    if (_inspectedSelection == nil || ![[NSSet setWithArray:_inspectedSelection] isEqualToSet:[NSSet setWithArray:inspected]]) {
+        if (_inspectedSelection != nil) {
+            [self.inspectorGroupsViewController pop:_inspectedSelection for:AJRInspectorContentIdentifierAny];
+        }
+        [self.inspectorGroupsViewController push:inspected for:AJRInspectorContentIdentifierAny];
+        _inspectedSelection = inspected;
+    }
+}
+
 - (NSSet *)selection {
     return _storage.selection;
 }
@@ -122,6 +215,17 @@ static NSComparisonResult _compareGraphics(DrawGraphic *first, DrawGraphic *seco
     return [_storage.selection count] ? _storage.selection : [_currentToolSet selectionForInspectionForDocument:self];
 }
 
+- (DrawSelectionSummary *)selectionSummary {
+    if (_selectionSummary == nil) {
+        _selectionSummary = [[DrawSelectionSummary alloc] initWithGraphics:_storage.selection];
+    }
+    return _selectionSummary;
+}
+
+- (void)selectionSummaryGraphicDidChange:(DrawGraphic *)graphic {
+    [_selectionSummary graphicDidChange:graphic];
+}
+
 - (NSArray *)sortedSelection {
     return [[_storage.selection allObjects] sortedArrayUsingFunction:(NSInteger (*)(id, id, void *))_compareGraphics context:(__bridge void *)(self)];
 }
@@ -313,6 +417,7 @@ static NSComparisonResult _compareGraphics(DrawGraphic *first, DrawGraphic *seco
     NSArray *graphics;
     DrawLayer *aLayer;
     
+    [self beginSelectionChanges];
     [self clearSelection];
     
     if (_storage.group) {
@@ -328,27 +433,16 @@ static NSComparisonResult _compareGraphics(DrawGraphic *first, DrawGraphic *seco
             }
         }
     }
+    [self endSelectionChanges];
 }
 
 - (BOOL)selectionContainsGroups {
-    for (DrawGraphic *graphic in _storage.selection) {
-        if ([[graphic subgraphics] count]) return YES;
-    }
-    
-    return NO;
+    // These get asked on every menu validation, so don't walk the selection.
+    return [[self selectionSummary] groupCount] > 0;
 }
 
 - (DrawGraphic *)groupFromSelection {
-    DrawGraphic *group = nil;
-    
-    for (DrawGraphic *graphic in _storage.selection) {
-        if ([[graphic subgraphics] count]) {
-            if (group) return nil;
-            group = graphic;
-        }
-    }
-    
-    return group;
+    return [[self selectionSummary] group];
 }
 
 @end
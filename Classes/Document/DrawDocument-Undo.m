@@ -31,8 +31,10 @@
 
 #import "DrawDocument.h"
 
+#import "DrawAspect.h"
 #import "DrawGraphic.h"
 #import "DrawDocumentStorage.h"
+#import <Draw/Draw-Swift.h>
 
 @implementation DrawDocument (Undo)
 
@@ -125,6 +127,12 @@
         for (id <DrawDocumentGraphicObserver> observer in _graphicObservers) {
             [observer graphic:object didEditKeys:keys];
         }
+    } else {
+        graphic = [AJRObjectIfKindOfClass(object, DrawAspect) graphic];
+    }
+    // Editing an aspect, like a stroke's width, changes what the selection summary sees on its graphic.
+    if (graphic != nil) {
+        [_selectionSummary graphicDidChange:graphic];
     }
 }
 
@@ -38,7 +38,7 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class AJRBezierPath, AJRRibbonView, AJRSplitView, DrawBook, DrawDocumentStorage, DrawPage, DrawGraphic, DrawInspectorGroupController, DrawGraphicsInspectorController, DrawLayer, DrawRulerMarker, DrawTool, DrawRulerAccessory, DrawLayerViewController, DrawInspectorGroupsController, DrawMeasurementUnit;
+@class AJRBezierPath, AJRRibbonView, AJRSplitView, DrawBook, DrawDocumentStorage, DrawPage, DrawGraphic, DrawInspectorGroupController, DrawGraphicsInspectorController, DrawLayer, DrawRulerMarker, DrawTool, DrawRulerAccessory, DrawLayerViewController, DrawInspectorGroupsController, DrawMeasurementUnit, DrawSelectionSummary;
 
 // Errors
 
@@ -90,6 +90,7 @@ extern NSString * const DrawRightViewExpandedKey;
 extern NSString * const DrawLeftViewExpandedWidthKey;
 extern NSString * const DrawRightViewExpandedWidthKey;
 extern NSString * const DrawMarginColorKey;
+extern NSString * const DrawInteractiveSettleDelayKey;
 
 // Standard Document Info Keys
 
@@ -124,9 +125,6 @@ extern NSString * const DrawSavePanelPathKey;
     // Belonging
     DrawBook * __weak _book;
 
-    // Grid
-    AJRBezierPath *_grid;
-
     // Ruler Support
     DrawRulerAccessory *_rulerAccessory;
 
@@ -140,6 +138,20 @@ extern NSString * const DrawSavePanelPathKey;
     AJREditingContext *_editingContext; // Used to track changes on our objects. Only partially implemented.
     NSMutableArray<id <DrawDocumentGraphicObserver>> *_graphicObservers;
 
+    // Interactive Drawing
+    NSInteger _interactiveDrawingDepth;
+    NSHashTable<DrawGraphic *> *_interactiveGraphics;
+    BOOL _drawsAllGraphicsInteractively;
+
+    // Selection Changes
+    NSInteger _selectionChangeDepth;
+    BOOL _selectionDidChange;
+    NSMapTable<DrawPage *, NSValue *> *_selectionDirtyRects;
+    NSArray<DrawGraphic *> *_inspectedSelection; // What we last pushed to the inspectors.
+    BOOL _inspectorUpdatePending;
+    NSTimeInterval _lastInspectorUpdateTime;
+    DrawSelectionSummary *_selectionSummary;
+
     // Flags
     BOOL _isPrinting;
     BOOL _useShallowEncode;
@@ -320,6 +332,27 @@ extern NSString * const DrawSavePanelPathKey;
 @end
 
 
+@interface DrawDocument (Interactive)
+
+/*! How long after the last interaction ends before graphics are redrawn at full quality. Defaults to DrawInteractiveSettleDelayKey, 0.2 seconds unless set. */
+@property (nonatomic,class,readonly) NSTimeInterval interactiveSettleDelay;
+
+/*!
+ Starts drawing graphics at interactive quality, which is DrawGraphicLevelOfDetailReduced at the least, for the length of an interaction such as a drag or resize. Aspects that don't draw at reduced detail, like shadows and text, are skipped, and gradient and image fills are drawn with a solid color.
+
+ @param graphics The graphics being manipulated, which includes their subgraphics. Pass `nil` to draw every graphic at interactive quality, such as while zooming.
+
+ Calls nest, and each must be balanced by -endInteractiveDrawing. Once the last one ends and nothing new begins for interactiveSettleDelay, the affected graphics are redrawn at full quality.
+ */
+- (void)beginInteractiveDrawingOfGraphics:(nullable id <NSFastEnumeration>)graphics;
+- (void)endInteractiveDrawing;
+
+@property (nonatomic,readonly) BOOL isDrawingInteractively;
+- (BOOL)isDrawingGraphicInteractively:(DrawGraphic *)graphic;
+
+@end
+
+
 @interface DrawDocument (IO) <AJRXMLCoding>
 
 - (BOOL)readFromFileWrapper:(NSFileWrapper *)fileWrapper ofType:(NSString *)typeName error:(NSError *__autoreleasing _Nullable *)outError;
@@ -391,6 +424,11 @@ extern NSString * const DrawSavePanelPathKey;
 - (IBAction)copy:(id)sender;
 - (IBAction)paste:(id)sender;
 
+/// Writes the selection to `pasteboard`. Returns NO, leaving the pasteboard alone, when nothing is selected.
+- (BOOL)copyToPasteboard:(NSPasteboard *)pasteboard;
+/// Adds any graphics on `pasteboard` to the current page and selects them.
+- (void)pasteFromPasteboard:(NSPasteboard *)pasteboard;
+
 @end
 
 
@@ -426,10 +464,29 @@ extern NSString * const DrawSavePanelPathKey;
 - (void)addGraphicsToSelection:(id <NSFastEnumeration,NSCopying>)graphic;
 - (void)removeGraphicsFromSelection:(id <NSFastEnumeration,NSCopying>)graphic;
 
+/*!
+ Starts a group of selection changes. Until the matching -endSelectionChanges, adding and removing graphics only changes the selection itself. When the last group ends, observers of `selection` get a single change notification, and each affected page gets a single invalidation of its overlay, covering everything that changed. Every add and remove is its own group when there's no group open.
+
+ Calls nest, and each must be balanced by -endSelectionChanges.
+ */
+- (void)beginSelectionChanges;
+- (void)endSelectionChanges;
+/*! Calls `block` between -beginSelectionChanges and -endSelectionChanges. The group is ended even if `block` raises. */
+- (void)changeSelection:(void (^)(void))block;
+@property (nonatomic,readonly,getter=isChangingSelection) BOOL changingSelection;
+
+/*! Pushes the selection to the inspectors now, rather than waiting for the next display frame. Inspectors are normally only updated once per frame, however often the selection changes. */
+- (void)updateInspectorsForSelection;
+
 @property (nonatomic,readonly) NSSet<DrawGraphic *> *selection;
 @property (nonatomic,readonly) NSSet<DrawGraphic *> *selectionForInspection;
 @property (nonatomic,readonly) NSArray<DrawGraphic *> *sortedSelection;
+/*! Aggregated values across the selection, such as whether the selected graphics share a stroke width, kept current as the selection and the selected graphics change, so reading them doesn't mean visiting every selected graphic. Created on first use. */
+@property (nonatomic,readonly) DrawSelectionSummary *selectionSummary;
+/*! Tells the selection summary that `graphic` changed in a way it can't observe, such as becoming or ceasing to be a group. Does nothing if the summary hasn't been created yet. */
+- (void)selectionSummaryGraphicDidChange:(DrawGraphic *)graphic;
 - (void)clearSelection;
+- (IBAction)selectAll:(id)sender;
 
 - (IBAction)deleteSelection:(id)sender;
 - (void)deleteSelection;
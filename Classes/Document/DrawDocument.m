@@ -79,6 +79,7 @@ NSString * const DrawRightViewExpandedKey = @"RightViewExpanded";
 NSString * const DrawLeftViewExpandedWidthKey = @"LeftViewExpandedWidth";
 NSString * const DrawRightViewExpandedWidthKey = @"RightViewExpandedWidth";
 NSString * const DrawMarginColorKey = @"MarginColor";
+NSString * const DrawInteractiveSettleDelayKey = @"InteractiveSettleDelay";
 
 // Standard Document Info Keys
 NSString * const DrawDocumentInfoAuthorKey = @"author";
@@ -133,6 +134,7 @@ const AJRInspectorIdentifier AJRInspectorIdentifierDrawDocument = @"document";
       @"NO", DrawRightViewExpandedKey,
       @"200.0", DrawLeftViewExpandedWidthKey,
       @"200.0", DrawRightViewExpandedWidthKey,
+      @"0.2", DrawInteractiveSettleDelayKey,
       nil
       ]
      ];
@@ -393,6 +395,8 @@ const AJRInspectorIdentifier AJRInspectorIdentifierDrawDocument = @"document";
 
     // Does this need to do some sort notifications? I'm assuming no to start with, because this should only be called during document unarchiving.
     _storage = storage;
+    // The summary described the old selection, so start over when someone next asks.
+    _selectionSummary = nil;
 
     // Make sure, in case we added a new default aspect, that it gets initialized. This is just future proofing
     [self _initializeTemplateGraphic:_storage.templateGraphic];
@@ -938,6 +942,7 @@ const AJRInspectorIdentifier AJRInspectorIdentifierDrawDocument = @"document";
     [self.inspectorGroupsViewController push:@[self] for:AJRInspectorContentIdentifierAny];
     [self.inspectorGroupsViewController push:@[self.page] for:AJRInspectorContentIdentifierAny];
     [self.inspectorGroupsViewController push:@[_storage.templateGraphic] for:AJRInspectorContentIdentifierAny];
+    _inspectedSelection = @[_storage.templateGraphic];
 
     [self _notifyControllersOfDocumentLoad:_primaryWindowController.contentViewController];
 
@@ -1103,8 +1108,10 @@ const AJRInspectorIdentifier AJRInspectorIdentifierDrawDocument = @"document";
     [oldGraphic graphicDidRemoveFromDocument:self];
 
     if ([_storage.selection containsObject:oldGraphic]) {
+        [self beginSelectionChanges];
         [self removeGraphicFromSelection:oldGraphic];
         [self addGraphicToSelection:newGraphic];
+        [self endSelectionChanges];
     }
 }
 
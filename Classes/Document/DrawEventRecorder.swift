@@ -0,0 +1,178 @@
+/*
+ DrawEventRecorder.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ One event captured by `DrawEventRecorder`. It holds just enough to rebuild an equivalent `NSEvent` against another copy of the document.
+
+ Locations are stored in page coordinates rather than window coordinates, so a recording can be replayed at a different zoom, in a different window, or without a window at all.
+ */
+public struct DrawRecordedEvent : Codable, Equatable {
+
+    /// Seconds since the recording started.
+    public var time : TimeInterval
+    /// The raw value of the event's `NSEvent.EventType`.
+    public var type : UInt
+    public var toolSetIdentifier : String?
+    public var toolIdentifier : String?
+    /// The index of the page in the document's `pages`.
+    public var pageIndex : Int
+    public var location : CGPoint
+    public var modifierFlags : UInt
+    public var clickCount : Int
+    public var characters : String?
+
+    public init(time: TimeInterval, type: NSEvent.EventType, toolSetIdentifier: String? = nil, toolIdentifier: String? = nil, pageIndex: Int = 0, location: CGPoint, modifierFlags: NSEvent.ModifierFlags = [], clickCount: Int = 1, characters: String? = nil) {
+        self.time = time
+        self.type = type.rawValue
+        self.toolSetIdentifier = toolSetIdentifier
+        self.toolIdentifier = toolIdentifier
+        self.pageIndex = pageIndex
+        self.location = location
+        self.modifierFlags = modifierFlags.rawValue
+        self.clickCount = clickCount
+        self.characters = characters
+    }
+
+    public var eventType : NSEvent.EventType? {
+        return NSEvent.EventType(rawValue: type)
+    }
+
+    public var isMouseEvent : Bool {
+        if let eventType {
+            return DrawRecordedEvent.isMouseEventType(eventType)
+        }
+        return false
+    }
+
+    public static func isMouseEventType(_ type: NSEvent.EventType) -> Bool {
+        switch type {
+        case .leftMouseDown, .leftMouseDragged, .leftMouseUp, .mouseMoved, .rightMouseDown, .rightMouseDragged, .rightMouseUp:
+            return true
+        default:
+            return false
+        }
+    }
+
+}
+
+/**
+ Captures the events a user sends to a document's pages, so the session can be replayed later with `DrawEventReplayer`.
+
+ `DrawPage` reports every event it dispatches to a tool. Tools that track the mouse in their own loop, like the creation tools and `-[DrawGraphic trackMouse:fromHandle:]`, pull events straight from the queue, so those loops report their events too. Both calls do nothing unless a recorder is active.
+ */
+@objcMembers
+open class DrawEventRecorder : NSObject {
+
+    /// The recorder receiving events, if any.
+    public private(set) static var active : DrawEventRecorder? = nil
+
+    open private(set) var document : DrawDocument
+    open private(set) var events = [DrawRecordedEvent]()
+    open private(set) var isRecording = false
+    private var startTime : TimeInterval = 0.0
+
+    public init(document: DrawDocument) {
+        self.document = document
+    }
+
+    // MARK: - Recording
+
+    open func start() {
+        DrawEventRecorder.active?.stop()
+        events.removeAll()
+        startTime = ProcessInfo.processInfo.systemUptime
+        isRecording = true
+        DrawEventRecorder.active = self
+    }
+
+    open func stop() {
+        isRecording = false
+        if DrawEventRecorder.active === self {
+            DrawEventRecorder.active = nil
+        }
+    }
+
+    @objc(recordDrawEvent:)
+    open class func record(_ event: DrawEvent) {
+        if let active {
+            active.record(event.event, on: event.page)
+        }
+    }
+
+    @objc(recordEvent:onPage:)
+    open class func record(_ event: NSEvent, on page: DrawPage) {
+        if let active {
+            active.record(event, on: page)
+        }
+    }
+
+    open func record(_ event: NSEvent, on page: DrawPage) {
+        guard isRecording, page.document === document else { return }
+        let pageIndex = document.pages.firstIndex(of: page) ?? 0
+        let tool = document.currentTool
+        var characters : String? = nil
+        if event.type == .keyDown || event.type == .keyUp {
+            characters = event.characters
+        }
+        let isMouse = DrawRecordedEvent.isMouseEventType(event.type)
+        // Timestamps may be zero on synthetic events, so fall back to now.
+        let timestamp = event.timestamp > 0.0 ? event.timestamp : ProcessInfo.processInfo.systemUptime
+
+        events.append(DrawRecordedEvent(time: max(0.0, timestamp - startTime),
+                                        type: event.type,
+                                        toolSetIdentifier: tool.primaryToolSet.identifier.rawValue,
+                                        toolIdentifier: tool.identifier.rawValue,
+                                        pageIndex: pageIndex,
+                                        location: isMouse ? page.convert(event.locationInWindow, from: nil) : .zero,
+                                        modifierFlags: event.modifierFlags.intersection(.deviceIndependentFlagsMask),
+                                        clickCount: isMouse ? event.clickCount : 0,
+                                        characters: characters))
+    }
+
+    // MARK: - Persistence
+
+    open func data() throws -> Data {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        return try encoder.encode(events)
+    }
+
+    open func write(to url: URL) throws {
+        try data().write(to: url, options: [.atomic])
+    }
+
+    open class func events(contentsOf url: URL) throws -> [DrawRecordedEvent] {
+        return try JSONDecoder().decode([DrawRecordedEvent].self, from: Data(contentsOf: url))
+    }
+
+}
@@ -0,0 +1,252 @@
+/*
+ DrawEventReplayer.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ How long one replayed event took to process.
+ */
+@objcMembers
+open class DrawReplayedEventTiming : NSObject {
+
+    /// The index of the event in the recording.
+    open private(set) var index : Int
+    open private(set) var type : NSEvent.EventType
+    open private(set) var toolName : String
+    /// When the event was scheduled, in seconds from the start of the replay.
+    open private(set) var scheduledTime : TimeInterval
+    /// The time spent handling the event, in seconds. This is `0` when `consumedByTracking` is true.
+    open private(set) var processingTime : TimeInterval
+    /// True when the event was pulled from the queue by a tool's own tracking loop, in which case its cost is part of the mouse down that started the loop.
+    open private(set) var consumedByTracking : Bool
+
+    internal init(index: Int, type: NSEvent.EventType, toolName: String, scheduledTime: TimeInterval, processingTime: TimeInterval, consumedByTracking: Bool) {
+        self.index = index
+        self.type = type
+        self.toolName = toolName
+        self.scheduledTime = scheduledTime
+        self.processingTime = processingTime
+        self.consumedByTracking = consumedByTracking
+    }
+
+    open override var description: String {
+        if consumedByTracking {
+            return String(format: "%5ld %@ %@: tracked", index, toolName, String(describing: type))
+        }
+        return String(format: "%5ld %@ %@: %.3fms", index, toolName, String(describing: type), processingTime * 1000.0)
+    }
+
+}
+
+/**
+ Replays events captured by `DrawEventRecorder` against a document, calling the current tool's `mouseDown:`, `mouseDragged:`, `mouseUp:`, and friends the same way `DrawPage` does. The document doesn't need to be in a window.
+
+ Many tools don't return from `mouseDown:` until the mouse goes up, because they pull the rest of the gesture straight from the event queue. So before a mouse down is dispatched, the drags and mouse up that follow it are posted to `NSApp`'s queue. Whatever the tool doesn't consume is drained back out and dispatched directly. Events consumed that way are reported with `consumedByTracking` set, and their cost is included in the mouse down.
+
+ By default events are dispatched as fast as possible. When `realTime` is true, each event is held until its recorded offset. Events inside a tracking loop are posted by timers at their recorded offsets, so the tool still sees them arrive at the original pace.
+ */
+@objcMembers
+open class DrawEventReplayer : NSObject {
+
+    open private(set) var document : DrawDocument
+    open private(set) var events : [DrawRecordedEvent]
+    open var realTime = false
+
+    private var startTime : TimeInterval = 0.0
+    private var eventNumber = 0
+
+    public init(document: DrawDocument, events: [DrawRecordedEvent]) {
+        self.document = document
+        self.events = events
+    }
+
+    public convenience init(document: DrawDocument, contentsOf url: URL) throws {
+        self.init(document: document, events: try DrawEventRecorder.events(contentsOf: url))
+    }
+
+    // MARK: - Replay
+
+    /// Replays every event and returns the time each one took.
+    open func replay() -> [DrawReplayedEventTiming] {
+        var timings = [DrawReplayedEventTiming]()
+        var index = 0
+
+        _ = NSApplication.shared
+        startTime = ProcessInfo.processInfo.systemUptime
+        while index < events.count {
+            let recorded = events[index]
+            guard let type = recorded.eventType, let page = page(for: recorded) else {
+                index += 1
+                continue
+            }
+            selectTool(for: recorded)
+
+            if type == .leftMouseDown {
+                var end = index + 1
+                while end < events.count && events[end].eventType != .leftMouseUp {
+                    end += 1
+                }
+                end = min(end, events.count - 1)
+                let gesture = (index + 1 ..< end + 1).filter { events[$0].eventType == .leftMouseDragged || events[$0].eventType == .leftMouseUp }
+
+                var posted = 0
+                var timers = [Timer]()
+                if realTime {
+                    for gestureIndex in gesture {
+                        let timer = Timer(fire: Date(timeIntervalSinceNow: delay(until: events[gestureIndex])), interval: 0.0, repeats: false) { [weak self] _ in
+                            if let self, let event = self.makeEvent(for: self.events[gestureIndex], on: page) {
+                                NSApp.postEvent(event, atStart: false)
+                                posted += 1
+                            }
+                        }
+                        RunLoop.current.add(timer, forMode: .common)
+                        timers.append(timer)
+                    }
+                    wait(until: recorded)
+                } else {
+                    for gestureIndex in gesture {
+                        if let event = makeEvent(for: events[gestureIndex], on: page) {
+                            NSApp.postEvent(event, atStart: false)
+                            posted += 1
+                        }
+                    }
+                }
+
+                timings.append(DrawReplayedEventTiming(index: index, type: type, toolName: document.currentTool.name, scheduledTime: recorded.time, processingTime: dispatch(recorded, on: page), consumedByTracking: false))
+
+                timers.forEach { $0.invalidate() }
+                var leftOver = 0
+                while NSApp.nextEvent(matching: [.leftMouseDragged, .leftMouseUp], until: .distantPast, inMode: .default, dequeue: true) != nil {
+                    leftOver += 1
+                }
+                let consumed = max(0, posted - leftOver)
+                for (offset, gestureIndex) in gesture.enumerated() {
+                    let gestureEvent = events[gestureIndex]
+                    if offset < consumed {
+                        timings.append(DrawReplayedEventTiming(index: gestureIndex, type: gestureEvent.eventType!, toolName: document.currentTool.name, scheduledTime: gestureEvent.time, processingTime: 0.0, consumedByTracking: true))
+                    } else {
+                        if realTime {
+                            wait(until: gestureEvent)
+                        }
+                        timings.append(DrawReplayedEventTiming(index: gestureIndex, type: gestureEvent.eventType!, toolName: document.currentTool.name, scheduledTime: gestureEvent.time, processingTime: dispatch(gestureEvent, on: page), consumedByTracking: false))
+                    }
+                }
+                index = end + 1
+            } else {
+                if realTime {
+                    wait(until: recorded)
+                }
+                timings.append(DrawReplayedEventTiming(index: index, type: type, toolName: document.currentTool.name, scheduledTime: recorded.time, processingTime: dispatch(recorded, on: page), consumedByTracking: false))
+                index += 1
+            }
+        }
+
+        return timings
+    }
+
+    /// Dispatches one event to the current tool, falling back to the selection like `DrawPage` does. Returns the time taken, in seconds.
+    internal func dispatch(_ recorded: DrawRecordedEvent, on page: DrawPage) -> TimeInterval {
+        guard let type = recorded.eventType, let event = makeEvent(for: recorded, on: page) else { return 0.0 }
+        let drawEvent = DrawEvent(originalEvent: event, document: document, page: page)
+        let tool = document.currentTool
+        let start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+        var selector : Selector? = nil
+
+        document.page = page
+        switch type {
+        case .leftMouseDown:     if !tool.mouseDown(drawEvent) { selector = NSSelectorFromString("mouseDown:") }
+        case .leftMouseDragged:  if !tool.mouseDragged(drawEvent) { selector = NSSelectorFromString("mouseDragged:") }
+        case .leftMouseUp:       if !tool.mouseUp(drawEvent) { selector = NSSelectorFromString("mouseUp:") }
+        case .mouseMoved:        if !tool.mouseMoved(drawEvent) { selector = NSSelectorFromString("mouseMoved:") }
+        case .rightMouseDown:    if !tool.rightMouseDown(drawEvent) { selector = NSSelectorFromString("rightMouseDown:") }
+        case .rightMouseDragged: if !tool.rightMouseDragged(drawEvent) { selector = NSSelectorFromString("rightMouseDragged:") }
+        case .rightMouseUp:      if !tool.rightMouseUp(drawEvent) { selector = NSSelectorFromString("rightMouseUp:") }
+        case .keyDown:           if !tool.keyDown(drawEvent) { selector = NSSelectorFromString("keyDown:") }
+        case .keyUp:             if !tool.keyUp(drawEvent) { selector = NSSelectorFromString("keyUp:") }
+        case .flagsChanged:      if !tool.flagsChanged(drawEvent) { selector = NSSelectorFromString("flagsChanged:") }
+        default:
+            break
+        }
+        if let selector {
+            _ = page.makeSelectionPerform(selector, with: drawEvent, shortCircuit: true)
+        }
+
+        return TimeInterval(clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - start) / 1.0e9
+    }
+
+    // MARK: - Utilities
+
+    internal func page(for recorded: DrawRecordedEvent) -> DrawPage? {
+        let pages = document.pages
+        return recorded.pageIndex >= 0 && recorded.pageIndex < pages.count ? pages[recorded.pageIndex] : nil
+    }
+
+    internal func selectTool(for recorded: DrawRecordedEvent) {
+        guard let toolSetIdentifier = recorded.toolSetIdentifier, let toolIdentifier = recorded.toolIdentifier else { return }
+        let current = document.currentTool
+        if current.identifier.rawValue == toolIdentifier && current.primaryToolSet.identifier.rawValue == toolSetIdentifier {
+            return
+        }
+        if let toolSet = DrawToolSet.toolSets.first(where: { $0.identifier.rawValue == toolSetIdentifier }),
+           let tool = toolSet.tools.first(where: { $0.identifier.rawValue == toolIdentifier }) {
+            document.currentTool = tool
+        }
+    }
+
+    internal func makeEvent(for recorded: DrawRecordedEvent, on page: DrawPage) -> NSEvent? {
+        guard let type = recorded.eventType else { return nil }
+        let modifierFlags = NSEvent.ModifierFlags(rawValue: recorded.modifierFlags)
+        let timestamp = ProcessInfo.processInfo.systemUptime
+        let windowNumber = page.window?.windowNumber ?? 0
+
+        eventNumber += 1
+        if recorded.isMouseEvent {
+            return NSEvent.mouseEvent(with: type, location: page.convert(recorded.location, to: nil), modifierFlags: modifierFlags, timestamp: timestamp, windowNumber: windowNumber, context: nil, eventNumber: eventNumber, clickCount: recorded.clickCount, pressure: 1.0)
+        }
+        if type == .flagsChanged {
+            return NSEvent.keyEvent(with: type, location: .zero, modifierFlags: modifierFlags, timestamp: timestamp, windowNumber: windowNumber, context: nil, characters: "", charactersIgnoringModifiers: "", isARepeat: false, keyCode: 0)
+        }
+        let characters = recorded.characters ?? ""
+        return NSEvent.keyEvent(with: type, location: .zero, modifierFlags: modifierFlags, timestamp: timestamp, windowNumber: windowNumber, context: nil, characters: characters, charactersIgnoringModifiers: characters, isARepeat: false, keyCode: 0)
+    }
+
+    internal func delay(until recorded: DrawRecordedEvent) -> TimeInterval {
+        return max(0.0, startTime + recorded.time - ProcessInfo.processInfo.systemUptime)
+    }
+
+    internal func wait(until recorded: DrawRecordedEvent) {
+        let delay = delay(until: recorded)
+        if delay > 0.0 {
+            RunLoop.current.run(until: Date(timeIntervalSinceNow: delay))
+        }
+    }
+
+}
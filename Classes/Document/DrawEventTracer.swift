@@ -0,0 +1,404 @@
+/*
+ DrawEventTracer.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Records the life of a single event as it moves through the page: when AppKit created it, how long the tool spent handling it, when the tool first changed a graphic, when the change was turned into an invalidation, and when the page next finished drawing.
+
+ All times are in nanoseconds on the `CLOCK_UPTIME_RAW` clock, which is the same clock `NSEvent.timestamp` uses, so the creation span includes the time the event spent in the queue before we saw it.
+ */
+@objcMembers
+open class DrawEventTrace : NSObject {
+
+    open private(set) var identifier : Int
+    open private(set) var name : String
+    open private(set) var toolName : String
+    open private(set) var eventTime : UInt64
+    open private(set) var createdTime : UInt64
+    open private(set) var dispatchEndTime : UInt64 = 0
+    open private(set) var mutationTime : UInt64 = 0
+    open private(set) var invalidationTime : UInt64 = 0
+    open private(set) var drawStartTime : UInt64 = 0
+    open private(set) var drawEndTime : UInt64 = 0
+
+    internal init(identifier: Int, name: String, toolName: String, eventTime: UInt64, createdTime: UInt64) {
+        self.identifier = identifier
+        self.name = name
+        self.toolName = toolName
+        self.eventTime = eventTime
+        self.createdTime = createdTime
+    }
+
+    /// Called by the page once the tool (or selection) has returned from the event.
+    @objc(endDispatch)
+    open func endDispatch() {
+        DrawEventTracer.shared.endDispatch(self)
+    }
+
+    internal func noteMutation(at time: UInt64) {
+        if mutationTime == 0 {
+            mutationTime = time
+        }
+    }
+
+    internal func noteInvalidation(at time: UInt64) {
+        if invalidationTime == 0 {
+            invalidationTime = time
+        }
+    }
+
+    internal func noteDraw(from start: UInt64, to end: UInt64) {
+        drawStartTime = start
+        drawEndTime = end
+    }
+
+    internal func endDispatch(at time: UInt64) {
+        dispatchEndTime = time
+    }
+
+    /// The time spent in the tool, in nanoseconds.
+    open var dispatchDuration : UInt64 {
+        return dispatchEndTime > createdTime ? dispatchEndTime - createdTime : 0
+    }
+
+    /// The time from the hardware event to the end of the draw that displayed its effects, or `0` if the event never caused a draw.
+    open var latency : UInt64 {
+        return drawEndTime > eventTime ? drawEndTime - eventTime : 0
+    }
+
+}
+
+/**
+ A percentile summary of the events handled by one tool.
+ */
+@objcMembers
+open class DrawEventLatencySummary : NSObject {
+
+    open private(set) var toolName : String
+    open private(set) var count : Int
+    open private(set) var dispatchP50 : TimeInterval
+    open private(set) var dispatchP99 : TimeInterval
+    open private(set) var latencyP50 : TimeInterval
+    open private(set) var latencyP99 : TimeInterval
+
+    internal init(toolName: String, traces: [DrawEventTrace]) {
+        self.toolName = toolName
+        self.count = traces.count
+        let dispatches = traces.map { $0.dispatchDuration }.sorted()
+        let latencies = traces.compactMap { $0.latency == 0 ? nil : $0.latency }.sorted()
+        dispatchP50 = DrawEventLatencySummary.percentile(0.50, of: dispatches)
+        dispatchP99 = DrawEventLatencySummary.percentile(0.99, of: dispatches)
+        latencyP50 = DrawEventLatencySummary.percentile(0.50, of: latencies)
+        latencyP99 = DrawEventLatencySummary.percentile(0.99, of: latencies)
+    }
+
+    internal class func percentile(_ fraction: Double, of sorted: [UInt64]) -> TimeInterval {
+        if sorted.isEmpty {
+            return 0.0
+        }
+        let index = min(sorted.count - 1, Int((Double(sorted.count - 1) * fraction).rounded()))
+        return TimeInterval(sorted[index]) / 1.0e9
+    }
+
+    open var dictionaryRepresentation : [String:Any] {
+        return ["tool": toolName,
+                "count": count,
+                "dispatchP50": dispatchP50 * 1000.0,
+                "dispatchP99": dispatchP99 * 1000.0,
+                "latencyP50": latencyP50 * 1000.0,
+                "latencyP99": latencyP99 * 1000.0]
+    }
+
+    open override var description: String {
+        return String(format: "%@: %ld events, dispatch p50 %.2fms p99 %.2fms, latency p50 %.2fms p99 %.2fms", toolName, count, dispatchP50 * 1000.0, dispatchP99 * 1000.0, latencyP50 * 1000.0, latencyP99 * 1000.0)
+    }
+
+}
+
+/**
+ A fixed size buffer that overwrites its oldest element once it's full, so appending stays constant time no matter how long tracing runs.
+ */
+internal struct DrawEventRingBuffer<Element> {
+
+    private var storage = [Element]()
+    private var head = 0  // The index of the oldest element, once the buffer has wrapped.
+
+    var capacity : Int {
+        didSet {
+            if capacity != oldValue {
+                storage = Array(elements.suffix(Swift.max(capacity, 0)))
+                head = 0
+            }
+        }
+    }
+
+    init(capacity: Int) {
+        self.capacity = capacity
+    }
+
+    var count : Int {
+        return storage.count
+    }
+
+    var first : Element? {
+        return storage.isEmpty ? nil : storage[head]
+    }
+
+    /// The elements, oldest first.
+    var elements : [Element] {
+        return head == 0 ? storage : Array(storage[head...] + storage[..<head])
+    }
+
+    mutating func append(_ element: Element) {
+        if capacity <= 0 {
+            return
+        }
+        if storage.count < capacity {
+            storage.append(element)
+        } else {
+            storage[head] = element
+            head = (head + 1) % capacity
+        }
+    }
+
+    mutating func removeAll() {
+        storage.removeAll()
+        head = 0
+    }
+
+}
+
+/**
+ Collects `DrawEventTrace`s for the events handled by `DrawPage` and writes them out in the Chrome trace event format, which can be loaded by `chrome://tracing`, Perfetto, or Speedscope.
+
+ Tracing is off by default and costs one class property read per event when off. Turn it on with `DrawEventTracer.isEnabled`, or by setting the `DrawTraceEvents` user default.
+ */
+@objcMembers
+open class DrawEventTracer : NSObject {
+
+    public static let shared = DrawEventTracer()
+
+    public static let traceEventsKey = "DrawTraceEvents"
+
+    public static var isEnabled : Bool = {
+        UserDefaults.standard.register(defaults: [DrawEventTracer.traceEventsKey: false])
+        return UserDefaults.standard.bool(forKey: DrawEventTracer.traceEventsKey)
+    }()
+
+    /// The maximum number of completed traces kept. Older traces are discarded first.
+    open var capacity = 100_000 {
+        didSet {
+            completed.capacity = capacity
+            draws.capacity = capacity
+        }
+    }
+
+    /// Events that never invalidate anything are retired after this many newer events, so they don't wait forever on a draw that isn't coming.
+    open var maximumPendingTraces = 256
+
+    /// The completed traces, oldest first.
+    open var traces : [DrawEventTrace] {
+        return completed.elements
+    }
+    private var completed = DrawEventRingBuffer<DrawEventTrace>(capacity: 100_000)
+    private var pending = [DrawEventTrace]()
+    private var current : DrawEventTrace? = nil
+    private var nextIdentifier = 1
+    private var drawStartTime : UInt64 = 0
+    private var draws = DrawEventRingBuffer<(start: UInt64, end: UInt64)>(capacity: 100_000)
+
+    internal class var now : UInt64 {
+        return clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+    }
+
+    // MARK: - Page Hooks
+
+    /**
+     Begins tracing `event`. Returns `nil` when tracing is disabled, so callers can message the result unconditionally.
+     */
+    @objc(traceEvent:named:tool:)
+    open class func trace(_ event: DrawEvent, named name: String, tool: DrawTool?) -> DrawEventTrace? {
+        return isEnabled ? shared.begin(event, named: name, tool: tool) : nil
+    }
+
+    /// Called when a graphic announces it's about to change.
+    open class func noteMutation() {
+        if isEnabled, let current = shared.current {
+            current.noteMutation(at: now)
+        }
+    }
+
+    /// Called when the page is asked to redisplay some part of itself.
+    open class func noteInvalidation() {
+        if isEnabled {
+            shared.noteInvalidation()
+        }
+    }
+
+    open class func noteDrawBegan() {
+        if isEnabled {
+            shared.drawStartTime = now
+        }
+    }
+
+    open class func noteDrawEnded() {
+        if isEnabled {
+            shared.noteDrawEnded()
+        }
+    }
+
+    internal func begin(_ event: DrawEvent, named name: String, tool: DrawTool?) -> DrawEventTrace {
+        let created = DrawEventTracer.now
+        // NSEvent timestamps are seconds of uptime. Synthetic events may not have one.
+        var eventTime = UInt64(max(0.0, event.event.timestamp) * 1.0e9)
+        if eventTime == 0 || eventTime > created {
+            eventTime = created
+        }
+        let trace = DrawEventTrace(identifier: nextIdentifier, name: name, toolName: tool?.name ?? "None", eventTime: eventTime, createdTime: created)
+        nextIdentifier += 1
+        current = trace
+        return trace
+    }
+
+    internal func endDispatch(_ trace: DrawEventTrace) {
+        trace.endDispatch(at: DrawEventTracer.now)
+        if current === trace {
+            current = nil
+        }
+        pending.append(trace)
+        if pending.count > maximumPendingTraces {
+            if let index = pending.firstIndex(where: { $0.invalidationTime == 0 }) {
+                retire(pending.remove(at: index))
+            } else {
+                retire(pending.removeFirst())
+            }
+        }
+    }
+
+    internal func noteInvalidation() {
+        let time = DrawEventTracer.now
+        if let current {
+            current.noteInvalidation(at: time)
+        } else {
+            // Invalidations deferred by -performSelector:afterDelay: arrive after dispatch. Credit them to events that mutated something but haven't invalidated yet.
+            for trace in pending where trace.invalidationTime == 0 && trace.mutationTime != 0 {
+                trace.noteInvalidation(at: time)
+            }
+        }
+    }
+
+    internal func noteDrawEnded() {
+        let end = DrawEventTracer.now
+        let start = drawStartTime != 0 ? drawStartTime : end
+        drawStartTime = 0
+        draws.append((start, end))
+        var remaining = [DrawEventTrace]()
+        for trace in pending {
+            if trace.invalidationTime != 0 && trace.invalidationTime <= start {
+                trace.noteDraw(from: start, to: end)
+                retire(trace)
+            } else if trace.invalidationTime == 0 && trace.dispatchEndTime <= start {
+                // The event didn't change anything, so nothing is going to show it.
+                retire(trace)
+            } else {
+                remaining.append(trace)
+            }
+        }
+        pending = remaining
+    }
+
+    internal func retire(_ trace: DrawEventTrace) {
+        completed.append(trace)
+    }
+
+    // MARK: - Results
+
+    open func reset() {
+        completed.removeAll()
+        pending.removeAll()
+        draws.removeAll()
+        current = nil
+    }
+
+    /// Per tool percentiles of dispatch time and event-to-pixels latency, sorted by tool name.
+    open var summaries : [DrawEventLatencySummary] {
+        let byTool = Dictionary(grouping: traces, by: { $0.toolName })
+        return byTool.keys.sorted().map { DrawEventLatencySummary(toolName: $0, traces: byTool[$0]!) }
+    }
+
+    /**
+     Returns the traces as a Chrome trace event JSON object.
+
+     The synchronous work, event creation, tool dispatch, mutation, and drawing, is emitted as complete ("X") events on the main thread track. Each event's time waiting for the display is emitted as an async span keyed by the event's identifier, because it overlaps the events that follow it.
+     */
+    open func traceEventObject() -> [String:Any] {
+        let traces = self.traces
+        let base = min(traces.first?.eventTime ?? 0, draws.first?.start ?? UInt64.max)
+        let micro = { (time: UInt64) -> Double in Double(time &- base) / 1000.0 }
+        let duration = { (start: UInt64, end: UInt64) -> Double in Double(end > start ? end - start : 0) / 1000.0 }
+        var events = [[String:Any]]()
+
+        events.append(["name": "thread_name", "ph": "M", "pid": 1, "tid": 1, "args": ["name": "Main Thread"]])
+        for trace in traces {
+            let args : [String:Any] = ["event": trace.identifier, "tool": trace.toolName]
+            events.append(["name": "create " + trace.name, "cat": "event", "ph": "X", "pid": 1, "tid": 1, "ts": micro(trace.eventTime), "dur": duration(trace.eventTime, trace.createdTime), "args": args])
+            events.append(["name": trace.toolName + " " + trace.name, "cat": "dispatch", "ph": "X", "pid": 1, "tid": 1, "ts": micro(trace.createdTime), "dur": duration(trace.createdTime, trace.dispatchEndTime), "args": args])
+            if trace.mutationTime != 0 {
+                events.append(["name": "mutate", "cat": "mutation", "ph": "X", "pid": 1, "tid": 1, "ts": micro(trace.mutationTime), "dur": duration(trace.mutationTime, max(trace.mutationTime, trace.dispatchEndTime)), "args": args])
+            }
+            if trace.drawEndTime != 0 {
+                let id = String(trace.identifier)
+                events.append(["name": trace.name, "cat": trace.toolName, "ph": "b", "id": id, "pid": 1, "tid": 1, "ts": micro(trace.eventTime), "args": args])
+                if trace.invalidationTime != 0 {
+                    events.append(["name": "invalidate", "cat": trace.toolName, "ph": "n", "id": id, "pid": 1, "tid": 1, "ts": micro(trace.invalidationTime)])
+                }
+                events.append(["name": trace.name, "cat": trace.toolName, "ph": "e", "id": id, "pid": 1, "tid": 1, "ts": micro(trace.drawEndTime)])
+            }
+        }
+        for draw in draws.elements where draw.start >= base {
+            events.append(["name": "drawRect", "cat": "draw", "ph": "X", "pid": 1, "tid": 1, "ts": micro(draw.start), "dur": duration(draw.start, draw.end)])
+        }
+
+        return ["traceEvents": events,
+                "displayTimeUnit": "ms",
+                "otherData": ["latencySummary": summaries.map { $0.dictionaryRepresentation }]]
+    }
+
+    open func traceData() throws -> Data {
+        return try JSONSerialization.data(withJSONObject: traceEventObject(), options: [.sortedKeys])
+    }
+
+    open func writeTrace(to url: URL) throws {
+        try traceData().write(to: url, options: [.atomic])
+    }
+
+}
@@ -0,0 +1,173 @@
+/*
+ DrawGridRenderer.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Draws the document grid as a tiled bitmap.
+
+ The grid used to be one bezier path with a line per grid spacing across the whole paper, stroked in full on every redraw with a point transform per point to keep the lines on pixel boundaries. Now a tile holding a few grid cells is rendered once per device scale, spacing and color, with its lines already on whole pixels, and then tiled into the dirty rect only.
+
+ A tile holds as many cells as it takes for its width to come out at a whole number of device pixels, so tiling never drifts off the pixel grid. Spacings where that would take too many cells are drawn as individual pixel-aligned lines, still only within the dirty rect.
+ */
+@objcMembers
+open class DrawGridRenderer : NSObject {
+
+    internal struct TileKey : Hashable {
+        var spacing : CGFloat
+        var deviceScale : CGFloat
+        var color : NSColor
+    }
+
+    internal struct Tile {
+        var image : CGImage
+        /// The tile's size in page units.
+        var size : CGFloat
+    }
+
+    /// The most cells we'll put in one tile.
+    internal static let maximumCellsPerTile = 16
+    internal static let maximumCachedTiles = 8
+
+    internal static var tiles = [TileKey:Tile]()
+    internal static var tileOrder = [TileKey]()
+
+    // MARK: - Drawing
+
+    /**
+     Draws grid lines every `spacing` page units, clipped to `rect` and to the inside of `paperBounds`. Like before, there are no lines along the paper's minimum edges.
+     */
+    open class func drawGrid(withSpacing spacing: CGFloat, color: NSColor, in rect: NSRect, paperBounds: NSRect) {
+        guard spacing > 0.0, let context = NSGraphicsContext.current?.cgContext else { return }
+
+        let deviceScale = abs(context.userSpaceToDeviceSpaceTransform.a)
+        guard deviceScale > 0.0 else { return }
+        let pixel = 1.0 / deviceScale
+
+        var clip = paperBounds
+        clip.origin.x += pixel
+        clip.origin.y += pixel
+        clip.size.width -= pixel
+        clip.size.height -= pixel
+        clip = clip.intersection(rect)
+        if clip.isEmpty {
+            return
+        }
+
+        context.saveGState()
+        defer { context.restoreGState() }
+        context.clip(to: clip)
+
+        if let tile = tile(spacing: spacing, deviceScale: deviceScale, color: color) {
+            // Start the tiling on a whole tile at or before the dirty rect, so tiles line up with the paper origin.
+            let startX = paperBounds.minX + (((clip.minX - paperBounds.minX) / tile.size).rounded(.down)) * tile.size
+            let startY = paperBounds.minY + (((clip.minY - paperBounds.minY) / tile.size).rounded(.down)) * tile.size
+            context.interpolationQuality = .none
+            context.draw(tile.image, in: CGRect(x: startX, y: startY, width: tile.size, height: tile.size), byTiling: true)
+        } else {
+            drawLines(spacing: spacing, color: color, in: clip, paperBounds: paperBounds, deviceScale: deviceScale, context: context)
+        }
+    }
+
+    /// The fallback for spacings that don't tile evenly: one pixel-aligned rect per line inside `clip`.
+    internal class func drawLines(spacing: CGFloat, color: NSColor, in clip: NSRect, paperBounds: NSRect, deviceScale: CGFloat, context: CGContext) {
+        let pixel = 1.0 / deviceScale
+        var rects = [CGRect]()
+
+        func aligned(_ value: CGFloat) -> CGFloat {
+            return (value * deviceScale).rounded() / deviceScale
+        }
+        let firstColumn = Int(((clip.minX - paperBounds.minX) / spacing).rounded(.down))
+        let lastColumn = Int(((clip.maxX - paperBounds.minX) / spacing).rounded(.up))
+        for column in firstColumn ... lastColumn {
+            rects.append(CGRect(x: aligned(paperBounds.minX + CGFloat(column) * spacing), y: clip.minY, width: pixel, height: clip.height))
+        }
+        let firstRow = Int(((clip.minY - paperBounds.minY) / spacing).rounded(.down))
+        let lastRow = Int(((clip.maxY - paperBounds.minY) / spacing).rounded(.up))
+        for row in firstRow ... lastRow {
+            rects.append(CGRect(x: clip.minX, y: aligned(paperBounds.minY + CGFloat(row) * spacing), width: clip.width, height: pixel))
+        }
+
+        context.setFillColor(color.cgColor)
+        context.fill(rects)
+    }
+
+    // MARK: - Tiles
+
+    /// The number of cells it takes for a tile to be a whole number of device pixels wide, or `nil` if that's more than `maximumCellsPerTile`.
+    internal class func cellsPerTile(spacing: CGFloat, deviceScale: CGFloat) -> Int? {
+        let pixelsPerCell = spacing * deviceScale
+        for cells in 1 ... maximumCellsPerTile {
+            let pixels = pixelsPerCell * CGFloat(cells)
+            if abs(pixels - pixels.rounded()) < 0.01 {
+                return cells
+            }
+        }
+        return nil
+    }
+
+    internal class func tile(spacing: CGFloat, deviceScale: CGFloat, color: NSColor) -> Tile? {
+        let key = TileKey(spacing: spacing, deviceScale: deviceScale, color: color)
+        if let tile = tiles[key] {
+            return tile
+        }
+        guard let cells = cellsPerTile(spacing: spacing, deviceScale: deviceScale) else {
+            return nil
+        }
+
+        let pixels = Int((spacing * deviceScale * CGFloat(cells)).rounded())
+        guard pixels > 0, pixels <= 4096,
+              let context = CGContext(data: nil, width: pixels, height: pixels, bitsPerComponent: 8, bytesPerRow: 0, space: CGColorSpace(name: CGColorSpace.sRGB)!, bitmapInfo: CGImageAlphaInfo.premultipliedLast.rawValue) else {
+            return nil
+        }
+        context.setFillColor(color.cgColor)
+        var rects = [CGRect]()
+        for cell in 0 ..< cells {
+            // Each line sits on the pixel nearest its true position, so lines stay evenly spaced across tiles.
+            let offset = (spacing * deviceScale * CGFloat(cell)).rounded()
+            rects.append(CGRect(x: offset, y: 0.0, width: 1.0, height: CGFloat(pixels)))
+            rects.append(CGRect(x: 0.0, y: offset, width: CGFloat(pixels), height: 1.0))
+        }
+        context.fill(rects)
+        guard let image = context.makeImage() else {
+            return nil
+        }
+
+        let tile = Tile(image: image, size: CGFloat(pixels) / deviceScale)
+        tiles[key] = tile
+        tileOrder.append(key)
+        if tileOrder.count > maximumCachedTiles {
+            tiles[tileOrder.removeFirst()] = nil
+        }
+        return tile
+    }
+
+}
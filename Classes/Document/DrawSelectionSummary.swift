@@ -0,0 +1,297 @@
+/*
+ DrawSelectionSummary.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRFoundation
+
+/**
+ How the values of one key path are spread across the selection.
+
+ Holds a count of the graphics having each distinct value, so adding, removing, or changing a graphic only touches that graphic's bucket. A graphic whose key path evaluates to `nil` is counted under `NSNull`.
+
+ Values are counted by a copy taken when they're read, so a mutable value that changes afterwards can't strand its bucket. Values that can't be copied are counted by identity.
+ */
+@objcMembers
+open class DrawSelectionHistogram : NSObject {
+
+    /// Counts a value that can't be copied by the object itself, since its equality could change under us.
+    internal struct IdentityKey : Hashable {
+        var object : NSObject
+
+        static func == (lhs: IdentityKey, rhs: IdentityKey) -> Bool {
+            return lhs.object === rhs.object
+        }
+
+        func hash(into hasher: inout Hasher) {
+            hasher.combine(ObjectIdentifier(object))
+        }
+    }
+
+    open private(set) var keyPath : String
+    internal private(set) var counts = [AnyHashable:Int]()
+    private var cachedMinimum : NSNumber?
+    private var cachedMaximum : NSNumber?
+    private var extremesAreValid = true
+
+    internal init(keyPath: String) {
+        self.keyPath = keyPath
+        super.init()
+    }
+
+    /// The number of distinct values in the selection.
+    open var distinctValueCount : Int {
+        return counts.count
+    }
+
+    /// `true` when the selected graphics don't all share one value.
+    open var isMixed : Bool {
+        return counts.count > 1
+    }
+
+    /// The value every selected graphic shares, or `nil` if the selection is empty, mixed, or the shared value is `nil`.
+    open var commonValue : Any? {
+        if counts.count == 1, let value = counts.keys.first, !(value.base is NSNull) {
+            return (value.base as? IdentityKey)?.object ?? value.base
+        }
+        return nil
+    }
+
+    /// The number of selected graphics whose value is `value`.
+    open func count(of value: Any?) -> Int {
+        return counts[DrawSelectionHistogram.key(for: value)] ?? 0
+    }
+
+    /// The smallest numeric value in the selection, or `nil` if there are no numeric values.
+    open var minimum : NSNumber? {
+        updateExtremesIfNeeded()
+        return cachedMinimum
+    }
+
+    /// The largest numeric value in the selection, or `nil` if there are no numeric values.
+    open var maximum : NSNumber? {
+        updateExtremesIfNeeded()
+        return cachedMaximum
+    }
+
+    // MARK: - Counting
+
+    internal static func key(for value: Any?) -> AnyHashable {
+        guard let value = value as? NSObject else {
+            return AnyHashable(NSNull())
+        }
+        // Immutable values, which is nearly all of them, just return themselves.
+        if let copyable = value as? NSCopying, let copy = copyable.copy(with: nil) as? NSObject {
+            return AnyHashable(copy)
+        }
+        return AnyHashable(IdentityKey(object: value))
+    }
+
+    internal func add(_ key: AnyHashable) {
+        counts[key, default: 0] += 1
+        if extremesAreValid, let number = key.base as? NSNumber {
+            if cachedMinimum == nil || number.compare(cachedMinimum!) == .orderedAscending {
+                cachedMinimum = number
+            }
+            if cachedMaximum == nil || number.compare(cachedMaximum!) == .orderedDescending {
+                cachedMaximum = number
+            }
+        }
+    }
+
+    internal func remove(_ key: AnyHashable) {
+        guard let count = counts[key] else { return }
+        if count > 1 {
+            counts[key] = count - 1
+        } else {
+            counts[key] = nil
+            // Losing the last of an extreme means finding the next one, but only when someone asks.
+            if let number = key.base as? NSNumber, number == cachedMinimum || number == cachedMaximum {
+                extremesAreValid = false
+            }
+        }
+    }
+
+    internal func removeAll() {
+        counts.removeAll()
+        cachedMinimum = nil
+        cachedMaximum = nil
+        extremesAreValid = true
+    }
+
+    private func updateExtremesIfNeeded() {
+        if !extremesAreValid {
+            // This scans the distinct values, not the graphics.
+            cachedMinimum = nil
+            cachedMaximum = nil
+            extremesAreValid = true
+            for key in counts.keys {
+                if let number = key.base as? NSNumber {
+                    if cachedMinimum == nil || number.compare(cachedMinimum!) == .orderedAscending {
+                        cachedMinimum = number
+                    }
+                    if cachedMaximum == nil || number.compare(cachedMaximum!) == .orderedDescending {
+                        cachedMaximum = number
+                    }
+                }
+            }
+        }
+    }
+
+}
+
+/**
+ An aggregate view of the document's selection, kept current as graphics enter and leave the selection, or change.
+
+ Asking whether ten thousand selected graphics share a stroke width used to mean reading the width off every one of them, every time anything changed. The summary instead keeps a `DrawSelectionHistogram` per key path, and each selection change or edit only moves the affected graphics between buckets. Reading the common value, whether the selection is mixed, or its range is then constant time.
+
+ Key paths are only tracked once someone asks for them with `histogram(forKeyPath:)`, which scans the selection once. After that, every graphic that enters, leaves, or changes costs one read per tracked key path.
+
+ The document owns the summary, see `-[DrawDocument selectionSummary]`, and tells it about changes, so it's rarely necessary to call the mutating methods directly.
+ */
+@objcMembers
+open class DrawSelectionSummary : NSObject {
+
+    internal struct Entry {
+        var graphic : DrawGraphic
+        var values : [AnyHashable]
+        var isGroup : Bool
+    }
+
+    // Graphics may override -isEqual:, but we care about identity.
+    internal private(set) var entries = [ObjectIdentifier:Entry]()
+    internal private(set) var histograms = [DrawSelectionHistogram]()
+    private var histogramsByKeyPath = [String:DrawSelectionHistogram]()
+    private var groups = [ObjectIdentifier:DrawGraphic]()
+
+    public override init() {
+        super.init()
+    }
+
+    public init(graphics: Set<DrawGraphic>) {
+        super.init()
+        for graphic in graphics {
+            addGraphic(graphic)
+        }
+    }
+
+    // MARK: - Reading
+
+    /// The number of graphics in the selection.
+    open var count : Int {
+        return entries.count
+    }
+
+    /// The number of selected graphics that have subgraphics.
+    open var groupCount : Int {
+        return groups.count
+    }
+
+    /// The only selected graphic with subgraphics, or `nil` if there are none, or more than one.
+    open var group : DrawGraphic? {
+        return groups.count == 1 ? groups.values.first : nil
+    }
+
+    open func contains(_ graphic: DrawGraphic) -> Bool {
+        return entries[ObjectIdentifier(graphic)] != nil
+    }
+
+    /// Returns the histogram for `keyPath`, evaluated against each selected graphic. The first request for a key path scans the selection. After that the histogram is kept current, and reading it is constant time.
+    @objc(histogramForKeyPath:)
+    open func histogram(forKeyPath keyPath: String) -> DrawSelectionHistogram {
+        if let histogram = histogramsByKeyPath[keyPath] {
+            return histogram
+        }
+        let histogram = DrawSelectionHistogram(keyPath: keyPath)
+        for (identifier, var entry) in entries {
+            let key = DrawSelectionHistogram.key(for: entry.graphic.value(forKeyPath: keyPath))
+            histogram.add(key)
+            entry.values.append(key)
+            entries[identifier] = entry
+        }
+        histograms.append(histogram)
+        histogramsByKeyPath[keyPath] = histogram
+        return histogram
+    }
+
+    // MARK: - Updating
+
+    open func addGraphic(_ graphic: DrawGraphic) {
+        let identifier = ObjectIdentifier(graphic)
+        if entries[identifier] == nil {
+            let entry = makeEntry(for: graphic)
+            for (histogram, key) in zip(histograms, entry.values) {
+                histogram.add(key)
+            }
+            if entry.isGroup {
+                groups[identifier] = graphic
+            }
+            entries[identifier] = entry
+        }
+    }
+
+    open func removeGraphic(_ graphic: DrawGraphic) {
+        let identifier = ObjectIdentifier(graphic)
+        if let entry = entries.removeValue(forKey: identifier) {
+            for (histogram, key) in zip(histograms, entry.values) {
+                histogram.remove(key)
+            }
+            groups[identifier] = nil
+        }
+    }
+
+    /// Re-reads the tracked key paths from `graphic`, moving it to its new buckets. Does nothing if `graphic` isn't selected.
+    open func graphicDidChange(_ graphic: DrawGraphic) {
+        let identifier = ObjectIdentifier(graphic)
+        if let oldEntry = entries[identifier] {
+            let entry = makeEntry(for: graphic)
+            for (index, histogram) in histograms.enumerated() where oldEntry.values[index] != entry.values[index] {
+                histogram.remove(oldEntry.values[index])
+                histogram.add(entry.values[index])
+            }
+            groups[identifier] = entry.isGroup ? graphic : nil
+            entries[identifier] = entry
+        }
+    }
+
+    open func removeAllGraphics() {
+        entries.removeAll()
+        groups.removeAll()
+        for histogram in histograms {
+            histogram.removeAll()
+        }
+    }
+
+    internal func makeEntry(for graphic: DrawGraphic) -> Entry {
+        return Entry(graphic: graphic,
+                     values: histograms.map { DrawSelectionHistogram.key(for: graphic.value(forKeyPath: $0.keyPath)) },
+                     isGroup: graphic.subgraphics.count > 0)
+    }
+
+}
@@ -0,0 +1,278 @@
+/*
+ DrawBatchExporter.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+import Darwin
+
+@objc
+public enum DrawExportFormat : Int {
+
+    case png
+    case pdf
+
+    public var pathExtension : String {
+        switch self {
+        case .png: return "png"
+        case .pdf: return "pdf"
+        }
+    }
+
+}
+
+/// The outcome of rendering a single page.
+@objcMembers
+open class DrawExportPageResult : NSObject {
+
+    open var documentURL : URL
+    /// One based, to match what the user sees in the page number.
+    open var pageNumber : Int
+    open var outputURL : URL?
+    open var renderTime : TimeInterval = 0.0
+    /// The resident high water mark of the whole process, in bytes, sampled once the page finished. This covers everything the process has done so far, including other pages rendering at the same time, so it's an upper bound on what this page needed, not its own peak.
+    open var peakMemory : UInt64 = 0
+    open var error : Error?
+
+    public init(documentURL: URL, pageNumber: Int) {
+        self.documentURL = documentURL
+        self.pageNumber = pageNumber
+        super.init()
+    }
+
+    open override var description: String {
+        if let error = error {
+            return "\(documentURL.lastPathComponent) page \(pageNumber): \(error.localizedDescription)"
+        }
+        return String(format: "%@ page %ld: %.1f ms, process peak %.1f MB", documentURL.lastPathComponent, pageNumber, renderTime * 1000.0, Double(peakMemory) / (1024.0 * 1024.0))
+    }
+
+}
+
+/**
+ Renders documents to PNG or PDF without any user interface.
+
+ Documents are read directly via `DrawFilter`, so no window controllers, storyboards, or paged views are ever created. Pages are independent of one another, so once a document is loaded, its pages are rendered concurrently, up to `maxConcurrentPages` at a time.
+
+ Graphics cache things as they draw, such as their flattened paths and group bitmaps, and those caches aren't safe to share between threads. So each concurrent worker renders from its own copy of the document, loaded from the same URL, and never touches another worker's graphics. Loading happens on the calling thread, because `NSDocument` isn't safe to create concurrently.
+ */
+@objcMembers
+open class DrawBatchExporter : NSObject {
+
+    // MARK: - Properties
+
+    open var outputDirectory : URL
+    open var format = DrawExportFormat.png
+    /// Scale applied when rasterizing. Ignored for PDF.
+    open var scale : CGFloat = 1.0
+    /// One based page numbers to render. When `nil`, all pages are rendered.
+    open var pageNumbers : IndexSet? = nil
+    open var maxConcurrentPages = ProcessInfo.processInfo.activeProcessorCount
+
+    // MARK: - Creation
+
+    public init(outputDirectory: URL) {
+        self.outputDirectory = outputDirectory
+        super.init()
+    }
+
+    // MARK: - Loading
+
+    open class func loadDocument(at url: URL) throws -> DrawDocument {
+        let type = url.pathExtension
+        guard let filter = DrawFilter.readFilter(forType: type) else {
+            throw NSError(domain: DrawDocumentErrorDomain, code: -1, userInfo: [NSLocalizedDescriptionKey: "There is no registered input filter for the file type '\(type)'."])
+        }
+        let wrapper = try FileWrapper(url: url, options: .immediate)
+        let document = try DrawDocument(type: type)
+
+        // Same as -[DrawDocument readFromFileWrapper:ofType:error:], minus the window controller dance.
+        DrawGraphic.disableNotifications()
+        document.undoManager?.disableUndoRegistration()
+        defer {
+            document.undoManager?.enableUndoRegistration()
+            DrawGraphic.enableNotifications()
+        }
+        try filter.readDocument(document, from: wrapper)
+
+        return document
+    }
+
+    // MARK: - Rendering
+
+    open func pngData(for page: DrawPage) -> Data? {
+        let size = page.bounds.size
+        let width = Int(ceil(size.width * scale))
+        let height = Int(ceil(size.height * scale))
+        guard width > 0, height > 0,
+              let colorSpace = CGColorSpace(name: CGColorSpace.sRGB),
+              let context = CGContext(data: nil, width: width, height: height, bitsPerComponent: 8, bytesPerRow: 0, space: colorSpace, bitmapInfo: CGImageAlphaInfo.premultipliedLast.rawValue)
+        else { return nil }
+
+        // Pages are flipped.
+        context.translateBy(x: 0.0, y: CGFloat(height))
+        context.scaleBy(x: scale, y: -scale)
+        draw(page, in: context)
+
+        guard let image = context.makeImage() else { return nil }
+        return NSBitmapImageRep(cgImage: image).representation(using: .png, properties: [:])
+    }
+
+    open func pdfData(for page: DrawPage) -> Data? {
+        let data = NSMutableData()
+        var mediaBox = CGRect(origin: .zero, size: page.bounds.size)
+        guard let consumer = CGDataConsumer(data: data as CFMutableData),
+              let context = CGContext(consumer: consumer, mediaBox: &mediaBox, nil)
+        else { return nil }
+
+        context.beginPDFPage(nil)
+        context.translateBy(x: 0.0, y: mediaBox.height)
+        context.scaleBy(x: 1.0, y: -1.0)
+        draw(page, in: context)
+        context.endPDFPage()
+        context.closePDF()
+
+        return data as Data
+    }
+
+    internal func draw(_ page: DrawPage, in context: CGContext) {
+        // The current graphics context is per thread, so this is safe to do concurrently.
+        NSGraphicsContext.saveGraphicsState()
+        NSGraphicsContext.current = NSGraphicsContext(cgContext: context, flipped: true)
+        page.drawForExport(in: page.bounds)
+        NSGraphicsContext.restoreGraphicsState()
+    }
+
+    // MARK: - Exporting
+
+    open func outputURL(for documentURL: URL, pageNumber: Int) -> URL {
+        let base = documentURL.deletingPathExtension().lastPathComponent
+        return outputDirectory.appendingPathComponent(String(format: "%@-%03ld", base, pageNumber)).appendingPathExtension(format.pathExtension)
+    }
+
+    /// Renders the selected pages of `document`, which should be the document saved at `documentURL`, since extra copies for the concurrent workers are loaded from there. The results are returned in page order, regardless of the order in which they finished.
+    open func export(_ document: DrawDocument, from documentURL: URL, progress: ((DrawExportPageResult) -> Void)? = nil) -> [DrawExportPageResult] {
+        let selected = (pageNumbers ?? IndexSet(integersIn: 1 ... max(document.pages.count, 1))).filter { $0 >= 1 && $0 <= document.pages.count }
+        var results = [DrawExportPageResult?](repeating: nil, count: selected.count)
+        let lock = NSLock()
+
+        // One document per worker, so no two threads ever draw the same graphic. If a copy won't load, we just run with fewer workers.
+        let workerCount = min(max(maxConcurrentPages, 1), selected.count)
+        var documents = [document]
+        while documents.count < workerCount, let copy = try? DrawBatchExporter.loadDocument(at: documentURL) {
+            documents.append(copy)
+        }
+        // The workers draw off the main thread, so nothing may still be waiting on the event loop.
+        DrawLinkUpdater.flush()
+        defer {
+            for copy in documents.dropFirst() {
+                copy.close()
+            }
+        }
+
+        DispatchQueue.concurrentPerform(iterations: documents.count) { worker in
+            let pages = documents[worker].pages
+            for index in stride(from: worker, to: selected.count, by: documents.count) {
+                let pageNumber = selected[index]
+                let result = DrawExportPageResult(documentURL: documentURL, pageNumber: pageNumber)
+                autoreleasepool {
+                    let start = DispatchTime.now()
+                    let data = format == .png ? pngData(for: pages[pageNumber - 1]) : pdfData(for: pages[pageNumber - 1])
+                    if let data = data {
+                        let url = outputURL(for: documentURL, pageNumber: pageNumber)
+                        do {
+                            try data.write(to: url, options: .atomic)
+                            result.outputURL = url
+                        } catch {
+                            result.error = error
+                        }
+                    } else {
+                        result.error = NSError(domain: DrawDocumentErrorDomain, code: -1, userInfo: [NSLocalizedDescriptionKey: "Unable to create a graphics context for page \(pageNumber)."])
+                    }
+                    result.renderTime = TimeInterval(DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds) / 1.0e9
+                    result.peakMemory = DrawBatchExporter.peakResidentMemory
+                }
+
+                lock.lock()
+                results[index] = result
+                progress?(result)
+                lock.unlock()
+            }
+        }
+
+        return results.compactMap { $0 }
+    }
+
+    /// Loads and renders each document in turn. A document that fails to load produces a single result carrying the error.
+    open func export(documentsAt urls: [URL], progress: ((DrawExportPageResult) -> Void)? = nil) -> [DrawExportPageResult] {
+        var results = [DrawExportPageResult]()
+
+        for url in urls {
+            autoreleasepool {
+                do {
+                    let document = try DrawBatchExporter.loadDocument(at: url)
+                    results.append(contentsOf: export(document, from: url, progress: progress))
+                    document.close()
+                } catch {
+                    let result = DrawExportPageResult(documentURL: url, pageNumber: 0)
+                    result.error = error
+                    results.append(result)
+                    progress?(result)
+                }
+            }
+        }
+
+        return results
+    }
+
+    // MARK: - Benchmarking
+
+    /// Exports `urls` `iterations` times and returns the throughput in documents per minute, including load time.
+    open func benchmark(documentsAt urls: [URL], iterations: Int = 1) -> Double {
+        let start = DispatchTime.now()
+        for _ in 0 ..< max(iterations, 1) {
+            _ = export(documentsAt: urls)
+        }
+        let elapsed = Double(DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds) / 1.0e9
+        return elapsed > 0.0 ? Double(urls.count * max(iterations, 1)) / (elapsed / 60.0) : 0.0
+    }
+
+    // MARK: - Memory
+
+    /// The resident memory high water mark for the whole process, in bytes, since it started. It never goes down, so it isn't the peak of any one export.
+    open class var peakResidentMemory : UInt64 {
+        var usage = rusage()
+        if getrusage(RUSAGE_SELF, &usage) == 0 {
+            // On Darwin, ru_maxrss is reported in bytes, not kilobytes.
+            return UInt64(usage.ru_maxrss)
+        }
+        return 0
+    }
+
+}
@@ -41,8 +41,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (void)registerFilter:(Class)filterClass properties:(NSDictionary<NSString *, id> *)properties;
 
-+ (DrawFilter *)readFilterForType:(NSString *)type;
-+ (DrawFilter *)writeFilterForType:(NSString *)type;
++ (nullable DrawFilter *)readFilterForType:(NSString *)type;
++ (nullable DrawFilter *)writeFilterForType:(NSString *)type;
 
 + (NSArray<NSString *> *)readableFilterTypes;
 + (NSArray<NSString *> *)writableFilterTypes;
@@ -0,0 +1,62 @@
+/*
+ DrawSVGFilter.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Writes documents as SVG. This is a write only filter.
+
+ The real work is done by `DrawSVGWriter`, which streams to a file handle. Use `write(_:to:)` directly when you don't need a file wrapper, since it never holds more than a buffer's worth of output in memory.
+ */
+@objcMembers
+open class DrawSVGFilter : DrawFilter {
+
+    open func write(_ document: DrawDocument, to fileHandle: FileHandle) throws {
+        try DrawSVGWriter(fileHandle: fileHandle).write(document)
+    }
+
+    open func write(_ document: DrawDocument, to url: URL) throws {
+        FileManager.default.createFile(atPath: url.path, contents: nil)
+        let fileHandle = try FileHandle(forWritingTo: url)
+        defer { try? fileHandle.close() }
+        try write(document, to: fileHandle)
+    }
+
+    open override func updateFileWrapper(_ fileWrapper: FileWrapper?, for document: DrawDocument) throws -> FileWrapper {
+        // NSDocument wants a file wrapper, so stream to a temporary file and wrap that.
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString).appendingPathExtension("svg")
+        defer { try? FileManager.default.removeItem(at: url) }
+        try write(document, to: url)
+        let wrapper = try FileWrapper(url: url, options: .immediate)
+        return wrapper
+    }
+
+}
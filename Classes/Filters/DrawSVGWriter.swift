@@ -0,0 +1,563 @@
+/*
+ DrawSVGWriter.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Streams a document out as SVG.
+
+ Nothing resembling a DOM is built. Each page is visited twice: once to discover any styles, gradients, patterns, and filters that haven't been seen yet, which are then emitted in a `<defs>` block, and once to write the elements themselves. Definitions are shared by every later page, so a style used by thousands of graphics is written exactly once. Output is buffered and flushed to the file handle in large chunks.
+ */
+@objcMembers
+open class DrawSVGWriter : NSObject {
+
+    // MARK: - Properties
+
+    public let fileHandle : FileHandle
+    /// How much output we'll accumulate before handing it to the file handle.
+    open var flushThreshold = 256 * 1024
+
+    private var buffer = ""
+    private var styleIds = [String:String]()
+    private var gradientIds = [String:String]()
+    private var patternIds = [PatternKey:String]()
+    private var filterIds = [String:String]()
+    private var pendingDefinitions = ""
+    private var pendingStyles = ""
+    /// True during the first pass over a page, when we're only discovering definitions.
+    private var collecting = false
+    private var nextId = 0
+
+    // MARK: - Creation
+
+    public init(fileHandle: FileHandle) {
+        self.fileHandle = fileHandle
+        super.init()
+    }
+
+    // MARK: - Writing
+
+    open func write(_ document: DrawDocument) throws {
+        DrawLinkUpdater.flush()
+        let pages = document.pages
+        var size = NSSize.zero
+        for page in pages {
+            size.width = max(size.width, page.bounds.width)
+            size.height += page.bounds.height
+        }
+
+        buffer.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n")
+        buffer.append("<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" version=\"1.1\"")
+        buffer.append(" width=\""); append(size.width)
+        buffer.append("\" height=\""); append(size.height)
+        buffer.append("\" viewBox=\"0 0 "); append(size.width); buffer.append(" "); append(size.height)
+        buffer.append("\">\n")
+
+        var y : CGFloat = 0.0
+        for (index, page) in pages.enumerated() {
+            try autoreleasepool {
+                try write(page, number: index + 1, in: document, atY: y)
+            }
+            y += page.bounds.height
+        }
+
+        buffer.append("</svg>\n")
+        try flush()
+    }
+
+    open func write(_ page: DrawPage, number: Int, in document: DrawDocument, atY y: CGFloat) throws {
+        let layers = document.layers.filter { $0.visible && $0.printable }
+
+        // Pass one: definitions. This walks the same code as the content pass, but skips the path data, which is the expensive part, and throws away the output.
+        let content = buffer
+        buffer = ""
+        collecting = true
+        for layer in layers {
+            for graphic in page.graphics(for: layer) {
+                if let graphic = graphic as? DrawGraphic {
+                    try write(graphic)
+                }
+            }
+        }
+        collecting = false
+        buffer = content
+        if !pendingStyles.isEmpty || !pendingDefinitions.isEmpty {
+            buffer.append("<defs>\n")
+            if !pendingStyles.isEmpty {
+                buffer.append("<style>\n")
+                buffer.append(pendingStyles)
+                buffer.append("</style>\n")
+            }
+            buffer.append(pendingDefinitions)
+            buffer.append("</defs>\n")
+            pendingStyles = ""
+            pendingDefinitions = ""
+        }
+
+        // Pass two: content.
+        buffer.append("<g id=\"page-\(number)\"")
+        if y != 0.0 {
+            buffer.append(" transform=\"translate(0 "); append(y); buffer.append(")\"")
+        }
+        buffer.append(">\n")
+        buffer.append("<rect width=\""); append(page.bounds.width)
+        buffer.append("\" height=\""); append(page.bounds.height)
+        buffer.append("\" fill=\"\(hex(page.paperColor))\"/>\n")
+        for layer in layers {
+            for graphic in page.graphics(for: layer) {
+                if let graphic = graphic as? DrawGraphic {
+                    try write(graphic)
+                }
+            }
+        }
+        buffer.append("</g>\n")
+        try flush()
+    }
+
+    // MARK: - Graphics
+
+    /// One thing `write(_:)` paints: an aspect, or the graphic's subgraphics.
+    internal enum PaintItem {
+        case aspect(DrawAspect)
+        case children
+    }
+
+    /// What to paint for `graphic`, in the order `-drawWithAspectFilter:` paints it. The subgraphics come once, at the start of the children priority.
+    internal func paintItems(of graphic: DrawGraphic) -> [PaintItem] {
+        var items = [PaintItem]()
+        let hasChildren = graphic.subgraphics.count > 0
+        var rawPriority = DrawAspectPriority.first.rawValue
+        while rawPriority <= DrawAspectPriority.last.rawValue, let priority = DrawAspectPriority(rawValue: rawPriority) {
+            if priority == .children && hasChildren {
+                items.append(.children)
+            }
+            for aspect in graphic.aspects(for: priority) where aspect.isActive {
+                items.append(.aspect(aspect))
+            }
+            rawPriority += 1
+        }
+        return items
+    }
+
+    internal func write(_ graphic: DrawGraphic) throws {
+        let items = paintItems(of: graphic)
+        var shadow : DrawShadow? = nil
+        for case .aspect(let aspect as DrawShadow) in items {
+            shadow = aspect
+            break
+        }
+        var pathData : String? = nil
+        var index = 0
+
+        func path() -> String {
+            if pathData == nil {
+                pathData = svgPathData(for: graphic.path)
+            }
+            return pathData!
+        }
+
+        if let shadow {
+            buffer.append("<g filter=\"url(#\(filterId(for: shadow)))\">\n")
+        }
+
+        while index < items.count {
+            switch items[index] {
+            case .children:
+                try writeSubgraphics(of: graphic, clippedTo: path)
+            case .aspect(let fill as DrawFill):
+                var style = fillStyle(for: fill)
+                // The overwhelmingly common case is a fill followed by a stroke, and SVG paints fill then stroke, so fold them into one element. The items are in paint order, so this never folds across the children.
+                if index + 1 < items.count, case .aspect(let stroke as DrawStroke) = items[index + 1] {
+                    style += ";" + strokeStyle(for: stroke)
+                    index += 1
+                } else {
+                    style += ";stroke:none"
+                }
+                writePath(style: style, data: path)
+            case .aspect(let stroke as DrawStroke):
+                writePath(style: "fill:none;" + strokeStyle(for: stroke), data: path)
+            case .aspect(let text as DrawText):
+                write(text, in: graphic)
+            default:
+                break
+            }
+            index += 1
+        }
+
+        if shadow != nil {
+            buffer.append("</g>\n")
+        }
+        if !collecting && buffer.utf8.count >= flushThreshold {
+            try flush()
+        }
+    }
+
+    /// Writes the subgraphics of `graphic` clipped to its path, the way `-drawWithAspectFilter:` draws them.
+    internal func writeSubgraphics(of graphic: DrawGraphic, clippedTo data: () -> String) throws {
+        var clipId : String? = nil
+        if !collecting {
+            let id = makeId("c")
+            buffer.append("<clipPath id=\"\(id)\"><path d=\"")
+            buffer.append(data())
+            buffer.append("\"")
+            if graphic.path.windingRule == .evenOdd {
+                buffer.append(" clip-rule=\"evenodd\"")
+            }
+            buffer.append("/></clipPath>\n")
+            buffer.append("<g clip-path=\"url(#\(id))\">\n")
+            clipId = id
+        }
+        for subgraphic in graphic.subgraphics {
+            if let subgraphic = subgraphic as? DrawGraphic {
+                try write(subgraphic)
+            }
+        }
+        if clipId != nil {
+            buffer.append("</g>\n")
+        }
+    }
+
+    internal func writePath(style: String, data: () -> String) {
+        let id = styleId(for: style)
+        if !collecting {
+            buffer.append("<path class=\"\(id)\" d=\"")
+            buffer.append(data())
+            buffer.append("\"/>\n")
+        }
+    }
+
+    internal func write(_ text: DrawText, in graphic: DrawGraphic) {
+        guard let layoutManager = text.layoutManager, let textContainer = text.textContainer else { return }
+        let storage = text.textStorage
+        let glyphRange = layoutManager.glyphRange(for: textContainer)
+        var origin = graphic.frame.origin
+        origin.y += text.yOffset(in: layoutManager.usedRect(for: textContainer))
+
+        // Build the spans separately, since discovering a new style emits a definition, and that can't land inside <text>.
+        var spans = ""
+        layoutManager.enumerateLineFragments(forGlyphRange: glyphRange) { rect, usedRect, container, lineGlyphRange, stop in
+            let characterRange = layoutManager.characterRange(forGlyphRange: lineGlyphRange, actualGlyphRange: nil)
+            storage.enumerateAttributes(in: characterRange) { attributes, range, stop in
+                let string = (storage.string as NSString).substring(with: range).trimmingCharacters(in: .newlines)
+                if string.isEmpty { return }
+                let glyphIndex = layoutManager.glyphIndexForCharacter(at: range.location)
+                let location = layoutManager.location(forGlyphAt: glyphIndex)
+                let font = attributes[.font] as? NSFont ?? NSFont.userFont(ofSize: 12.0)!
+                let color = attributes[.foregroundColor] as? NSColor ?? NSColor.black
+                var style = "font-family:'\(self.cssEscape(font.familyName ?? font.fontName))';font-size:\(self.number(font.pointSize))"
+                if font.fontDescriptor.symbolicTraits.contains(.bold) { style += ";font-weight:bold" }
+                if font.fontDescriptor.symbolicTraits.contains(.italic) { style += ";font-style:italic" }
+                style += ";" + self.paint("fill", color)
+
+                spans.append("<tspan class=\"\(self.styleId(for: style))\" x=\"")
+                spans.append(self.number(origin.x + rect.origin.x + location.x))
+                spans.append("\" y=\"")
+                spans.append(self.number(origin.y + rect.origin.y + location.y))
+                spans.append("\">")
+                spans.append(self.escape(string))
+                spans.append("</tspan>")
+            }
+        }
+        if !spans.isEmpty {
+            buffer.append("<text xml:space=\"preserve\">")
+            buffer.append(spans)
+            buffer.append("</text>\n")
+        }
+    }
+
+    // MARK: - Definitions
+
+    internal func makeId(_ prefix: String) -> String {
+        nextId += 1
+        return prefix + String(nextId, radix: 36)
+    }
+
+    /// Returns the class for `style`, emitting a rule for it the first time it's seen.
+    internal func styleId(for style: String) -> String {
+        if let id = styleIds[style] {
+            return id
+        }
+        let id = makeId("s")
+        styleIds[style] = id
+        if collecting {
+            pendingStyles.append(".\(id){\(style)}\n")
+        } else {
+            // Shouldn't really happen, since the first pass sees everything the second does, but <defs> is valid anywhere, so be safe.
+            buffer.append("<defs><style>.\(id){\(style)}</style></defs>\n")
+        }
+        return id
+    }
+
+    internal func fillStyle(for fill: DrawFill) -> String {
+        var style : String
+        switch fill.filler {
+        case let filler as DrawFillColor:
+            style = paint("fill", filler.color)
+        case let filler as DrawFillGradient:
+            style = "fill:url(#\(gradientId(for: filler)))"
+        case let filler as DrawFillImage:
+            style = "fill:url(#\(patternId(for: filler)))"
+        default:
+            style = "fill:none"
+        }
+        if fill.windingRule == .evenOdd {
+            style += ";fill-rule:evenodd"
+        }
+        return style
+    }
+
+    internal func strokeStyle(for stroke: DrawStroke) -> String {
+        var style = paint("stroke", stroke.color) + ";stroke-width:" + number(stroke.width)
+        switch stroke.lineJoin.rawValue {
+        case 1: style += ";stroke-linejoin:round"
+        case 2: style += ";stroke-linejoin:bevel"
+        default: style += ";stroke-miterlimit:" + number(stroke.miterLimit)
+        }
+        switch stroke.lineCap.rawValue {
+        case 1: style += ";stroke-linecap:round"
+        case 2: style += ";stroke-linecap:square"
+        default: break
+        }
+        if let dash = stroke.dash, let values = dash.dash, values.count > 0 {
+            style += ";stroke-dasharray:" + values.map { number($0 * stroke.width) }.joined(separator: " ")
+            if dash.offset != 0.0 {
+                style += ";stroke-dashoffset:" + number(dash.offset * stroke.width)
+            }
+        }
+        return style
+    }
+
+    internal func gradientId(for filler: DrawFillGradient) -> String {
+        let stops = filler.colorStops.map { "\(number($0.location)):\(hex($0.color)):\(number(alpha($0.color)))" }
+        let key = stops.joined(separator: ",") + "@" + number(filler.angle)
+        if let id = gradientIds[key] {
+            return id
+        }
+        let id = makeId("g")
+        gradientIds[key] = id
+
+        // NSGradient's angle is measured counter clockwise in unflipped space, while our pages are flipped.
+        let radians = filler.angle * .pi / 180.0
+        let dx = cos(radians) / 2.0
+        let dy = -sin(radians) / 2.0
+        var definition = "<linearGradient id=\"\(id)\" x1=\"\(number(0.5 - dx))\" y1=\"\(number(0.5 - dy))\" x2=\"\(number(0.5 + dx))\" y2=\"\(number(0.5 + dy))\">"
+        for stop in filler.colorStops {
+            definition += "<stop offset=\"\(number(stop.location))\" stop-color=\"\(hex(stop.color))\""
+            if alpha(stop.color) < 1.0 {
+                definition += " stop-opacity=\"\(number(alpha(stop.color)))\""
+            }
+            definition += "/>"
+        }
+        definition += "</linearGradient>\n"
+        pendingDefinitions.append(definition)
+        return id
+    }
+
+    /// Everything that ends up in a `<pattern>`, so two fills only share one when they'd draw the same.
+    internal struct PatternKey : Hashable {
+        var image : ObjectIdentifier
+        var sizing : DrawFillImage.Sizing
+        var scale : CGFloat
+        var width : String
+        var height : String
+    }
+
+    internal func patternId(for filler: DrawFillImage) -> String {
+        let size = NSSize(width: (filler.image?.size.width ?? 0.0) * filler.scale, height: (filler.image?.size.height ?? 0.0) * filler.scale)
+        let width = filler.sizing == .tile ? number(size.width) : "1"
+        let height = filler.sizing == .tile ? number(size.height) : "1"
+        let key = PatternKey(image: ObjectIdentifier(filler.image ?? filler), sizing: filler.sizing, scale: filler.scale, width: width, height: height)
+        if let id = patternIds[key] {
+            return id
+        }
+        let id = makeId("p")
+        patternIds[key] = id
+
+        if let image = filler.image,
+           let tiff = image.tiffRepresentation,
+           let png = NSBitmapImageRep(data: tiff)?.representation(using: .png, properties: [:]) {
+            let units = filler.sizing == .tile ? "userSpaceOnUse" : "objectBoundingBox"
+            let aspect = filler.sizing == .scaleToFit ? "xMidYMid meet" : (filler.sizing == .scaleToFill ? "xMidYMid slice" : "none")
+            var definition = "<pattern id=\"\(id)\" patternUnits=\"\(units)\" width=\"\(width)\" height=\"\(height)\""
+            if filler.sizing != .tile {
+                definition += " patternContentUnits=\"objectBoundingBox\"><image width=\"1\" height=\"1\" preserveAspectRatio=\"\(aspect)\""
+            } else {
+                definition += "><image width=\"\(number(size.width))\" height=\"\(number(size.height))\""
+            }
+            definition += " xlink:href=\"data:image/png;base64,\(png.base64EncodedString())\"/></pattern>\n"
+            pendingDefinitions.append(definition)
+        } else {
+            pendingDefinitions.append("<pattern id=\"\(id)\" width=\"0\" height=\"0\"/>\n")
+        }
+        return id
+    }
+
+    internal func filterId(for shadow: DrawShadow) -> String {
+        let key = "\(hex(shadow.color)):\(number(alpha(shadow.color))):\(number(shadow.offset.width)),\(number(shadow.offset.height)):\(number(shadow.blurRadius))"
+        if let id = filterIds[key] {
+            return id
+        }
+        let id = makeId("f")
+        filterIds[key] = id
+        // AppKit shadow offsets ignore the view's flip, so positive height is always "up".
+        pendingDefinitions.append("<filter id=\"\(id)\" x=\"-50%\" y=\"-50%\" width=\"200%\" height=\"200%\">"
+                                  + "<feGaussianBlur in=\"SourceAlpha\" stdDeviation=\"\(number(shadow.blurRadius / 2.0))\"/>"
+                                  + "<feOffset dx=\"\(number(shadow.offset.width))\" dy=\"\(number(-shadow.offset.height))\" result=\"b\"/>"
+                                  + "<feFlood flood-color=\"\(hex(shadow.color))\" flood-opacity=\"\(number(alpha(shadow.color)))\"/>"
+                                  + "<feComposite in2=\"b\" operator=\"in\"/>"
+                                  + "<feMerge><feMergeNode/><feMergeNode in=\"SourceGraphic\"/></feMerge></filter>\n")
+        return id
+    }
+
+    // MARK: - Paths
+
+    internal func svgPathData(for path: AJRBezierPath) -> String {
+        var data = ""
+        var points = [NSPoint](repeating: .zero, count: 3)
+        data.reserveCapacity(path.elementCount * 16)
+        for index in 0 ..< path.elementCount {
+            switch path.element(at: index, associatedPoints: &points) {
+            case .moveTo:
+                data.append("M"); appendPoint(points[0], to: &data)
+            case .lineTo:
+                data.append("L"); appendPoint(points[0], to: &data)
+            case .cubicCurveTo:
+                data.append("C"); appendPoint(points[0], to: &data)
+                data.append(" "); appendPoint(points[1], to: &data)
+                data.append(" "); appendPoint(points[2], to: &data)
+            case .close:
+                data.append("Z")
+            default:
+                break
+            }
+        }
+        return data
+    }
+
+    internal func appendPoint(_ point: NSPoint, to string: inout String) {
+        string.append(number(point.x))
+        string.append(",")
+        string.append(number(point.y))
+    }
+
+    // MARK: - Formatting
+
+    /// Formats to at most two decimal places without trailing zeros. This is hot, so we avoid String(format:).
+    internal func number(_ value: CGFloat) -> String {
+        let hundredths = Int((value * 100.0).rounded())
+        if hundredths % 100 == 0 {
+            return String(hundredths / 100)
+        }
+        let sign = hundredths < 0 ? "-" : ""
+        let magnitude = abs(hundredths)
+        let fraction = magnitude % 100
+        return sign + String(magnitude / 100) + (fraction % 10 == 0 ? "." + String(fraction / 10) : (fraction < 10 ? ".0" : ".") + String(fraction))
+    }
+
+    internal func append(_ value: CGFloat) {
+        buffer.append(number(value))
+    }
+
+    internal func rgb(_ color: NSColor) -> NSColor {
+        return color.usingColorSpace(.sRGB) ?? NSColor.black
+    }
+
+    internal func alpha(_ color: NSColor) -> CGFloat {
+        return rgb(color).alphaComponent
+    }
+
+    internal func hex(_ color: NSColor) -> String {
+        let color = rgb(color)
+        let r = Int((color.redComponent * 255.0).rounded())
+        let g = Int((color.greenComponent * 255.0).rounded())
+        let b = Int((color.blueComponent * 255.0).rounded())
+        let value = (max(0, min(255, r)) << 16) | (max(0, min(255, g)) << 8) | max(0, min(255, b))
+        let digits = String(value, radix: 16)
+        return "#" + String(repeating: "0", count: 6 - digits.count) + digits
+    }
+
+    internal func paint(_ property: String, _ color: NSColor) -> String {
+        let opacity = alpha(color)
+        if opacity <= 0.0 {
+            return "\(property):none"
+        }
+        var result = "\(property):\(hex(color))"
+        if opacity < 1.0 {
+            result += ";\(property)-opacity:\(number(opacity))"
+        }
+        return result
+    }
+
+    internal func escape(_ string: String) -> String {
+        var result = ""
+        result.reserveCapacity(string.utf8.count)
+        for character in string {
+            switch character {
+            case "&": result.append("&amp;")
+            case "<": result.append("&lt;")
+            case ">": result.append("&gt;")
+            case "\"": result.append("&quot;")
+            case "'": result.append("&apos;")
+            default: result.append(character)
+            }
+        }
+        return result
+    }
+
+    /// Escapes `string` for use inside a single quoted CSS string. Style rules end up in a `<style>` element, where XML entities would be read as part of the CSS, so characters that matter to XML are written as CSS escapes instead.
+    internal func cssEscape(_ string: String) -> String {
+        var result = ""
+        result.reserveCapacity(string.utf8.count)
+        for character in string {
+            switch character {
+            case "\\": result.append("\\\\")
+            case "'": result.append("\\'")
+            case "\"": result.append("\\22 ")
+            case "&": result.append("\\26 ")
+            case "<": result.append("\\3C ")
+            case ">": result.append("\\3E ")
+            case "\n", "\r": result.append("\\A ")
+            default: result.append(character)
+            }
+        }
+        return result
+    }
+
+    // MARK: - Output
+
+    open func flush() throws {
+        if !buffer.isEmpty {
+            try fileHandle.write(contentsOf: Data(buffer.utf8))
+            buffer.removeAll(keepingCapacity: true)
+        }
+    }
+
+}
@@ -0,0 +1,157 @@
+/*
+ DrawSpatialIndex.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import Foundation
+
+/**
+ A uniform grid over rectangles, for finding the objects near a point or rect without looking at every object on the page.
+
+ Each object is filed under every cell its rect touches. Moving an object only touches the cells it left and entered, and a query only looks at the cells under the query rect, so both cost about the same however many objects are indexed, as long as objects are small relative to the page. Objects much larger than a cell are filed in many cells, which is fine for the shapes and corridors this is used for.
+
+ The index keeps a strong reference to each object until it's removed, but never messages it. It's up to the owner to remove objects that go away, or they'll be kept alive.
+ */
+public final class DrawSpatialIndex<Element: AnyObject> {
+
+    internal struct Cell : Hashable {
+        var x : Int
+        var y : Int
+    }
+
+    /// The width and height of a grid cell, in page units.
+    public let cellSize : CGFloat
+
+    private var rects = [ObjectIdentifier:(element: Element, rect: NSRect)]()
+    private var cells = [Cell:[ObjectIdentifier]]()
+
+    public init(cellSize: CGFloat = 128.0) {
+        self.cellSize = max(cellSize, 1.0)
+    }
+
+    // MARK: - Properties
+
+    public var count : Int {
+        return rects.count
+    }
+
+    /// The number of cells with anything filed in them. Empty cells are dropped, so this stays proportional to what's indexed rather than to everywhere objects have been.
+    internal var occupiedCellCount : Int {
+        return cells.count
+    }
+
+    /// The rect `element` was last filed under, or `nil` if it isn't in the index.
+    public func rect(for element: Element) -> NSRect? {
+        return rects[ObjectIdentifier(element)]?.rect
+    }
+
+    // MARK: - Updating
+
+    /// Adds `element`, or moves it if it's already indexed.
+    public func insert(_ element: Element, rect: NSRect) {
+        let key = ObjectIdentifier(element)
+        if let old = rects[key] {
+            if old.rect == rect {
+                return
+            }
+            let oldCells = cellRange(for: old.rect)
+            let newCells = cellRange(for: rect)
+            rects[key] = (element, rect)
+            if oldCells == newCells {
+                return
+            }
+            forEachCell(in: oldCells) { cell in
+                remove(key, from: cell)
+            }
+            forEachCell(in: newCells) { cell in
+                cells[cell, default: []].append(key)
+            }
+        } else {
+            rects[key] = (element, rect)
+            forEachCell(in: cellRange(for: rect)) { cell in
+                cells[cell, default: []].append(key)
+            }
+        }
+    }
+
+    public func remove(_ element: Element) {
+        let key = ObjectIdentifier(element)
+        if let old = rects.removeValue(forKey: key) {
+            forEachCell(in: cellRange(for: old.rect)) { cell in
+                remove(key, from: cell)
+            }
+        }
+    }
+
+    public func removeAll() {
+        rects.removeAll()
+        cells.removeAll()
+    }
+
+    // MARK: - Queries
+
+    /// Returns the elements whose rects intersect `rect`, each once.
+    public func elements(intersecting rect: NSRect) -> [Element] {
+        var found = [Element]()
+        var seen = Set<ObjectIdentifier>()
+        forEachCell(in: cellRange(for: rect)) { cell in
+            for key in cells[cell] ?? [] where !seen.contains(key) {
+                seen.insert(key)
+                if let entry = rects[key], entry.rect.intersects(rect) || (entry.rect.isEmpty && rect.contains(entry.rect.origin)) {
+                    found.append(entry.element)
+                }
+            }
+        }
+        return found
+    }
+
+    // MARK: - Cells
+
+    internal func cellRange(for rect: NSRect) -> (min: Cell, max: Cell) {
+        let rect = rect.standardized
+        return (Cell(x: Int((rect.minX / cellSize).rounded(.down)), y: Int((rect.minY / cellSize).rounded(.down))),
+                Cell(x: Int((rect.maxX / cellSize).rounded(.down)), y: Int((rect.maxY / cellSize).rounded(.down))))
+    }
+
+    private func remove(_ key: ObjectIdentifier, from cell: Cell) {
+        cells[cell]?.removeAll { $0 == key }
+        if cells[cell]?.isEmpty == true {
+            cells[cell] = nil
+        }
+    }
+
+    private func forEachCell(in range: (min: Cell, max: Cell), _ body: (Cell) -> Void) {
+        for y in range.min.y ... range.max.y {
+            for x in range.min.x ... range.max.x {
+                body(Cell(x: x, y: y))
+            }
+        }
+    }
+
+}
@@ -0,0 +1,368 @@
+/*
+ DrawFlattenedPath.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ An immutable, flattened copy of a path, used for hit testing.
+
+ The original hit tests worked by configuring the graphic's shared `AJRBezierPath` (line width, flatness, winding rule) and asking it, which meant installing a graphics context and mutating the path on every click. A flattened path is built once, from a snapshot of the path's elements, and then only answers geometric questions. It never touches a graphics context or the source path again, so any number of threads may query it at once.
+
+ Each segment carries its own bounding box, so most segments are rejected with four comparisons before any distance is computed. Paths with more than a handful of segments also get a `DrawSegmentHierarchy`, so point and rect queries only visit the segments near them.
+ */
+@objcMembers
+open class DrawFlattenedPath : NSObject {
+
+    internal struct Segment {
+        var start : NSPoint
+        var end : NSPoint
+        var minX : CGFloat
+        var minY : CGFloat
+        var maxX : CGFloat
+        var maxY : CGFloat
+
+        init(_ start: NSPoint, _ end: NSPoint) {
+            self.start = start
+            self.end = end
+            minX = min(start.x, end.x)
+            minY = min(start.y, end.y)
+            maxX = max(start.x, end.x)
+            maxY = max(start.y, end.y)
+        }
+
+        @inline(__always)
+        func boundsIntersect(minX: CGFloat, minY: CGFloat, maxX: CGFloat, maxY: CGFloat) -> Bool {
+            return self.minX <= maxX && self.maxX >= minX && self.minY <= maxY && self.maxY >= minY
+        }
+    }
+
+    /// The flatness the curves were flattened to, in the path's units.
+    public let flatness : CGFloat
+    /// The number of elements in the source path when it was flattened. Used as a cheap check that a cached copy is still current.
+    public let elementCount : Int
+    /// The bounds of the flattened segments.
+    public let bounds : NSRect
+
+    internal let segments : [Segment]
+    /// The segments that close open subpaths. Fills treat every subpath as closed, but strokes don't, so these only take part in fill tests.
+    internal let closingSegments : [Segment]
+    internal let hierarchy : DrawSegmentHierarchy?
+
+    // MARK: - Creation
+
+    /**
+     Flattens `path`. Curves are split into line segments until they deviate from the true curve by no more than `flatness`.
+
+     This reads the path's elements, so call it from the thread that owns the path. The result can then be used from anywhere.
+     */
+    public init(path: AJRBezierPath, flatness: CGFloat) {
+        var segments = [Segment]()
+        var closingSegments = [Segment]()
+        var points = [NSPoint](repeating: .zero, count: 3)
+        var current = NSPoint.zero
+        var subpathStart = NSPoint.zero
+        var subpathIsOpen = false
+        let elementCount = path.elementCount
+        let flatness = max(flatness, 0.01)
+
+        func closeSubpath() {
+            if subpathIsOpen && current != subpathStart {
+                closingSegments.append(Segment(current, subpathStart))
+            }
+            subpathIsOpen = false
+        }
+
+        segments.reserveCapacity(elementCount)
+        for index in 0 ..< elementCount {
+            switch path.element(at: index, associatedPoints: &points) {
+            case .moveTo:
+                closeSubpath()
+                current = points[0]
+                subpathStart = current
+                subpathIsOpen = true
+            case .lineTo:
+                segments.append(Segment(current, points[0]))
+                current = points[0]
+                subpathIsOpen = true
+            case .cubicCurveTo:
+                DrawFlattenedPath.flattenCurve(from: current, points[0], points[1], points[2], flatness: flatness, into: &segments)
+                current = points[2]
+                subpathIsOpen = true
+            case .close:
+                if current != subpathStart {
+                    segments.append(Segment(current, subpathStart))
+                }
+                current = subpathStart
+                subpathIsOpen = false
+            default:
+                break
+            }
+        }
+        closeSubpath()
+
+        var bounds = NSRect.zero
+        if let first = segments.first ?? closingSegments.first {
+            var minX = first.minX, minY = first.minY, maxX = first.maxX, maxY = first.maxY
+            for segment in segments {
+                minX = min(minX, segment.minX); minY = min(minY, segment.minY)
+                maxX = max(maxX, segment.maxX); maxY = max(maxY, segment.maxY)
+            }
+            bounds = NSRect(x: minX, y: minY, width: maxX - minX, height: maxY - minY)
+        }
+
+        self.flatness = flatness
+        self.elementCount = elementCount
+        self.segments = segments
+        self.closingSegments = closingSegments
+        self.bounds = bounds
+        self.hierarchy = segments.count > 2 * DrawSegmentHierarchy.leafSize ? DrawSegmentHierarchy(segments: segments) : nil
+    }
+
+    /// Splits a cubic into uniform steps. The step count comes from the curve's second differences, which bound how far a chord can stray from the curve.
+    internal class func flattenCurve(from p0: NSPoint, _ p1: NSPoint, _ p2: NSPoint, _ p3: NSPoint, flatness: CGFloat, into segments: inout [Segment]) {
+        let ddx = max(abs(p0.x - 2.0 * p1.x + p2.x), abs(p1.x - 2.0 * p2.x + p3.x))
+        let ddy = max(abs(p0.y - 2.0 * p1.y + p2.y), abs(p1.y - 2.0 * p2.y + p3.y))
+        let deviation = (ddx * ddx + ddy * ddy).squareRoot()
+        let steps = max(1, min(1024, Int((0.75 * deviation / flatness).squareRoot().rounded(.up))))
+        var previous = p0
+
+        for step in 1 ... steps {
+            let t = CGFloat(step) / CGFloat(steps)
+            let mt = 1.0 - t
+            let a = mt * mt * mt
+            let b = 3.0 * mt * mt * t
+            let c = 3.0 * mt * t * t
+            let d = t * t * t
+            let point = step == steps ? p3 : NSPoint(x: a * p0.x + b * p1.x + c * p2.x + d * p3.x,
+                                                     y: a * p0.y + b * p1.y + c * p2.y + d * p3.y)
+            segments.append(Segment(previous, point))
+            previous = point
+        }
+    }
+
+    // MARK: - Decimation
+
+    /**
+     Returns a path of straight lines that follows the flattened outline, dropping any point that lies within `tolerance` of the last point kept. Subpaths that end where they started are closed.
+
+     This is for drawing a long path at a size where detail finer than `tolerance` can't be seen, such as at a low zoom.
+     */
+    @objc(decimatedPathWithTolerance:)
+    open func decimatedPath(tolerance: CGFloat) -> AJRBezierPath {
+        let path = AJRBezierPath()
+        let toleranceSquared = tolerance * tolerance
+        var subpathStart = NSPoint.zero
+        var lastKept = NSPoint.zero
+        var lastEnd : NSPoint? = nil
+
+        func finishSubpath() {
+            if let lastEnd {
+                if lastEnd != lastKept {
+                    path.line(to: lastEnd)
+                }
+                if lastEnd == subpathStart {
+                    path.close()
+                }
+            }
+        }
+
+        for segment in segments {
+            if segment.start != lastEnd {
+                finishSubpath()
+                path.move(to: segment.start)
+                subpathStart = segment.start
+                lastKept = segment.start
+            }
+            let dx = segment.end.x - lastKept.x
+            let dy = segment.end.y - lastKept.y
+            if dx * dx + dy * dy >= toleranceSquared {
+                path.line(to: segment.end)
+                lastKept = segment.end
+            }
+            lastEnd = segment.end
+        }
+        finishSubpath()
+
+        return path
+    }
+
+    // MARK: - Hit Testing
+
+    /// Returns true if `point` lies within `width / 2` of the path's outline, as if the path were stroked at `width` with round caps and joins.
+    @objc(isStrokeHitByPoint:width:)
+    open func isStrokeHit(by point: NSPoint, width: CGFloat) -> Bool {
+        let radius = max(width, 0.0) / 2.0
+        if !bounds.insetBy(dx: -radius, dy: -radius).contains(point) {
+            return false
+        }
+        let radiusSquared = radius * radius
+        return forEachSegment(overlappingMinX: point.x - radius, minY: point.y - radius, maxX: point.x + radius, maxY: point.y + radius) { segment in
+            return DrawFlattenedPath.distanceSquared(from: point, to: segment) <= radiusSquared
+        }
+    }
+
+    /// Returns true if any part of the path, stroked at `width`, falls inside `rect`.
+    @objc(isStrokeHitByRect:width:)
+    open func isStrokeHit(by rect: NSRect, width: CGFloat) -> Bool {
+        let radius = max(width, 0.0) / 2.0
+        let rect = rect.insetBy(dx: -radius, dy: -radius)
+        if !boundsOverlap(rect) {
+            return false
+        }
+        return forEachSegment(overlappingMinX: rect.minX, minY: rect.minY, maxX: rect.maxX, maxY: rect.maxY) { segment in
+            return DrawFlattenedPath.segment(segment, intersects: rect)
+        }
+    }
+
+    /// Returns true if `point` is inside the filled path, treating open subpaths as closed.
+    @objc(containsPoint:evenOdd:)
+    open func contains(_ point: NSPoint, evenOdd: Bool) -> Bool {
+        if !bounds.contains(point) {
+            return false
+        }
+        var winding = DrawFlattenedPath.winding(of: point, in: closingSegments)
+        // Only segments to the right of the point, spanning its y, can cross the ray.
+        forEachSegment(overlappingMinX: point.x, minY: point.y, maxX: CGFloat.greatestFiniteMagnitude, maxY: point.y) { segment in
+            winding += DrawFlattenedPath.winding(of: point, by: segment)
+            return false
+        }
+        return evenOdd ? winding % 2 != 0 : winding != 0
+    }
+
+    /// Returns true if the filled path and `rect` overlap at all.
+    @objc(intersectsRect:evenOdd:)
+    open func intersects(_ rect: NSRect, evenOdd: Bool) -> Bool {
+        if !boundsOverlap(rect) {
+            return false
+        }
+        if isStrokeHit(by: rect, width: 0.0) {
+            return true
+        }
+        for segment in closingSegments where DrawFlattenedPath.segment(segment, intersects: rect) {
+            return true
+        }
+        // No edge crosses the rect, so either the rect is entirely inside the fill or entirely outside it.
+        return contains(NSPoint(x: rect.midX, y: rect.midY), evenOdd: evenOdd)
+    }
+
+    // MARK: - Geometry
+
+    /// Unlike `NSRect.intersects(_:)`, this is true for a horizontal or vertical path, whose bounds have no area.
+    @inline(__always)
+    internal func boundsOverlap(_ rect: NSRect) -> Bool {
+        return bounds.minX <= rect.maxX && bounds.maxX >= rect.minX && bounds.minY <= rect.maxY && bounds.maxY >= rect.minY
+    }
+
+    @inline(__always)
+    internal class func distanceSquared(from point: NSPoint, to segment: Segment) -> CGFloat {
+        let dx = segment.end.x - segment.start.x
+        let dy = segment.end.y - segment.start.y
+        let px = point.x - segment.start.x
+        let py = point.y - segment.start.y
+        let lengthSquared = dx * dx + dy * dy
+        let t = lengthSquared == 0.0 ? 0.0 : max(0.0, min(1.0, (px * dx + py * dy) / lengthSquared))
+        let ex = px - t * dx
+        let ey = py - t * dy
+        return ex * ex + ey * ey
+    }
+
+    /// Liang–Barsky clipping, reduced to a yes/no answer.
+    internal class func segment(_ segment: Segment, intersects rect: NSRect) -> Bool {
+        let dx = segment.end.x - segment.start.x
+        let dy = segment.end.y - segment.start.y
+        var t0 : CGFloat = 0.0
+        var t1 : CGFloat = 1.0
+        let checks : [(CGFloat, CGFloat)] = [(-dx, segment.start.x - rect.minX),
+                                              (dx, rect.maxX - segment.start.x),
+                                              (-dy, segment.start.y - rect.minY),
+                                              (dy, rect.maxY - segment.start.y)]
+        for (p, q) in checks {
+            if p == 0.0 {
+                if q < 0.0 {
+                    return false
+                }
+            } else {
+                let r = q / p
+                if p < 0.0 {
+                    if r > t1 { return false }
+                    t0 = max(t0, r)
+                } else {
+                    if r < t0 { return false }
+                    t1 = min(t1, r)
+                }
+            }
+        }
+        return true
+    }
+
+    /// The winding number contribution of `segments` around `point`.
+    internal class func winding(of point: NSPoint, in segments: [Segment]) -> Int {
+        var winding = 0
+        for segment in segments where segment.maxX >= point.x && segment.minY <= point.y && segment.maxY >= point.y {
+            winding += self.winding(of: point, by: segment)
+        }
+        return winding
+    }
+
+    /// The winding number contribution of one segment around `point`, by the usual upward/downward crossing rule.
+    @inline(__always)
+    internal class func winding(of point: NSPoint, by segment: Segment) -> Int {
+        let a = segment.start
+        let b = segment.end
+        let side = (b.x - a.x) * (point.y - a.y) - (point.x - a.x) * (b.y - a.y)
+        if a.y <= point.y {
+            if b.y > point.y && side > 0.0 {
+                return 1
+            }
+        } else if b.y <= point.y && side < 0.0 {
+            return -1
+        }
+        return 0
+    }
+
+    /// Calls `body` with every segment whose bounds overlap the box, stopping as soon as it returns `true`. Goes through the hierarchy when there is one.
+    @discardableResult
+    internal func forEachSegment(overlappingMinX minX: CGFloat, minY: CGFloat, maxX: CGFloat, maxY: CGFloat, _ body: (Segment) -> Bool) -> Bool {
+        if let hierarchy {
+            return hierarchy.forEachSegment(overlappingMinX: minX, minY: minY, maxX: maxX, maxY: maxY) { index in
+                let segment = segments[index]
+                return segment.boundsIntersect(minX: minX, minY: minY, maxX: maxX, maxY: maxY) && body(segment)
+            }
+        }
+        for segment in segments where segment.boundsIntersect(minX: minX, minY: minY, maxX: maxX, maxY: maxY) {
+            if body(segment) {
+                return true
+            }
+        }
+        return false
+    }
+
+}
@@ -35,9 +35,91 @@
 #import "DrawDocument.h"
 
 #import <AJRInterfaceFoundation/AJRInterfaceFoundation.h>
+#import <Draw/Draw-Swift.h>
+
+// Groups with fewer subgraphics than this just scan them all.
+static const NSUInteger DrawSubgraphicHierarchyMinimumCount = 32;
+
+// The rects a group sizes itself to for a subgraphic. Leaf graphics are grown by inset, groups are used as is.
+static void DrawGetSubgraphicRects(DrawGraphic *subgraphic, CGFloat inset, NSRect *frame, NSRect *bounds) {
+    if ([[subgraphic subgraphics] count]) {
+        *frame = [subgraphic frame];
+        *bounds = [subgraphic bounds];
+    } else {
+        *frame = NSInsetRect([subgraphic frame], inset, inset);
+        *bounds = NSInsetRect([subgraphic bounds], inset, inset);
+    }
+}
+
+@interface DrawGraphic (Private)
+
+- (BOOL)_translateDeferringPathByX:(CGFloat)deltaX y:(CGFloat)deltaY;
+
+@end
 
 @implementation DrawGraphic (Subgraphics)
 
+#pragma mark - Hierarchy
+
+- (CGFloat)_subgraphicInset {
+    return self.document ? -[self.document gridSpacing] : 0.0;
+}
+
+- (DrawSubgraphicHierarchy *)_subgraphicHierarchy {
+    if ([_subgraphics count] < DrawSubgraphicHierarchyMinimumCount) {
+        _subgraphicHierarchy = nil;
+    } else {
+        CGFloat inset = [self _subgraphicInset];
+        if (_subgraphicHierarchy == nil || _subgraphicHierarchy.inset != inset || _subgraphicHierarchy.count != [_subgraphics count]) {
+            _subgraphicHierarchy = [[DrawSubgraphicHierarchy alloc] initWithInset:inset];
+            for (DrawGraphic *subgraphic in _subgraphics) {
+                NSRect frame, bounds;
+                DrawGetSubgraphicRects(subgraphic, inset, &frame, &bounds);
+                [_subgraphicHierarchy appendGraphic:subgraphic frame:frame bounds:bounds];
+            }
+        }
+    }
+    return _subgraphicHierarchy;
+}
+
+/*!
+ Adds subgraphic to an existing hierarchy at its place in _subgraphics. If there's no hierarchy yet, we leave it to be built the next time it's needed.
+ */
+- (void)_insertSubgraphicIntoHierarchy:(DrawGraphic *)subgraphic {
+    if (_subgraphicHierarchy != nil) {
+        NSUInteger index = [_subgraphics indexOfObjectIdenticalTo:subgraphic];
+        NSUInteger count = [_subgraphics count];
+        NSRect frame, bounds;
+
+        DrawGetSubgraphicRects(subgraphic, _subgraphicHierarchy.inset, &frame, &bounds);
+        [_subgraphicHierarchy insertGraphic:subgraphic
+                                      frame:frame
+                                     bounds:bounds
+                                    between:index > 0 ? _subgraphics[index - 1] : nil
+                                        and:index + 1 < count ? _subgraphics[index + 1] : nil];
+    }
+}
+
+- (void)_subgraphicWasRemoved:(DrawGraphic *)subgraphic {
+    [_subgraphicHierarchy removeGraphic:subgraphic];
+    [self noteContentDidChange];
+}
+
+- (void)subgraphicDidChangeBounds:(DrawGraphic *)subgraphic {
+    if (_subgraphicHierarchy != nil) {
+        NSRect frame, bounds;
+        DrawGetSubgraphicRects(subgraphic, _subgraphicHierarchy.inset, &frame, &bounds);
+        [_subgraphicHierarchy updateGraphic:subgraphic frame:frame bounds:bounds];
+    }
+}
+
+- (NSArray<DrawGraphic *> *)subgraphicsIntersectingRect:(NSRect)rect {
+    DrawSubgraphicHierarchy *hierarchy = [self _subgraphicHierarchy];
+    return hierarchy ? [hierarchy graphicsIntersectingRect:rect] : _subgraphics;
+}
+
+#pragma mark - Subgraphics
+
 - (void)_adjustFrameAndBoundsForSubgraphic:(DrawGraphic *)subgraphic {
     CGFloat inset;
 
@@ -85,6 +167,7 @@
         [subgraphic graphicWillMoveToSupergraphic:self];
         [_subgraphics addObject:subgraphic];
         subgraphic->_supergraphic = self;
+        [self _insertSubgraphicIntoHierarchy:subgraphic];
         if (!self.editing) {
             [self _adjustFrameAndBoundsForSubgraphic:subgraphic];
         }
@@ -103,10 +186,16 @@
             [NSException raise:NSInvalidArgumentException format:@"Cannot place a subgraphic with place %d\n", (int)place];
         }
         subgraphic->_supergraphic = self;
+        [self _insertSubgraphicIntoHierarchy:subgraphic];
         if (!self.editing) {
             [self _adjustFrameAndBoundsForSubgraphic:subgraphic];
         }
     }
+    [self noteContentDidChange];
+    if ([_subgraphics count] == 1) {
+        // We've just become a group.
+        [self.document selectionSummaryGraphicDidChange:self];
+    }
 
     [subgraphic setPage:self.page];
     [subgraphic setDocument:self.document];
@@ -128,6 +217,9 @@
     [_subgraphics replaceObjectAtIndex:index withObject:newGraphic];
     oldGraphic->_supergraphic = nil;
     newGraphic->_supergraphic = self;
+    [_subgraphicHierarchy removeGraphic:oldGraphic];
+    [self _insertSubgraphicIntoHierarchy:newGraphic];
+    [self noteContentDidChange];
     if (!self.editing) {
         [_supergraphic sizeToFit];
     }
@@ -177,6 +269,11 @@
     index = [superSubgraphics indexOfObjectIdenticalTo:self];
     if (index != NSNotFound) {
         [superSubgraphics removeObjectAtIndex:index];
+        [_supergraphic _subgraphicWasRemoved:self];
+        if ([superSubgraphics count] == 0) {
+            // And it's no longer a group.
+            [_supergraphic.document selectionSummaryGraphicDidChange:_supergraphic];
+        }
         if (![_supergraphic editing]) {
             [_supergraphic sizeToFit];
         }
@@ -191,32 +288,42 @@
 
 - (void)sortSubgraphicsUsingFunction:(NSInteger (*)(id, id, void *))compare context:(void *)context {
     [_subgraphics sortUsingFunction:compare context:context];
+    // Cheaper to rebuild than to reorder.
+    _subgraphicHierarchy = nil;
+    [self noteContentDidChange];
 }
 
 - (void)sizeToFit {
     NSInteger x;
     DrawGraphic *subgraphic;
     CGFloat inset = -[self.document gridSpacing];
+    DrawSubgraphicHierarchy *hierarchy = [self _subgraphicHierarchy];
 
     NSRect frame, bounds;
-    for (x = 0; x < (const NSInteger)[_subgraphics count]; x++) {
-        subgraphic = [_subgraphics objectAtIndex:x];
-
-        if (x == 0) {
-            if ([[subgraphic subgraphics] count]) {
-                frame = subgraphic.frame;
-                bounds = subgraphic.bounds;
-            } else {
-                frame = NSInsetRect(subgraphic.frame, inset, inset);
-                bounds = NSInsetRect(subgraphic.bounds, inset, inset);
-            }
-        } else {
-            if (subgraphic.subgraphics.count != 0) {
-                bounds = NSUnionRect(bounds, subgraphic.bounds);
-                frame = NSUnionRect(frame, subgraphic.frame);
+    if (hierarchy) {
+        // The root already holds the unions.
+        frame = hierarchy.frame;
+        bounds = hierarchy.bounds;
+    } else {
+        for (x = 0; x < (const NSInteger)[_subgraphics count]; x++) {
+            subgraphic = [_subgraphics objectAtIndex:x];
+
+            if (x == 0) {
+                if ([[subgraphic subgraphics] count]) {
+                    frame = subgraphic.frame;
+                    bounds = subgraphic.bounds;
+                } else {
+                    frame = NSInsetRect(subgraphic.frame, inset, inset);
+                    bounds = NSInsetRect(subgraphic.bounds, inset, inset);
+                }
             } else {
-                bounds = NSUnionRect(bounds, NSInsetRect(subgraphic.bounds, inset, inset));
-                frame = NSUnionRect(frame, NSInsetRect(subgraphic.frame, inset, inset));
+                if (subgraphic.subgraphics.count != 0) {
+                    bounds = NSUnionRect(bounds, subgraphic.bounds);
+                    frame = NSUnionRect(frame, subgraphic.frame);
+                } else {
+                    bounds = NSUnionRect(bounds, NSInsetRect(subgraphic.bounds, inset, inset));
+                    frame = NSUnionRect(frame, NSInsetRect(subgraphic.frame, inset, inset));
+                }
             }
         }
     }
@@ -242,41 +349,82 @@
     return _autosizeSubgraphics;
 }
 
-- (void)_resizeSubgraphicsFromRect:(NSRect)oldFrame toRect:(NSRect)newFrame {
-    NSInteger	x;
-    DrawGraphic	*graphic;
-    NSRect		graphicFrame;
-    NSRect		deltaRect;
+// Subgraphics that inherit DrawGraphic's -setFrame: can be transformed directly. Others may keep geometry of their own in step with their frame, so they still go through -setFrame:.
+static BOOL DrawGraphicCanTransformInBulk(DrawGraphic *graphic) {
+    static IMP setFrameIMP = NULL;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        setFrameIMP = [DrawGraphic instanceMethodForSelector:@selector(setFrame:)];
+    });
+    return [graphic methodForSelector:@selector(setFrame:)] == setFrameIMP;
+}
 
+/*!
+ Moves and scales the receiver, and its subgraphics if it autosizes them, by transform. This does what -setFrame: does, but without registering undo, posting notifications or invalidating the page, since whoever started the transform does those once for everything.
+ */
+- (void)_applyTransformInBulk:(NSAffineTransform *)transform translating:(BOOL)translating {
+    NSRect frame = self.frame;
+
+    // Moving a large path is just an offset. Only a real scale needs the points rewritten and the bounds rebuilt.
+    if (translating) {
+        NSAffineTransformStruct matrix = [transform transformStruct];
+        if ([self _translateDeferringPathByX:matrix.tX y:matrix.tY]) {
+            return;
+        }
+    }
+
+    [self bakePathTransform];
+    [_path transformUsingAffineTransform:transform];
+    [self setFrameWithoutNotification:AJRNormalizeRect((NSRect){[transform transformPoint:frame.origin], [transform transformSize:frame.size]})];
+
+    if ([_subgraphics count] && !self.editing && _autosizeSubgraphics) {
+        [self _applyTransformInBulk:transform toSubgraphicsTranslating:translating];
+    }
+
+    // This also tells our aspects about the new shape, and marks our flattened path as stale.
+    [self updateBounds];
+}
+
+- (void)_applyTransformInBulk:(NSAffineTransform *)transform toSubgraphicsTranslating:(BOOL)translating {
+    // Every subgraphic is about to move, so don't update the hierarchy one leaf at a time.
+    DrawSubgraphicHierarchy *hierarchy = _subgraphicHierarchy;
+    _subgraphicHierarchy = nil;
+
+    for (DrawGraphic *graphic in _subgraphics) {
+        if (DrawGraphicCanTransformInBulk(graphic)) {
+            [graphic _applyTransformInBulk:transform translating:translating];
+        } else {
+            NSRect frame = [graphic frame];
+            [graphic setFrame:(NSRect){[transform transformPoint:frame.origin], [transform transformSize:frame.size]}];
+        }
+    }
+
+    if (translating) {
+        // A translation moves every rect in the tree the same amount, so the structure still holds.
+        NSAffineTransformStruct matrix = [transform transformStruct];
+        [hierarchy offsetByX:matrix.tX y:matrix.tY];
+        _subgraphicHierarchy = hierarchy;
+    }
+}
+
+- (void)_resizeSubgraphicsFromRect:(NSRect)oldFrame toRect:(NSRect)newFrame {
     if (!NSEqualRects(oldFrame, newFrame)) {
-        if (NSEqualSizes(oldFrame.size, newFrame.size)) {
-
-            deltaRect.origin.x = newFrame.origin.x - oldFrame.origin.x;
-            deltaRect.origin.y = newFrame.origin.y - oldFrame.origin.y;
-            deltaRect.size = (NSSize){1.0, 1.0};
-
-            for (x = 0; x < (const NSInteger)[_subgraphics count]; x++) {
-                graphic = [_subgraphics objectAtIndex:x];
-                graphicFrame = [graphic frame];
-                graphicFrame.origin.x += deltaRect.origin.x;
-                graphicFrame.origin.y += deltaRect.origin.y;
-                [graphic setFrame:graphicFrame];
-            }
+        NSAffineTransform *transform = [NSAffineTransform transform];
+        BOOL translating = NSEqualSizes(oldFrame.size, newFrame.size);
+
+        [transform translateXBy:newFrame.origin.x yBy:newFrame.origin.y];
+        if (!translating) {
+            [transform scaleXBy:newFrame.size.width / oldFrame.size.width yBy:newFrame.size.height / oldFrame.size.height];
+        }
+        [transform translateXBy:-oldFrame.origin.x yBy:-oldFrame.origin.y];
+
+        // Our own -setFrame: has registered undo and invalidated our old and new bounds, and undoing it resizes our subgraphics straight back. That makes it the one undo and invalidation for the whole transform, so the subgraphics don't record their own.
+        if (self.document) {
+            [self.document editWithoutUndoTracking:^{
+                [self _applyTransformInBulk:transform toSubgraphicsTranslating:translating];
+            }];
         } else {
-            deltaRect.origin.x = newFrame.origin.x - oldFrame.origin.x;
-            deltaRect.origin.y = newFrame.origin.y - oldFrame.origin.y;
-            deltaRect.size.width = newFrame.size.width / oldFrame.size.width;
-            deltaRect.size.height = newFrame.size.height / oldFrame.size.height;
-
-            for (x = 0; x < (const NSInteger)[_subgraphics count]; x++) {
-                graphic = [_subgraphics objectAtIndex:x];
-                graphicFrame = [graphic frame];
-                graphicFrame.origin.x = (graphicFrame.origin.x - oldFrame.origin.x) * deltaRect.size.width + newFrame.origin.x;
-                graphicFrame.origin.y = (graphicFrame.origin.y - oldFrame.origin.y) * deltaRect.size.height + newFrame.origin.y;
-                graphicFrame.size.width *= deltaRect.size.width;
-                graphicFrame.size.height *= deltaRect.size.height;
-                [graphic setFrame:graphicFrame];
-            }
+            [self _applyTransformInBulk:transform toSubgraphicsTranslating:translating];
         }
     }
 }
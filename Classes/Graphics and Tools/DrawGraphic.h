@@ -36,13 +36,15 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class DrawAspect, DrawEvent, DrawFill, DrawGraphic, DrawInspectorModule, DrawLayer, DrawPage, DrawStroke, DrawFillColor, DrawShadow, DrawText, DrawDocument, DrawReflection, AJRBezierPath;
+@class DrawAspect, DrawEvent, DrawFill, DrawFlattenedPath, DrawGraphic, DrawSubgraphicHierarchy, DrawInspectorModule, DrawLayer, DrawPage, DrawStroke, DrawFillColor, DrawShadow, DrawText, DrawDocument, DrawReflection, AJRBezierPath;
 
 extern NSString * const DrawGraphicDidInitNotification;
 extern NSString * const DrawGraphicDidChangeFrameNotification;
 extern NSString * const DrawFlatnessKey;
 extern NSString * const DrawShowDirtyBoundsKey;
 extern NSString * const DrawDebugGraphicFramesKey;
+extern NSString * const DrawReducedDetailSizeKey;
+extern NSString * const DrawPlaceholderDetailSizeKey;
 
 // Inspectors
 
@@ -99,6 +101,19 @@ typedef NS_ENUM(NSInteger, DrawAspectPriority) {
 	DrawAspectPriorityLast = DrawAspectPriorityAfterForeground,
 };
 
+/*!
+ How much of a graphic gets drawn. This depends on how large the graphic is on the device, so it changes with the zoom.
+
+ @constant DrawGraphicLevelOfDetailFull Draws everything. Printing and export always use this.
+ @constant DrawGraphicLevelOfDetailReduced Skips the aspects that return NO from -[DrawAspect drawsAtReducedDetail], such as shadows and text, and draws long paths decimated to about a device pixel. Graphics also draw at this level while they're being manipulated, see -[DrawDocument beginInteractiveDrawingOfGraphics:].
+ @constant DrawGraphicLevelOfDetailPlaceholder Fills the graphic's frame with the color of its first colored aspect. Nothing else is drawn, including subgraphics.
+ */
+typedef NS_ENUM(uint8_t, DrawGraphicLevelOfDetail) {
+    DrawGraphicLevelOfDetailFull,
+    DrawGraphicLevelOfDetailReduced,
+    DrawGraphicLevelOfDetailPlaceholder,
+};
+
 typedef void (^DrawGraphicCompletionBlock)(void);
 typedef BOOL (^DrawGraphicAspectFilter)(DrawAspect *aspect, DrawAspectPriority priority);
 
@@ -121,6 +136,7 @@ typedef BOOL (^DrawGraphicAspectFilter)(DrawAspect *aspect, DrawAspectPriority p
     // Subgraphics
     NSMutableArray *_subgraphics;
     DrawGraphic *_supergraphic; // Not retained!
+    DrawSubgraphicHierarchy *_subgraphicHierarchy; // Built lazily, and only for large groups.
 
     BOOL _autosizeSubgraphics;
     BOOL _boundsAreDirty;
@@ -132,6 +148,15 @@ typedef BOOL (^DrawGraphicAspectFilter)(DrawAspect *aspect, DrawAspectPriority p
 + (BOOL)showsDirtyBounds;
 + (void)setShowsDirtyBounds:(BOOL)flag;
 
+#pragma mark - Level of Detail
+
+/*! Graphics whose frame is smaller than this, in device pixels along its longer side, draw at DrawGraphicLevelOfDetailReduced. Defaults to DrawReducedDetailSizeKey, 12.0 unless set. 0.0 disables reduced drawing. */
++ (CGFloat)reducedDetailSize;
++ (void)setReducedDetailSize:(CGFloat)size;
+/*! Graphics whose frame is smaller than this, in device pixels along its longer side, draw at DrawGraphicLevelOfDetailPlaceholder. Defaults to DrawPlaceholderDetailSizeKey, 3.0 unless set. 0.0 disables placeholders. */
++ (CGFloat)placeholderDetailSize;
++ (void)setPlaceholderDetailSize:(CGFloat)size;
+
 #pragma mark - Handles
 
 + (NSImage *)handleImage;
@@ -184,7 +209,10 @@ typedef BOOL (^DrawGraphicAspectFilter)(DrawAspect *aspect, DrawAspectPriority p
 
 #pragma mark - Drawing
 
+/*! The receiver's path. Large graphics that are only moved don't rewrite their path's points on every move, so reading this applies any moves still pending. Subclasses that work on _path directly should call -bakePathTransform first. */
 @property (nonatomic,strong) AJRBezierPath *path;
+/*! Applies any moves that haven't been applied to the path's points yet. */
+- (void)bakePathTransform;
 /*! Normally returns NO, but graphics may return YES if the path is unique. For example, a circle or rectangle doesn't need to encode it's path, because the path is easily reconstructed, but a pen does, because the path is unique to each graphic. */
 @property (nonatomic,readonly) BOOL shouldEncodePath;
 
@@ -194,8 +222,14 @@ typedef BOOL (^DrawGraphicAspectFilter)(DrawAspect *aspect, DrawAspectPriority p
 - (BOOL)drawAspectsWithPriority:(DrawAspectPriority)priority path:(AJRBezierPath *)path aspectFilter:(DrawGraphicAspectFilter)filter completionBlocks:(NSMutableArray *)drawingCompletionBlocks;
 - (void)draw;
 - (void)drawWithAspectFilter:(nullable DrawGraphicAspectFilter)filter;
+/*! Returns the level of detail the receiver will draw at in context. This is always DrawGraphicLevelOfDetailFull when printing, exporting, drawing to a non-screen context, or while the receiver is being edited but not manipulated. */
+- (DrawGraphicLevelOfDetail)levelOfDetailInContext:(NSGraphicsContext *)context;
+/*! The level of detail the receiver is drawing at. This is only meaningful while it draws, so aspects can use it to pick a cheaper rendering. Otherwise it's DrawGraphicLevelOfDetailFull. */
+@property (nonatomic,readonly) DrawGraphicLevelOfDetail drawingLevelOfDetail;
 
 - (void)setNeedsDisplay;
+/*! Tells the receiver and its supergraphics that what it draws has changed, so any cached rendering of it is stale. This is called for you by -setNeedsDisplay and whenever the receiver's bounds change. */
+- (void)noteContentDidChange;
 
 #pragma mark - Event Handling
 
@@ -211,6 +245,8 @@ typedef BOOL (^DrawGraphicAspectFilter)(DrawAspect *aspect, DrawAspectPriority p
 @property (nonatomic,assign) BOOL editing;
 - (BOOL)beginAspectEditingFromEvent:(DrawEvent *)event;
 - (void)informAspectsOfShapeChange;
+/*! Tells the aspects and related graphics about a shape change right away. You normally call -informAspectsOfShapeChange instead, which batches this until the end of the event loop. */
+- (void)informAspectsOfShapeChangeNow;
 - (NSRect)boundsForAspect:(DrawAspect *)aspect withPriority:(DrawAspectPriority)priority;
 /*!
  Not generally called by anything other than a draw graphic, but is provided as an override point for subclasses that need more complex bounds computations than the default.
@@ -238,8 +274,15 @@ typedef BOOL (^DrawGraphicAspectFilter)(DrawAspect *aspect, DrawAspectPriority p
 - (BOOL)hasAspectOfType:(Class)aspectType;
 - (BOOL)hasAspectOfType:(Class)aspectType withPriority:(DrawAspectPriority)priority;
 
+/*! A shared, untransformed context for hit tests that still go through AppKit drawing. */
++ (NSGraphicsContext *)hitContext;
 - (NSGraphicsContext *)hitContext;
 
+/*! An immutable, flattened snapshot of the graphic's path for geometric hit testing. It's rebuilt lazily after the path changes or the page zooms far enough to change its tolerance, and since it never changes once built, it can be handed to other threads. */
+@property (nonatomic,readonly) DrawFlattenedPath *flattenedPath;
+/*! The tolerance used to flatten the path for hit testing. This is the graphic's flatness in device pixels, converted to page units at the current zoom and rounded to a power of two, so small zoom changes reuse the cached flattening. */
+@property (nonatomic,readonly) CGFloat hitTestFlatness;
+
 - (BOOL)isPoint:(NSPoint)point inHandleAt:(NSPoint)otherPoint;
 - (DrawHandle)pathHandleForPoint:(NSPoint)point;
 - (DrawHandle)pathHandleFromEvent:(DrawEvent *)event;
@@ -288,6 +331,9 @@ typedef BOOL (^DrawGraphicAspectFilter)(DrawAspect *aspect, DrawAspectPriority p
 @property (nonatomic,strong,readonly) NSSet<DrawGraphic *> *relatedGraphics;
 - (void)addToRelatedGraphics:(DrawGraphic *)graphic;
 - (void)removeFromRelatedGraphics:(DrawGraphic *)graphic;
+/*! The union of the bounds of the related graphics. This is cached, so related graphics must call -noteRelatedBoundsAreDirty on us when their bounds change. */
+@property (nonatomic,readonly) NSRect relatedBounds;
+- (void)noteRelatedBoundsAreDirty;
 
 - (NSPoint)intersectionWithLineEndingAtPoint:(NSPoint)point found:(BOOL *)found;
 
@@ -346,6 +392,11 @@ typedef BOOL (^DrawGraphicAspectFilter)(DrawAspect *aspect, DrawAspectPriority p
 
 - (void)sizeToFit;
 
+/*! Called by subgraphics when their bounds change, so the receiver can keep its subgraphic hierarchy current. */
+- (void)subgraphicDidChangeBounds:(DrawGraphic *)subgraphic;
+/*! Returns the subgraphics whose bounds might touch rect, back to front. Large groups find these by descending only the matching branches of a DrawSubgraphicHierarchy. Small groups just return all their subgraphics. */
+- (NSArray<DrawGraphic *> *)subgraphicsIntersectingRect:(NSRect)rect;
+
 - (void)graphicWillMoveToSupergraphic:(DrawGraphic *)newSupergraphic;
 
 - (void)setAutosizeSubgraphics:(BOOL)flag;
@@ -46,6 +46,17 @@ NSString * const DrawGraphicDidChangeFrameNotification = @"DrawGraphicDidChangeF
 NSString * const DrawFlatnessKey = @"DrawFlatness";
 NSString * const DrawShowDirtyBoundsKey = @"DrawShowDirtyBounds";
 NSString * const DrawDebugGraphicFramesKey = @"debugGraphicFrame";
+NSString * const DrawReducedDetailSizeKey = @"DrawReducedDetailSize";
+NSString * const DrawPlaceholderDetailSizeKey = @"DrawPlaceholderDetailSize";
+
+// Paths with fewer elements than this draw as-is at reduced detail, since decimating them wouldn't save anything.
+static const NSInteger DrawReducedDetailMinimumElementCount = 64;
+// Paths with fewer elements than this are cheap enough to just rewrite when they move.
+static const NSInteger DrawDeferredPathMinimumElementCount = 256;
+// Groups with fewer subgraphics than this just draw them, since an image wouldn't save much.
+static const NSUInteger DrawGroupImageMinimumCount = 32;
+// Don't cache groups larger than this many device pixels, which is about a 4K display. All group images together are also kept within DrawGroupImageCache's budget.
+static const CGFloat DrawGroupImageMaximumPixels = 4096.0 * 2304.0;
 
 const AJRInspectorIdentifier DrawInspectorIdentifierGraphic = @"graphic";
 const AJRInspectorIdentifier DrawInspectorIdentifierGraphicHelp = @"graphicHelp";
@@ -64,13 +75,37 @@ static BOOL _notificationsAreDisabled = NO;
 @end
 
 
-@implementation DrawGraphic
+@implementation DrawGraphic {
+    DrawFlattenedPath *_flattenedPath;
+    // Bumped on every path change. Paths are often edited in place, so the element count alone doesn't tell us the flattening is stale.
+    NSUInteger _pathVersion;
+    NSUInteger _flattenedPathVersion;
+    NSRect _relatedBounds;
+    BOOL _relatedBoundsAreValid;
+    AJRBezierPath *_reducedDetailPath;
+    NSUInteger _reducedDetailPathVersion;
+    CGFloat _reducedDetailTolerance;
+    DrawGraphicLevelOfDetail _drawingLevelOfDetail;
+    // How far we've moved since _path's points were last updated. See -bakePathTransform.
+    NSPoint _pathOffset;
+    // A bitmap of our subgraphics, for large groups. Held as a CGImageRef.
+    // The image itself lives in DrawGroupImageCache, which may drop it at any time. This just saves asking the cache when we know there's nothing there.
+    BOOL _hasGroupImage;
+    NSRect _groupImageRect;
+    CGFloat _groupImageScale;
+    // Set once a group has drawn at _groupImageRect and _groupImageScale without changing, so we only pay for an image when it's likely to be reused.
+    BOOL _groupImageIsWanted;
+}
 
 + (void)initialize {
     [[NSUserDefaults standardUserDefaults] registerDefaults:@{DrawFlatnessKey:@(1.0),
                                                               DrawShowDirtyBoundsKey:@(NO),
+                                                              DrawReducedDetailSizeKey:@(12.0),
+                                                              DrawPlaceholderDetailSizeKey:@(3.0),
                                                             }];
     _showsDirtyBounds = [NSUserDefaults.standardUserDefaults boolForKey:DrawShowDirtyBoundsKey defaultValue:NO];
+    _reducedDetailSize = [NSUserDefaults.standardUserDefaults doubleForKey:DrawReducedDetailSizeKey];
+    _placeholderDetailSize = [NSUserDefaults.standardUserDefaults doubleForKey:DrawPlaceholderDetailSizeKey];
 }
 
 static BOOL _showsDirtyBounds = NO;
@@ -83,6 +118,27 @@ static BOOL _showsDirtyBounds = NO;
     _showsDirtyBounds = flag;
 }
 
+#pragma mark - Level of Detail
+
+static CGFloat _reducedDetailSize = 12.0;
+static CGFloat _placeholderDetailSize = 3.0;
+
++ (CGFloat)reducedDetailSize {
+    return _reducedDetailSize;
+}
+
++ (void)setReducedDetailSize:(CGFloat)size {
+    _reducedDetailSize = size;
+}
+
++ (CGFloat)placeholderDetailSize {
+    return _placeholderDetailSize;
+}
+
++ (void)setPlaceholderDetailSize:(CGFloat)size {
+    _placeholderDetailSize = size;
+}
+
 + (NSImage *)handleImage {
     static NSImage *_handleImage = nil;
 
@@ -263,7 +319,15 @@ static BOOL _showsDirtyBounds = NO;
 
         [(DrawGraphic *)[_document prepareWithInvocationTarget:self] setFrame:_frame];
 
-        [_path setControlPointBounds:frame];
+        BOOL deferPath = NSEqualSizes(frame.size, _frame.size) && [self canDeferPathTranslation];
+        if (deferPath) {
+            // Just remember the move. The points catch up in -bakePathTransform, if anything ever needs them.
+            _pathOffset.x += deltaRect.origin.x;
+            _pathOffset.y += deltaRect.origin.y;
+        } else {
+            [self bakePathTransform];
+            [_path setControlPointBounds:frame];
+        }
 
         if (NSEqualSizes(frame.size, _frame.size)) {
             _bounds.origin.x += deltaRect.origin.x;
@@ -285,7 +349,13 @@ static BOOL _showsDirtyBounds = NO;
             [self informAspectsOfShapeChange];
         }
 
-        [self updateBounds];
+        if (deferPath) {
+            // Recomputing our bounds would mean baking the path. Moving didn't change our shape, so the offset bounds are still exact.
+            [_supergraphic subgraphicDidChangeBounds:self];
+            [self noteContentDidChange];
+        } else {
+            [self updateBounds];
+        }
         [_page setNeedsDisplayInRect:[self dirtyBounds]];
     }
 }
@@ -323,7 +393,7 @@ static BOOL _showsDirtyBounds = NO;
     NSRect dirtyBounds = [self dirtyBounds];
 
     if ([_relatedGraphics count]) {
-        dirtyBounds = NSUnionRect(dirtyBounds, DrawBoundsForGraphics(_relatedGraphics));
+        dirtyBounds = NSUnionRect(dirtyBounds, [self relatedBounds]);
     }
 
     return dirtyBounds;
@@ -464,6 +534,15 @@ static BOOL _showsDirtyBounds = NO;
 
 - (void)noteBoundsAreDirty {
     _boundsAreDirty = YES;
+    if (_supergraphic != nil && _supergraphic->_subgraphicHierarchy != nil) {
+        // Our supergraphic culls with our bounds, so it can't wait for us to get around to recomputing them.
+        [self updateBounds];
+    }
+}
+
+- (void)setBounds:(NSRect)bounds {
+    _bounds = bounds;
+    [_supergraphic subgraphicDidChangeBounds:self];
 }
 
 - (BOOL)shouldEncodePath {
@@ -471,6 +550,13 @@ static BOOL _showsDirtyBounds = NO;
 }
 
 - (void)drawHandleAtPoint:(NSPoint)point {
+    DrawHandleRenderer *handleRenderer = [_page handleRenderer];
+    if ([handleRenderer isBatching]) {
+        // The page is drawing its whole selection, and will draw all the handles at once.
+        [handleRenderer addHandleAtPoint:point];
+        return;
+    }
+
     CGFloat scale = _page ? [_page scale] : 1.0;
     NSImage *handleImage = [DrawGraphic handleImage];
     NSSize size = [handleImage size];
@@ -509,18 +595,77 @@ static BOOL _showsDirtyBounds = NO;
 
 #pragma mark - Drawing
 
+- (AJRBezierPath *)path {
+    [self bakePathTransform];
+    return _path;
+}
+
 - (void)setPath:(AJRBezierPath *)path {
     if (path != _path) {
         _path = path;
+        _pathOffset = NSZeroPoint;
+        _pathVersion += 1;
         _boundsAreDirty = YES;
         [self setNeedsDisplay];
     }
 }
 
+- (BOOL)canDeferPathTranslation {
+    if ([_path elementCount] < DrawDeferredPathMinimumElementCount || [_subgraphics count] || _editing) {
+        return NO;
+    }
+    for (NSArray<DrawAspect *> *aspects in _aspects) {
+        for (DrawAspect *aspect in aspects) {
+            if ([aspect isActive] && ![aspect canDrawTranslatedPath]) {
+                return NO;
+            }
+        }
+    }
+    return YES;
+}
+
+- (void)bakePathTransform {
+    if (_pathOffset.x != 0.0 || _pathOffset.y != 0.0) {
+        NSAffineTransform *transform = [NSAffineTransform transform];
+
+        [transform translateXBy:_pathOffset.x yBy:_pathOffset.y];
+        _pathOffset = NSZeroPoint;
+        [_path transformUsingAffineTransform:transform];
+        _pathVersion += 1;
+    }
+}
+
+/*!
+ Moves the receiver without rewriting its path, when -canDeferPathTranslation allows it, the same way -setFrame: does for a plain move. Like -_applyTransformInBulk:translating:, this doesn't register undo, post notifications or invalidate the page. Returns NO, having changed nothing, if the path has to be rewritten.
+ */
+- (BOOL)_translateDeferringPathByX:(CGFloat)deltaX y:(CGFloat)deltaY {
+    if (![self canDeferPathTranslation]) {
+        return NO;
+    }
+
+    _pathOffset.x += deltaX;
+    _pathOffset.y += deltaY;
+    [self setFrameWithoutNotification:NSOffsetRect(_frame, deltaX, deltaY)];
+    // Moving didn't change our shape, so the offset bounds are still exact, and there are no subgraphics to move along with us.
+    if (!_boundsAreDirty) {
+        _bounds = NSOffsetRect(_bounds, deltaX, deltaY);
+    }
+    [self informAspectsOfShapeChange];
+    [_supergraphic subgraphicDidChangeBounds:self];
+    [self noteContentDidChange];
+
+    return YES;
+}
+
 - (BOOL)drawAspect:(DrawAspect *)aspect withPriority:(DrawAspectPriority)priority path:(AJRBezierPath *)path completionBlocks:(NSMutableArray *)drawingCompletionBlocks {
     DrawGraphicCompletionBlock completionBlock;
+    DrawRenderStatistics *statistics = [_page renderStatistics];
+    uint64_t start = statistics ? clock_gettime_nsec_np(CLOCK_UPTIME_RAW) : 0;
 
     completionBlock = [aspect drawPath:path withPriority:priority];
+    if (statistics) {
+        [statistics noteAspect:aspect drewInNanoseconds:clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - start];
+    }
     if (completionBlock) {
         [drawingCompletionBlocks addObject:completionBlock];
     }
@@ -551,6 +696,79 @@ static BOOL _showsDirtyBounds = NO;
     return NSPrintOperation.currentOperation.printInfo.isPrinting;
 }
 
+- (DrawGraphicLevelOfDetail)levelOfDetailInContext:(NSGraphicsContext *)context {
+    // Graphics off the page, such as style previews, are drawn small on purpose, so they always get full detail.
+    if (_page == nil || context == nil || !context.isDrawingToScreen || self.isPrinting || _page.isDrawingForExport) {
+        return DrawGraphicLevelOfDetailFull;
+    }
+
+    BOOL interactive = [_document isDrawingGraphicInteractively:self];
+    if (self.editing && !interactive) {
+        return DrawGraphicLevelOfDetailFull;
+    }
+
+    CGRect deviceFrame = CGContextConvertRectToDeviceSpace(context.CGContext, _frame);
+    CGFloat size = MAX(fabs(deviceFrame.size.width), fabs(deviceFrame.size.height));
+
+    if (size < _placeholderDetailSize) {
+        return DrawGraphicLevelOfDetailPlaceholder;
+    }
+    if (size < _reducedDetailSize || interactive) {
+        return DrawGraphicLevelOfDetailReduced;
+    }
+    return DrawGraphicLevelOfDetailFull;
+}
+
+- (DrawGraphicLevelOfDetail)drawingLevelOfDetail {
+    return _drawingLevelOfDetail;
+}
+
+- (AJRBezierPath *)reducedDetailPathInContext:(NSGraphicsContext *)context {
+    if ([_path elementCount] < DrawReducedDetailMinimumElementCount) {
+        return [self path];
+    }
+
+    // Decimate to about a device pixel, snapped to a power of two so small zoom changes reuse the cached path.
+    CGSize pixel = CGContextConvertSizeToUserSpace(context.CGContext, (CGSize){1.0, 1.0});
+    CGFloat tolerance = MAX(exp2(round(log2(MAX(fabs(pixel.width), fabs(pixel.height))))), 1.0 / 64.0);
+
+    if (_reducedDetailPath == nil || _reducedDetailPathVersion != _pathVersion || _reducedDetailTolerance != tolerance) {
+        DrawFlattenedPath *flattened = [[DrawFlattenedPath alloc] initWithPath:_path flatness:tolerance / 2.0];
+        _reducedDetailPath = [flattened decimatedPathWithTolerance:tolerance];
+        _reducedDetailPathVersion = _pathVersion;
+        _reducedDetailTolerance = tolerance;
+    }
+    return _reducedDetailPath;
+}
+
+- (void)drawPlaceholderInContext:(NSGraphicsContext *)context {
+    NSColor *color = nil;
+
+    for (NSArray<DrawAspect *> *aspects in _aspects) {
+        for (DrawAspect *aspect in aspects) {
+            if ([aspect isActive] && (color = [aspect reducedDetailColor]) != nil) {
+                break;
+            }
+        }
+        if (color != nil) {
+            break;
+        }
+    }
+
+    // Lines and other thin graphics have no area, so make sure we cover at least a device pixel each way.
+    CGSize pixel = CGContextConvertSizeToUserSpace(context.CGContext, (CGSize){1.0, 1.0});
+    NSRect rect = _frame;
+    if (rect.size.width < fabs(pixel.width)) {
+        rect = NSInsetRect(rect, (rect.size.width - fabs(pixel.width)) / 2.0, 0.0);
+    }
+    if (rect.size.height < fabs(pixel.height)) {
+        rect = NSInsetRect(rect, 0.0, (rect.size.height - fabs(pixel.height)) / 2.0);
+    }
+
+    [(color ?: NSColor.lightGrayColor) set];
+    NSRectFillUsingOperation(rect, NSCompositingOperationSourceOver);
+}
+
 - (BOOL)isTemplateGraphic {
     return self == self.document.templateGraphic;
 }
@@ -559,12 +777,38 @@ static BOOL _showsDirtyBounds = NO;
     if (!_ignore) {
         if (!((_frame.size.width == 0.0) && (_frame.size.height == 0.0))) {
             NSGraphicsContext *context = [NSGraphicsContext currentContext];
+            DrawGraphicLevelOfDetail levelOfDetail = [self levelOfDetailInContext:context];
+
+            if (levelOfDetail == DrawGraphicLevelOfDetailPlaceholder) {
+                [[self->_page renderStatistics] noteGraphicDrawn:self];
+                [context drawWithSavedGraphicsState:^(NSGraphicsContext *context) {
+                    [self.supergraphic addClip];
+                    [self drawPlaceholderInContext:context];
+                }];
+                return;
+            }
 
             [context drawWithSavedGraphicsState:^(NSGraphicsContext *context) {
-                AJRBezierPath *path = [self path];
+                // If we've moved since our path was last baked, and our aspects don't mind, draw the path where it was, translated into place.
+                NSPoint pathOffset = self->_pathOffset;
+                BOOL drawsTranslatedPath = (pathOffset.x != 0.0 || pathOffset.y != 0.0) && [self canDeferPathTranslation];
+                AJRBezierPath *path = drawsTranslatedPath ? self->_path : [self path];
+                DrawGraphicAspectFilter aspectFilter = filter;
                 NSMutableArray *drawingCompletionBlocks = [[NSMutableArray alloc] init];
                 BOOL didDraw = NO;
 
+                [[self->_page renderStatistics] noteGraphicDrawn:self];
+
+                // Saved, because aspects like reflections draw their graphic again from within this draw.
+                DrawGraphicLevelOfDetail savedLevelOfDetail = self->_drawingLevelOfDetail;
+                self->_drawingLevelOfDetail = levelOfDetail;
+                if (levelOfDetail == DrawGraphicLevelOfDetailReduced) {
+                    path = [self reducedDetailPathInContext:context];
+                    aspectFilter = ^BOOL(DrawAspect *aspect, DrawAspectPriority priority) {
+                        return [aspect drawsAtReducedDetail] && (filter == NULL || filter(aspect, priority));
+                    };
+                }
+
                 if ([NSUserDefaults.standardUserDefaults boolForKey:DrawDebugGraphicFramesKey]) {
                     [NSColor.lightGrayColor set];
                     NSFrameRect(self.frame);
@@ -581,17 +825,23 @@ static BOOL _showsDirtyBounds = NO;
                     [path stroke];
                 }
 
+                if (drawsTranslatedPath) {
+                    CGContextTranslateCTM(context.CGContext, pathOffset.x, pathOffset.y);
+                }
+
                 for (DrawAspectPriority priority = DrawAspectPriorityFirst; priority <= DrawAspectPriorityLast; priority += 1) {
                     // We do something special for this, which is we draw our children before the aspects.
                     if (priority == DrawAspectPriorityChildren) {
                         [context drawWithSavedGraphicsState:^(NSGraphicsContext *context) {
                             [path addClip];
-                            for (DrawGraphic *subgraphic in self->_subgraphics) {
-                                [subgraphic drawWithAspectFilter:filter];
+                            if (![self drawSubgraphicsFromImageInContext:context aspectFilter:filter levelOfDetail:levelOfDetail]) {
+                                for (DrawGraphic *subgraphic in self->_subgraphics) {
+                                    [subgraphic drawWithAspectFilter:filter];
+                                }
                             }
                         }];
                     }
-                    if ([self drawAspectsWithPriority:priority path:path aspectFilter:filter completionBlocks:drawingCompletionBlocks]) {
+                    if ([self drawAspectsWithPriority:priority path:path aspectFilter:aspectFilter completionBlocks:drawingCompletionBlocks]) {
                         didDraw = YES;
                     }
                 }
@@ -621,6 +871,10 @@ static BOOL _showsDirtyBounds = NO;
                 for (DrawGraphicCompletionBlock completionBlock in [drawingCompletionBlocks reverseObjectEnumerator]) {
                     completionBlock();
                 }
+                if (drawsTranslatedPath) {
+                    CGContextTranslateCTM(context.CGContext, -pathOffset.x, -pathOffset.y);
+                }
+                self->_drawingLevelOfDetail = savedLevelOfDetail;
 
                 if (filter == NULL && [DrawGraphic showsDirtyBounds]) {
                     CGFloat scale = self.page.scale;
@@ -637,9 +891,120 @@ static BOOL _showsDirtyBounds = NO;
     }
 }
 
+#pragma mark - Group Images
+
+- (BOOL)drawSubgraphicsFromImageInContext:(NSGraphicsContext *)context aspectFilter:(DrawGraphicAspectFilter)filter levelOfDetail:(DrawGraphicLevelOfDetail)levelOfDetail {
+    // Printing, exporting and other non-screen drawing must always draw for real. Export also draws from worker threads, so this comes before anything touches the cache.
+    if (![context isDrawingToScreen] || self.isPrinting || _page.isDrawingForExport) {
+        return NO;
+    }
+
+    if (filter != NULL
+        || levelOfDetail != DrawGraphicLevelOfDetailFull
+        || [_subgraphics count] < DrawGroupImageMinimumCount
+        || _editing
+        || _document.focusedGroup == self
+        || [_document isDrawingGraphicInteractively:self]) {
+        [self _discardGroupImage];
+        return NO;
+    }
+
+    // Only cache under a plain scale. Anything rotated or skewed would resample badly.
+    CGContextRef cgContext = context.CGContext;
+    CGAffineTransform transform = CGContextGetCTM(cgContext);
+    CGFloat scale = fabs(transform.a);
+    if (transform.b != 0.0 || transform.c != 0.0 || scale == 0.0 || fabs(fabs(transform.d) - scale) > 1e-6) {
+        [self _discardGroupImage];
+        return NO;
+    }
+
+    // Snap to whole device pixels, so the image lands exactly on the pixels it was rendered for.
+    CGRect deviceRect = CGRectIntegral(CGContextConvertRectToDeviceSpace(cgContext, _frame));
+    if (deviceRect.size.width * deviceRect.size.height > DrawGroupImageMaximumPixels || CGRectIsEmpty(deviceRect)) {
+        [self _discardGroupImage];
+        return NO;
+    }
+    NSRect rect = CGContextConvertRectToUserSpace(cgContext, deviceRect);
+
+    id image = nil;
+    if (_hasGroupImage && _groupImageScale == scale && NSEqualRects(_groupImageRect, rect)) {
+        image = (__bridge id)[DrawGroupImageCache.shared imageForGraphic:self];
+    }
+    if (image == nil) {
+        // If the cache dropped an image we were still using, this is still wanted and we render it again straight away.
+        BOOL isWanted = _groupImageIsWanted && _groupImageScale == scale && NSEqualRects(_groupImageRect, rect);
+
+        [self _discardGroupImage];
+        _groupImageScale = scale;
+        _groupImageRect = rect;
+        _groupImageIsWanted = YES;
+        if (!isWanted) {
+            return NO;
+        }
+        image = [self renderSubgraphicsImageInRect:rect pixelsWide:deviceRect.size.width high:deviceRect.size.height scale:scale flipped:context.isFlipped];
+        if (image == nil) {
+            return NO;
+        }
+        _hasGroupImage = [DrawGroupImageCache.shared setImage:(__bridge CGImageRef)image forGraphic:self];
+    }
+
+    if (context.isFlipped) {
+        CGContextTranslateCTM(cgContext, 0.0, NSMinY(rect) + NSMaxY(rect));
+        CGContextScaleCTM(cgContext, 1.0, -1.0);
+    }
+    CGContextSetInterpolationQuality(cgContext, kCGInterpolationNone);
+    CGContextDrawImage(cgContext, rect, (__bridge CGImageRef)image);
+
+    return YES;
+}
+
+- (id)renderSubgraphicsImageInRect:(NSRect)rect pixelsWide:(size_t)width high:(size_t)height scale:(CGFloat)scale flipped:(BOOL)flipped {
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    CGContextRef bitmap = CGBitmapContextCreate(NULL, width, height, 8, 0, colorSpace, kCGImageAlphaPremultipliedFirst | kCGBitmapByteOrder32Host);
+    CGColorSpaceRelease(colorSpace);
+    if (bitmap == NULL) {
+        return nil;
+    }
+
+    if (flipped) {
+        CGContextTranslateCTM(bitmap, 0.0, height);
+        CGContextScaleCTM(bitmap, scale, -scale);
+    } else {
+        CGContextScaleCTM(bitmap, scale, scale);
+    }
+    CGContextTranslateCTM(bitmap, -rect.origin.x, -rect.origin.y);
+
+    [NSGraphicsContext saveGraphicsState];
+    [NSGraphicsContext setCurrentContext:[NSGraphicsContext graphicsContextWithCGContext:bitmap flipped:flipped]];
+    for (DrawGraphic *subgraphic in _subgraphics) {
+        [subgraphic drawWithAspectFilter:NULL];
+    }
+    [NSGraphicsContext restoreGraphicsState];
+
+    id image = CFBridgingRelease(CGBitmapContextCreateImage(bitmap));
+    CGContextRelease(bitmap);
+
+    return image;
+}
+
+- (void)_discardGroupImage {
+    if (_hasGroupImage) {
+        [DrawGroupImageCache.shared removeImageForGraphic:self];
+        _hasGroupImage = NO;
+    }
+}
+
 - (void)setNeedsDisplay {
     // We might need to make this dirtyBoundsWithRelatedObjects.
     [_page setNeedsDisplayInRect:[self dirtyBounds]];
+    [self noteContentDidChange];
+}
+
+- (void)noteContentDidChange {
+    for (DrawGraphic *graphic = self; graphic != nil; graphic = graphic->_supergraphic) {
+        [graphic _discardGroupImage];
+        graphic->_groupImageIsWanted = NO;
+    }
 }
 
 #pragma mark - Event Handling
@@ -661,6 +1026,9 @@ static BOOL _showsDirtyBounds = NO;
     if ([self startTrackingAt:currentPoint]) {
         NSPoint lastPoint;
         BOOL done = NO;
+        DrawDocument *document = _document;
+
+        [document beginInteractiveDrawingOfGraphics:@[self]];
         while (!done) {
             lastPoint = currentPoint;
 
@@ -668,6 +1036,7 @@ static BOOL _showsDirtyBounds = NO;
                                                 untilDate:[NSDate distantFuture]
                                                    inMode:NSEventTrackingRunLoopMode
                                                   dequeue:YES];
+            [DrawEventRecorder recordEvent:event onPage:[drawEvent page]];
             currentPoint = [[drawEvent document] snapPointToGrid:[[drawEvent page] convertPoint:[event locationInWindow] fromView:nil]];
 
             switch ([event type]) {
@@ -682,6 +1051,7 @@ static BOOL _showsDirtyBounds = NO;
                     break;
             }
         }
+        [document endInteractiveDrawing];
     }
 
     if (DrawHandleIsBase(_handle)) {
@@ -702,7 +1072,7 @@ static BOOL _showsDirtyBounds = NO;
     updateBounds = [self dirtyBounds];
     _ignore = NO;
     _handle = [self setHandle:_handle toLocation:currentPoint];
-    updateBounds = NSUnionRect(updateBounds, DrawBoundsForGraphics(_relatedGraphics));
+    updateBounds = NSUnionRect(updateBounds, [self relatedBounds]);
     [_page setNeedsDisplayInRect:updateBounds];
 
     return YES;
@@ -717,6 +1087,10 @@ static BOOL _showsDirtyBounds = NO;
 
 - (void)setEditing:(BOOL)flag {
     if (flag != _editing) {
+        if (flag) {
+            // Editing works on the path's points, so they need to be where we are.
+            [self bakePathTransform];
+        }
         _editing = flag;
 
         if (flag && [_subgraphics count]) {
@@ -724,6 +1098,7 @@ static BOOL _showsDirtyBounds = NO;
         }
 
         [_page setNeedsDisplayInRect:[self dirtyBounds]];
+        [self noteContentDidChange];
     }
     if (!flag) {
         NSArray *subaspects;
@@ -755,17 +1130,16 @@ static BOOL _showsDirtyBounds = NO;
     return NO;
 }
 
-- (void)_informAspectsOfShapeChange {
+- (void)informAspectsOfShapeChangeNow {
     [self enumerateAspectsWithBlock:^(DrawAspect *aspect) {
         [aspect graphicDidChangeShape:self];
     }];
-    [_relatedGraphics makeObjectsPerformSelector:@selector(graphicDidChangeShape:) withObject:self];
+    [DrawLinkUpdater graphicDidChangeShape:self];
 }
 
 - (void)informAspectsOfShapeChange {
-    // Coalesce to the end of the event loop.
-    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(_informAspectsOfShapeChange) object:nil];
-    [self performSelector:@selector(_informAspectsOfShapeChange) withObject:nil afterDelay:0.0];
+    // Coalesce to the end of the event loop. The updater runs in the common modes, so this keeps up during mouse tracking, and can be flushed before saving or printing.
+    [DrawLinkUpdater scheduleShapeChangeOfGraphic:self];
 }
 
 - (NSRect)boundsForAspect:(DrawAspect *)aspect withPriority:(DrawAspectPriority)priority {
@@ -777,6 +1151,9 @@ static BOOL _showsDirtyBounds = NO;
     NSRect work;
     NSRect frameIncludingHandles;
     NSMutableArray *deferredBounds = [[NSMutableArray alloc] init];
+
+    // Anything that changes the path ends up here, so this is where the hit testing geometry goes stale.
+    _pathVersion += 1;
     DrawAspectPriority priority;
 
     [self informAspectsOfShapeChange];
@@ -818,9 +1195,12 @@ static BOOL _showsDirtyBounds = NO;
     }
 
     _boundsAreDirty = NO;
+
+    [_supergraphic subgraphicDidChangeBounds:self];
+    [self noteContentDidChange];
 }
 
-- (NSGraphicsContext *)hitContext {
++ (NSGraphicsContext *)hitContext {
     static NSGraphicsContext *_hitContext = nil;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
@@ -829,6 +1209,26 @@ static BOOL _showsDirtyBounds = NO;
     return _hitContext;
 }
 
+- (NSGraphicsContext *)hitContext {
+    return [DrawGraphic hitContext];
+}
+
+- (CGFloat)hitTestFlatness {
+    CGFloat scale = _page ? [_page scale] : 1.0;
+    CGFloat flatness = (_flatness > 0.0 ? _flatness : 1.0) / (scale > 0.0 ? scale : 1.0);
+    return MAX(exp2(round(log2(flatness))), 1.0 / 64.0);
+}
+
+- (DrawFlattenedPath *)flattenedPath {
+    CGFloat flatness = [self hitTestFlatness];
+    AJRBezierPath *path = [self path];
+    if (_flattenedPath == nil || _flattenedPathVersion != _pathVersion || _flattenedPath.flatness != flatness) {
+        _flattenedPath = [[DrawFlattenedPath alloc] initWithPath:path flatness:flatness];
+        _flattenedPathVersion = _pathVersion;
+    }
+    return _flattenedPath;
+}
+
 - (BOOL)isPoint:(NSPoint)aPoint inHandleAt:(NSPoint)otherPoint {
     CGFloat adjustment = 3.0; //[_page error];
 
@@ -836,7 +1236,7 @@ static BOOL _showsDirtyBounds = NO;
 }
 
 - (DrawHandle)pathHandleForPoint:(NSPoint)point {
-    return [_path drawHandleForPoint:point error:3.0/*[_page error]*/];
+    return [[self path] drawHandleForPoint:point error:3.0/*[_page error]*/];
 }
 
 - (DrawHandle)pathHandleFromEvent:(NSEvent *)anEvent {
@@ -868,7 +1268,7 @@ static BOOL _showsDirtyBounds = NO;
                 return (NSPoint){_frame.origin.x + _frame.size.width, _frame.origin.y + _frame.size.height};
             case DrawHandleTypeIndexed: {
                 NSPoint points[3];
-                [_path elementAtIndex:handle.elementIndex associatedPoints:points];
+                [[self path] elementAtIndex:handle.elementIndex associatedPoints:points];
                 return points[handle.subindex];
             }
         }
@@ -896,7 +1296,7 @@ static BOOL _showsDirtyBounds = NO;
                 return (NSPoint){_frame.origin.x + _frame.size.width, _frame.origin.y};
             case DrawHandleTypeIndexed: {
                 NSPoint points[3];
-                [_path elementAtIndex:handle.elementIndex associatedPoints:points];
+                [[self path] elementAtIndex:handle.elementIndex associatedPoints:points];
                 return points[handle.subindex];
             }
         }
@@ -939,7 +1339,7 @@ static BOOL _showsDirtyBounds = NO;
 
 - (BOOL)isHitByPoint:(NSPoint)aPoint forAspectsWithPriority:(DrawAspectPriority)priority {
     for (DrawAspect *aspect in [_aspects objectAtIndex:priority]) {
-        if ([aspect isActive] && [aspect isPoint:aPoint inPath:_path withPriority:priority]) {
+        if ([aspect isActive] && [aspect isPoint:aPoint inPath:[self path] withPriority:priority]) {
             return YES;
         }
     }
@@ -948,7 +1348,7 @@ static BOOL _showsDirtyBounds = NO;
 
 - (BOOL)isHitByRect:(NSRect)rect forAspectsWithPriority:(DrawAspectPriority)priority {
     for (DrawAspect *aspect in [_aspects objectAtIndex:priority]) {
-        if ([aspect isActive] && [aspect doesRect:rect intersectPath:_path withPriority:priority]) {
+        if ([aspect isActive] && [aspect doesRect:rect intersectPath:[self path] withPriority:priority]) {
             return YES;
         }
     }
@@ -956,9 +1356,11 @@ static BOOL _showsDirtyBounds = NO;
 }
 
 - (NSArray<DrawGraphic *> *)graphicsHitByGraphicTest:(NSArray<DrawGraphic *> * (^)(DrawGraphic *graphic))graphicTest
+                                              inRect:(NSRect)rect
                                           aspectTest:(BOOL (^)(DrawAspectPriority priority))aspectTest
-                                            pathTest:(BOOL (^)(AJRBezierPath *path))pathTest {
+                                            pathTest:(BOOL (^)(DrawFlattenedPath *path, CGFloat width))pathTest {
     NSGraphicsContext *context = [NSGraphicsContext currentContext];
+    NSGraphicsContext *hitContext = [DrawGraphic hitContext];
     __block NSMutableArray<DrawGraphic *> *hit = nil;
     NSArray<DrawGraphic *> *others;
     BOOL hasAspects = NO;
@@ -970,7 +1372,8 @@ static BOOL _showsDirtyBounds = NO;
         [hit addObjectsFromArray:graphics];
     };
 
-    for (DrawGraphic *subgraphic in [_subgraphics reverseObjectEnumerator]) {
+    // Large groups only offer up the subgraphics whose bounds touch rect.
+    for (DrawGraphic *subgraphic in [[self subgraphicsIntersectingRect:rect] reverseObjectEnumerator]) {
         others = graphicTest(subgraphic);
         if ([others count]) {
             addGraphics(others);
@@ -983,7 +1386,10 @@ static BOOL _showsDirtyBounds = NO;
         }
     }
 
-    [NSGraphicsContext setCurrentContext:[self hitContext]];
+    // Aspects that haven't moved to geometric hit testing may still need a context. Usually the page has already installed one for the whole hit test, so we don't swap per graphic.
+    if (context != hitContext) {
+        [NSGraphicsContext setCurrentContext:hitContext];
+    }
 
     for (DrawAspectPriority priority = DrawAspectPriorityFirst; priority <= DrawAspectPriorityLast; priority++) {
         if (aspectTest(priority)) {
@@ -996,34 +1402,37 @@ static BOOL _showsDirtyBounds = NO;
     // if we had no aspects capable of causing a hit, then see if our stroke was hit.
     if (!hasAspects) {
         // This just makes really small lines easier to actual hit with the mouse.
-        [_path setLineWidth:3.0 / [_page scale]];
-        if (pathTest(_path)) {
+        if (pathTest([self flattenedPath], 3.0 / [_page scale])) {
             addGraphics(@[self]);
         }
     }
 
-    [NSGraphicsContext setCurrentContext:context];
+    if (context != hitContext) {
+        [NSGraphicsContext setCurrentContext:context];
+    }
 
     return hit;
 }
 
 - (NSArray<DrawGraphic *> *)graphicsHitByPoint:(NSPoint)point; {
+    // Allow for the slop we give strokes below.
+    CGFloat slop = 3.0 / ([_page scale] > 0.0 ? [_page scale] : 1.0);
     return [self graphicsHitByGraphicTest:^NSArray<DrawGraphic *> *(DrawGraphic *graphic) {
         return [graphic graphicsHitByPoint:point];
-    } aspectTest:^BOOL(DrawAspectPriority priority) {
+    } inRect:NSInsetRect((NSRect){point, NSZeroSize}, -slop, -slop) aspectTest:^BOOL(DrawAspectPriority priority) {
         return [self isHitByPoint:point forAspectsWithPriority:priority];
-    } pathTest:^BOOL(AJRBezierPath *path) {
-        return [path isStrokeHitByPoint:point];
+    } pathTest:^BOOL(DrawFlattenedPath *path, CGFloat width) {
+        return [path isStrokeHitByPoint:point width:width];
     }];
 }
 
 - (NSArray<DrawGraphic *> *)graphicsHitByRect:(NSRect)rect {
     return [self graphicsHitByGraphicTest:^NSArray<DrawGraphic *> *(DrawGraphic *graphic) {
         return [graphic graphicsHitByRect:rect];
-    } aspectTest:^BOOL(DrawAspectPriority priority) {
+    } inRect:rect aspectTest:^BOOL(DrawAspectPriority priority) {
         return [self isHitByRect:rect forAspectsWithPriority:priority];
-    } pathTest:^BOOL(AJRBezierPath *path) {
-        return [path isHitByRect:rect];
+    } pathTest:^BOOL(DrawFlattenedPath *path, CGFloat width) {
+        return [path intersectsRect:rect evenOdd:NO];
     }];
 }
 
@@ -1203,7 +1612,7 @@ static BOOL _showsDirtyBounds = NO;
 
     new->_frame = _frame;
     new->_bounds = _bounds;
-    new->_path = [_path copyWithZone:aZone];
+    new->_path = [[self path] copyWithZone:aZone];
     [new takeAspectsFromGraphic:self];
     new->_handle = _handle;
     new->_ignore = NO;
@@ -1244,6 +1653,7 @@ static BOOL _showsDirtyBounds = NO;
     }];
     [coder decodeObjectForKey:@"relatedGraphics" setter:^(id  _Nonnull object) {
         self->_relatedGraphics = [object mutableCopy];
+        self->_relatedBoundsAreValid = NO;
     }];
     [coder decodeFloatForKey:@"flatness" setter:^(float value) {
         self->_flatness = value;
@@ -1302,7 +1712,7 @@ static BOOL _showsDirtyBounds = NO;
 - (void)encodeWithXMLCoder:(AJRXMLCoder *)encoder {
     [encoder encodeRect:_frame forKey:@"frame"];
     if (self.shouldEncodePath) {
-        [encoder encodeObject:_path forKey:@"path"];
+        [encoder encodeObject:[self path] forKey:@"path"];
     }
 
     NSArray<NSString *> *names = [self.class priorityNames];
@@ -1365,7 +1775,7 @@ static BOOL _showsDirtyBounds = NO;
             && AJREqual(_layer, other->_layer)
             && NSEqualRects(_frame, other->_frame)
             && _seed == other->_seed
-            && AJREqual(_path, other->_path)
+            && AJREqual([self path], [other path])
             && AJREqual(_aspects, other->_aspects)
             && DrawHandleEqual(_handle, other->_handle)
             //&& AJREqual(_relatedGraphics, other->_relatedGraphics) // Checking this causes an infinite loop.
@@ -1520,10 +1930,24 @@ static BOOL _showsDirtyBounds = NO;
 
 - (void)addToRelatedGraphics:(DrawGraphic *)graphic {
     [_relatedGraphics addObject:graphic];
+    _relatedBoundsAreValid = NO;
 }
 
 - (void)removeFromRelatedGraphics:(DrawGraphic *)graphic {
     [_relatedGraphics removeObject:graphic];
+    _relatedBoundsAreValid = NO;
+}
+
+- (NSRect)relatedBounds {
+    if (!_relatedBoundsAreValid) {
+        _relatedBounds = [_relatedGraphics count] ? DrawBoundsForGraphics(_relatedGraphics) : NSZeroRect;
+        _relatedBoundsAreValid = YES;
+    }
+    return _relatedBounds;
+}
+
+- (void)noteRelatedBoundsAreDirty {
+    _relatedBoundsAreValid = NO;
 }
 
 - (NSPoint)intersectionWithLineEndingAtPoint:(NSPoint)aPoint found:(BOOL *)found {
@@ -1533,7 +1957,7 @@ static BOOL _showsDirtyBounds = NO;
     line.start = aPoint;
     line.end = [self centroid];
 
-    intersections = [_path intersectionsWithLine:line error:0.1];
+    intersections = [[self path] intersectionsWithLine:line error:0.1];
     if (intersections) {
         *found = YES;
         intersections = [intersections sortedArrayFromPoint:aPoint];
@@ -0,0 +1,186 @@
+/*
+ DrawGroupImageCache.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Holds the images groups draw their subgraphics from, within one shared memory budget.
+
+ A group image is worth keeping while the group is drawn over and over unchanged, but a document with many large groups could otherwise hold a screen sized bitmap for every one of them. So the images live here instead of in the groups. When adding an image would go over `byteLimit`, the least recently drawn images are dropped first, and everything is dropped when the system warns that memory is low. A group whose image was dropped just draws its subgraphics, and renders a new image the next time it's drawn unchanged.
+
+ Entries only hold their group weakly, so a group that goes away never has its image found by another group, and its image is the first to go when room is needed.
+ */
+@objcMembers
+open class DrawGroupImageCache : NSObject {
+
+    private struct Entry {
+        weak var graphic : DrawGraphic?
+        var image : CGImage
+        var cost : Int
+        var lastUse : UInt64
+    }
+
+    /// About five full screen images at the largest size a group will cache.
+    public static let defaultByteLimit = 192 * 1024 * 1024
+
+    public static let shared = DrawGroupImageCache(byteLimit: DrawGroupImageCache.defaultByteLimit)
+
+    // MARK: - Properties
+
+    /// The most bytes of image data to hold at once. Lowering it drops images until the cache fits.
+    open var byteLimit : Int {
+        get {
+            lock.lock()
+            defer { lock.unlock() }
+            return _byteLimit
+        }
+        set {
+            lock.lock()
+            _byteLimit = max(newValue, 0)
+            evict(toFit: 0)
+            lock.unlock()
+        }
+    }
+
+    /// The bytes of image data currently held.
+    open var totalCost : Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return _totalCost
+    }
+
+    open var count : Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return entries.count
+    }
+
+    // Graphics normally only draw on the main thread, but they can be released anywhere, so everything is behind the lock.
+    private let lock = NSLock()
+    private var entries = [ObjectIdentifier:Entry]()
+    private var _byteLimit : Int
+    private var _totalCost = 0
+    private var clock : UInt64 = 0
+    private var memoryPressureSource : DispatchSourceMemoryPressure?
+
+    // MARK: - Creation
+
+    public init(byteLimit: Int) {
+        _byteLimit = max(byteLimit, 0)
+        super.init()
+        let source = DispatchSource.makeMemoryPressureSource(eventMask: [.warning, .critical], queue: .main)
+        source.setEventHandler { [weak self] in
+            self?.didReceiveMemoryPressure()
+        }
+        source.resume()
+        memoryPressureSource = source
+    }
+
+    deinit {
+        memoryPressureSource?.cancel()
+    }
+
+    // MARK: - Images
+
+    /// Returns `graphic`'s image, if it's still cached, and marks it as the most recently used.
+    @objc(imageForGraphic:)
+    open func image(for graphic: DrawGraphic) -> CGImage? {
+        let key = ObjectIdentifier(graphic)
+        lock.lock()
+        defer { lock.unlock() }
+        guard let entry = entries[key], entry.graphic === graphic else {
+            return nil
+        }
+        clock += 1
+        entries[key]?.lastUse = clock
+        return entry.image
+    }
+
+    /// Caches `image` for `graphic`, replacing any image it had. Returns `false`, and caches nothing, when the image alone is larger than `byteLimit`.
+    @discardableResult
+    @objc(setImage:forGraphic:)
+    open func setImage(_ image: CGImage, for graphic: DrawGraphic) -> Bool {
+        let key = ObjectIdentifier(graphic)
+        let cost = image.bytesPerRow * image.height
+        lock.lock()
+        defer { lock.unlock() }
+        removeEntry(forKey: key)
+        if cost > _byteLimit {
+            return false
+        }
+        evict(toFit: cost)
+        clock += 1
+        entries[key] = Entry(graphic: graphic, image: image, cost: cost, lastUse: clock)
+        _totalCost += cost
+        return true
+    }
+
+    @objc(removeImageForGraphic:)
+    open func removeImage(for graphic: DrawGraphic) {
+        lock.lock()
+        removeEntry(forKey: ObjectIdentifier(graphic))
+        lock.unlock()
+    }
+
+    open func removeAllImages() {
+        lock.lock()
+        entries.removeAll()
+        _totalCost = 0
+        lock.unlock()
+    }
+
+    internal func didReceiveMemoryPressure() {
+        removeAllImages()
+    }
+
+    // MARK: - Eviction
+
+    private func removeEntry(forKey key: ObjectIdentifier) {
+        if let entry = entries.removeValue(forKey: key) {
+            _totalCost -= entry.cost
+        }
+    }
+
+    /// Drops images, those of groups that have gone away first and then the least recently used, until `cost` more bytes fit. Callers hold the lock.
+    private func evict(toFit cost: Int) {
+        if _totalCost + cost <= _byteLimit {
+            return
+        }
+        for (key, entry) in entries where entry.graphic == nil {
+            removeEntry(forKey: key)
+        }
+        // There are only ever a handful of images, so a scan is cheaper than keeping an ordered list up to date on every draw.
+        while _totalCost + cost > _byteLimit, let oldest = entries.min(by: { $0.value.lastUse < $1.value.lastUse }) {
+            removeEntry(forKey: oldest.key)
+        }
+    }
+
+}
@@ -0,0 +1,136 @@
+/*
+ DrawSegmentHierarchy.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import Foundation
+
+/**
+ A bounding volume hierarchy over the segments of a `DrawFlattenedPath`.
+
+ Each node holds the bounds of everything beneath it. Leaves hold up to `leafSize` segments. Nodes are stored depth first, so a node's left child immediately follows it and only the right child's index is stored. A query that touches a small part of a long path visits O(log n) nodes rather than every segment.
+
+ Like the flattened path that owns it, the hierarchy is immutable once built.
+ */
+internal struct DrawSegmentHierarchy {
+
+    internal struct Node {
+        var minX : CGFloat
+        var minY : CGFloat
+        var maxX : CGFloat
+        var maxY : CGFloat
+        /// For leaves, the first entry in `order`. For interior nodes, the index of the right child.
+        var index : Int32
+        /// The number of segments in a leaf, or `0` for an interior node.
+        var count : Int32
+    }
+
+    static let leafSize = 8
+
+    internal private(set) var nodes = [Node]()
+    /// Segment indices, arranged so every leaf's segments are contiguous.
+    internal private(set) var order : [Int32]
+
+    init(segments: [DrawFlattenedPath.Segment]) {
+        order = (0 ..< segments.count).map { Int32($0) }
+        nodes.reserveCapacity(max(1, 2 * segments.count / DrawSegmentHierarchy.leafSize))
+        if !segments.isEmpty {
+            build(segments, 0, segments.count)
+        }
+    }
+
+    private mutating func build(_ segments: [DrawFlattenedPath.Segment], _ start: Int, _ end: Int) {
+        var minX = CGFloat.greatestFiniteMagnitude, minY = CGFloat.greatestFiniteMagnitude
+        var maxX = -CGFloat.greatestFiniteMagnitude, maxY = -CGFloat.greatestFiniteMagnitude
+        var centerMinX = minX, centerMinY = minY, centerMaxX = maxX, centerMaxY = maxY
+
+        for index in start ..< end {
+            let segment = segments[Int(order[index])]
+            minX = min(minX, segment.minX); minY = min(minY, segment.minY)
+            maxX = max(maxX, segment.maxX); maxY = max(maxY, segment.maxY)
+            let cx = (segment.minX + segment.maxX) * 0.5
+            let cy = (segment.minY + segment.maxY) * 0.5
+            centerMinX = min(centerMinX, cx); centerMinY = min(centerMinY, cy)
+            centerMaxX = max(centerMaxX, cx); centerMaxY = max(centerMaxY, cy)
+        }
+
+        let nodeIndex = nodes.count
+        nodes.append(Node(minX: minX, minY: minY, maxX: maxX, maxY: maxY, index: Int32(start), count: Int32(end - start)))
+        if end - start <= DrawSegmentHierarchy.leafSize {
+            return
+        }
+
+        // Split at the median centroid along the longer axis.
+        let splitOnX = centerMaxX - centerMinX >= centerMaxY - centerMinY
+        order[start ..< end].sort { left, right in
+            let a = segments[Int(left)], b = segments[Int(right)]
+            return splitOnX ? a.minX + a.maxX < b.minX + b.maxX : a.minY + a.maxY < b.minY + b.maxY
+        }
+        let middle = (start + end) / 2
+
+        nodes[nodeIndex].count = 0
+        build(segments, start, middle)
+        nodes[nodeIndex].index = Int32(nodes.count)
+        build(segments, middle, end)
+    }
+
+    /**
+     Calls `body` with the index of every segment in a leaf whose bounds overlap the given box, stopping early if `body` returns `true`.
+
+     - returns: `true` if `body` stopped the walk.
+     */
+    @discardableResult
+    func forEachSegment(overlappingMinX minX: CGFloat, minY: CGFloat, maxX: CGFloat, maxY: CGFloat, _ body: (Int) -> Bool) -> Bool {
+        if nodes.isEmpty {
+            return false
+        }
+        var stack = [Int32]()
+        stack.reserveCapacity(64)
+        stack.append(0)
+
+        while let nodeIndex = stack.popLast() {
+            let node = nodes[Int(nodeIndex)]
+            if node.minX > maxX || node.maxX < minX || node.minY > maxY || node.maxY < minY {
+                continue
+            }
+            if node.count > 0 {
+                for index in Int(node.index) ..< Int(node.index + node.count) {
+                    if body(Int(order[index])) {
+                        return true
+                    }
+                }
+            } else {
+                stack.append(node.index)
+                stack.append(nodeIndex + 1)
+            }
+        }
+        return false
+    }
+
+}
@@ -0,0 +1,419 @@
+/*
+ DrawSubgraphicHierarchy.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import Foundation
+
+/**
+ A bounding volume hierarchy over a group's subgraphics.
+
+ Unlike `DrawSegmentHierarchy`, which is built once, this one changes as subgraphics are added, removed and moved. Each leaf holds one subgraphic. Each interior node holds the union of its children's frames and bounds. The tree is kept height balanced with rotations, so inserting, removing or moving a subgraphic costs O(log n), and the union of everything is just the root's rects.
+
+ The rects stored are the ones the group sizes itself to, which are the subgraphic's frame and bounds grown by `inset` for leaf graphics. Since they are never smaller than the real bounds, they can also be used to find the subgraphics a hit test might touch.
+
+ Subgraphics also carry an order, so queries can return them back to front, the way the group draws them.
+ */
+@objcMembers
+open class DrawSubgraphicHierarchy : NSObject {
+
+    internal struct Node {
+        var frame : NSRect
+        var bounds : NSRect
+        var parent : Int = -1
+        var left : Int = -1
+        var right : Int = -1
+        /// The height of the subtree, with leaves at `0`.
+        var height : Int = 0
+        /// The subgraphic held by a leaf. Interior nodes have none.
+        var graphic : DrawGraphic? = nil
+        /// The subgraphic's position, back to front. Only meaningful for leaves.
+        var order : Double = 0.0
+
+        var isLeaf : Bool { return left == -1 }
+    }
+
+    internal private(set) var nodes = [Node]()
+    internal private(set) var root = -1
+    private var freeNodes = [Int]()
+    private var leaves = [ObjectIdentifier:Int]()
+    private var maximumOrder = -1.0
+
+    /// How much the group grows the frame and bounds of its leaf subgraphics. The group rebuilds the hierarchy when this changes.
+    public let inset : CGFloat
+
+    public init(inset: CGFloat) {
+        self.inset = inset
+        super.init()
+    }
+
+    // MARK: - Properties
+
+    open var count : Int {
+        return leaves.count
+    }
+
+    /// The union of the subgraphics' frames, or `NSZeroRect` when empty.
+    open var frame : NSRect {
+        return root == -1 ? .zero : nodes[root].frame
+    }
+
+    /// The union of the subgraphics' bounds, or `NSZeroRect` when empty.
+    open var bounds : NSRect {
+        return root == -1 ? .zero : nodes[root].bounds
+    }
+
+    /// The number of levels in the tree. This stays around log2(count).
+    open var height : Int {
+        return root == -1 ? 0 : nodes[root].height + 1
+    }
+
+    @objc(containsGraphic:)
+    open func contains(_ graphic: DrawGraphic) -> Bool {
+        return leaves[ObjectIdentifier(graphic)] != nil
+    }
+
+    // MARK: - Editing
+
+    /// Adds `graphic` in front of everything already in the hierarchy.
+    @objc(appendGraphic:frame:bounds:)
+    open func append(_ graphic: DrawGraphic, frame: NSRect, bounds: NSRect) {
+        maximumOrder += 1.0
+        insertLeaf(for: graphic, frame: frame, bounds: bounds, order: maximumOrder)
+    }
+
+    /// Adds `graphic` in front of `lower` and behind `upper`. Either may be `nil`, meaning the back or the front.
+    @objc(insertGraphic:frame:bounds:between:and:)
+    open func insert(_ graphic: DrawGraphic, frame: NSRect, bounds: NSRect, between lower: DrawGraphic?, and upper: DrawGraphic?) {
+        guard let order = order(between: lower, and: upper) else {
+            // We've split the gap between two neighbours too many times to fit another order between them.
+            renumber()
+            insert(graphic, frame: frame, bounds: bounds, between: lower, and: upper)
+            return
+        }
+        maximumOrder = max(maximumOrder, order)
+        insertLeaf(for: graphic, frame: frame, bounds: bounds, order: order)
+    }
+
+    /// Updates the rects for `graphic` after it moves or changes shape. Returns false if `graphic` isn't in the hierarchy.
+    @discardableResult
+    @objc(updateGraphic:frame:bounds:)
+    open func update(_ graphic: DrawGraphic, frame: NSRect, bounds: NSRect) -> Bool {
+        guard let leaf = leaves[ObjectIdentifier(graphic)] else { return false }
+        if nodes[leaf].frame == frame && nodes[leaf].bounds == bounds {
+            return true
+        }
+        removeLeaf(leaf)
+        nodes[leaf].frame = frame
+        nodes[leaf].bounds = bounds
+        insertLeaf(leaf)
+        return true
+    }
+
+    @objc(removeGraphic:)
+    open func remove(_ graphic: DrawGraphic) {
+        if let leaf = leaves.removeValue(forKey: ObjectIdentifier(graphic)) {
+            removeLeaf(leaf)
+            freeNode(leaf)
+        }
+    }
+
+    /// Moves everything by the same amount. This is O(n), but touches no structure, so it's much cheaper than updating every leaf when a whole group moves.
+    @objc(offsetByX:y:)
+    open func offset(byX dx: CGFloat, y dy: CGFloat) {
+        for index in nodes.indices {
+            nodes[index].frame = nodes[index].frame.offsetBy(dx: dx, dy: dy)
+            nodes[index].bounds = nodes[index].bounds.offsetBy(dx: dx, dy: dy)
+        }
+    }
+
+    // MARK: - Queries
+
+    /// Returns the subgraphics whose bounds touch `rect`, back to front. Only branches whose bounds touch `rect` are visited.
+    @objc(graphicsIntersectingRect:)
+    open func graphics(intersecting rect: NSRect) -> [DrawGraphic] {
+        var found = [(order: Double, graphic: DrawGraphic)]()
+        var stack = [Int]()
+
+        if root != -1 {
+            stack.append(root)
+        }
+        while let index = stack.popLast() {
+            let node = nodes[index]
+            if !DrawSubgraphicHierarchy.overlaps(node.bounds, rect) {
+                continue
+            }
+            if node.isLeaf {
+                if let graphic = node.graphic {
+                    found.append((node.order, graphic))
+                }
+            } else {
+                stack.append(node.left)
+                stack.append(node.right)
+            }
+        }
+
+        return found.sorted { $0.order < $1.order }.map { $0.graphic }
+    }
+
+    // MARK: - Geometry
+
+    /// Like `NSUnionRect()`, but keeps empty rects, such as the frame of a horizontal line.
+    internal static func union(_ a: NSRect, _ b: NSRect) -> NSRect {
+        let minX = min(a.minX, b.minX), minY = min(a.minY, b.minY)
+        return NSRect(x: minX, y: minY, width: max(a.maxX, b.maxX) - minX, height: max(a.maxY, b.maxY) - minY)
+    }
+
+    /// Like `NSIntersectsRect()`, but counts touching edges and empty rects.
+    internal static func overlaps(_ a: NSRect, _ b: NSRect) -> Bool {
+        return a.minX <= b.maxX && a.maxX >= b.minX && a.minY <= b.maxY && a.maxY >= b.minY
+    }
+
+    internal static func perimeter(_ rect: NSRect) -> CGFloat {
+        return 2.0 * (rect.width + rect.height)
+    }
+
+    // MARK: - Ordering
+
+    private func order(between lower: DrawGraphic?, and upper: DrawGraphic?) -> Double? {
+        let lowerOrder = lower.flatMap { leaves[ObjectIdentifier($0)] }.map { nodes[$0].order }
+        let upperOrder = upper.flatMap { leaves[ObjectIdentifier($0)] }.map { nodes[$0].order }
+
+        switch (lowerOrder, upperOrder) {
+        case (.some(let low), .some(let high)):
+            let order = low + (high - low) / 2.0
+            return order > low && order < high ? order : nil
+        case (.some(let low), .none):
+            return low + 1.0
+        case (.none, .some(let high)):
+            return high - 1.0
+        case (.none, .none):
+            return maximumOrder + 1.0
+        }
+    }
+
+    private func renumber() {
+        let sorted = leaves.values.sorted { nodes[$0].order < nodes[$1].order }
+        for (order, leaf) in sorted.enumerated() {
+            nodes[leaf].order = Double(order)
+        }
+        maximumOrder = Double(sorted.count - 1)
+    }
+
+    // MARK: - Tree Maintenance
+
+    private func allocateNode(_ node: Node) -> Int {
+        if let index = freeNodes.popLast() {
+            nodes[index] = node
+            return index
+        }
+        nodes.append(node)
+        return nodes.count - 1
+    }
+
+    private func freeNode(_ index: Int) {
+        nodes[index] = Node(frame: .zero, bounds: .zero)
+        freeNodes.append(index)
+    }
+
+    private func insertLeaf(for graphic: DrawGraphic, frame: NSRect, bounds: NSRect, order: Double) {
+        if let existing = leaves[ObjectIdentifier(graphic)] {
+            removeLeaf(existing)
+            freeNode(existing)
+        }
+        let leaf = allocateNode(Node(frame: frame, bounds: bounds, graphic: graphic, order: order))
+        leaves[ObjectIdentifier(graphic)] = leaf
+        insertLeaf(leaf)
+    }
+
+    /// Inserts an allocated leaf where it grows the tree's perimeter the least, then rebalances back up to the root.
+    private func insertLeaf(_ leaf: Int) {
+        if root == -1 {
+            root = leaf
+            nodes[leaf].parent = -1
+            return
+        }
+
+        let leafBounds = nodes[leaf].bounds
+        var index = root
+        while !nodes[index].isLeaf {
+            let node = nodes[index]
+            let perimeter = DrawSubgraphicHierarchy.perimeter(node.bounds)
+            let combinedPerimeter = DrawSubgraphicHierarchy.perimeter(DrawSubgraphicHierarchy.union(node.bounds, leafBounds))
+            // The cost of making a new parent for this node and the leaf, and the cost every child pays for pushing the leaf further down.
+            let cost = 2.0 * combinedPerimeter
+            let inheritanceCost = 2.0 * (combinedPerimeter - perimeter)
+
+            func descentCost(_ child: Int) -> CGFloat {
+                let combined = DrawSubgraphicHierarchy.perimeter(DrawSubgraphicHierarchy.union(nodes[child].bounds, leafBounds))
+                return (nodes[child].isLeaf ? combined : combined - DrawSubgraphicHierarchy.perimeter(nodes[child].bounds)) + inheritanceCost
+            }
+            let leftCost = descentCost(node.left)
+            let rightCost = descentCost(node.right)
+
+            if cost < leftCost && cost < rightCost {
+                break
+            }
+            index = leftCost < rightCost ? node.left : node.right
+        }
+
+        let sibling = index
+        let oldParent = nodes[sibling].parent
+        let newParent = allocateNode(Node(frame: DrawSubgraphicHierarchy.union(nodes[sibling].frame, nodes[leaf].frame),
+                                          bounds: DrawSubgraphicHierarchy.union(nodes[sibling].bounds, leafBounds),
+                                          parent: oldParent,
+                                          left: sibling,
+                                          right: leaf,
+                                          height: nodes[sibling].height + 1))
+        if oldParent == -1 {
+            root = newParent
+        } else {
+            replaceChild(sibling, of: oldParent, with: newParent)
+        }
+        nodes[sibling].parent = newParent
+        nodes[leaf].parent = newParent
+
+        refit(from: newParent)
+    }
+
+    /// Unlinks a leaf from the tree, but leaves it allocated.
+    private func removeLeaf(_ leaf: Int) {
+        if leaf == root {
+            root = -1
+            return
+        }
+
+        let parent = nodes[leaf].parent
+        let grandparent = nodes[parent].parent
+        let sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left
+
+        if grandparent == -1 {
+            root = sibling
+            nodes[sibling].parent = -1
+            freeNode(parent)
+        } else {
+            replaceChild(parent, of: grandparent, with: sibling)
+            nodes[sibling].parent = grandparent
+            freeNode(parent)
+            refit(from: grandparent)
+        }
+        nodes[leaf].parent = -1
+    }
+
+    private func replaceChild(_ child: Int, of parent: Int, with newChild: Int) {
+        if nodes[parent].left == child {
+            nodes[parent].left = newChild
+        } else {
+            nodes[parent].right = newChild
+        }
+    }
+
+    private func fit(_ index: Int) {
+        let left = nodes[nodes[index].left]
+        let right = nodes[nodes[index].right]
+        nodes[index].frame = DrawSubgraphicHierarchy.union(left.frame, right.frame)
+        nodes[index].bounds = DrawSubgraphicHierarchy.union(left.bounds, right.bounds)
+        nodes[index].height = 1 + max(left.height, right.height)
+    }
+
+    private func refit(from start: Int) {
+        var index = start
+        while index != -1 {
+            index = balance(index)
+            fit(index)
+            index = nodes[index].parent
+        }
+    }
+
+    /// If the subtree at `a` leans by more than one level, rotates its taller child up. Returns the subtree's new root.
+    private func balance(_ a: Int) -> Int {
+        if nodes[a].isLeaf || nodes[a].height < 2 {
+            return a
+        }
+
+        let b = nodes[a].left
+        let c = nodes[a].right
+        let lean = nodes[c].height - nodes[b].height
+
+        if lean > 1 {
+            // Rotate c up. c keeps its taller child, and a takes the shorter one.
+            let f = nodes[c].left
+            let g = nodes[c].right
+            promote(c, over: a)
+            nodes[c].left = a
+            if nodes[f].height > nodes[g].height {
+                nodes[c].right = f
+                nodes[a].right = g
+                nodes[g].parent = a
+            } else {
+                nodes[c].right = g
+                nodes[a].right = f
+                nodes[f].parent = a
+            }
+            fit(a)
+            fit(c)
+            return c
+        }
+
+        if lean < -1 {
+            // Rotate b up, the mirror of the above.
+            let d = nodes[b].left
+            let e = nodes[b].right
+            promote(b, over: a)
+            nodes[b].left = a
+            if nodes[d].height > nodes[e].height {
+                nodes[b].right = d
+                nodes[a].left = e
+                nodes[e].parent = a
+            } else {
+                nodes[b].right = e
+                nodes[a].left = d
+                nodes[d].parent = a
+            }
+            fit(a)
+            fit(b)
+            return b
+        }
+
+        return a
+    }
+
+    /// Puts `child` where `parent` was in the tree, and makes `parent` its child.
+    private func promote(_ child: Int, over parent: Int) {
+        let grandparent = nodes[parent].parent
+        nodes[child].parent = grandparent
+        nodes[parent].parent = child
+        if grandparent == -1 {
+            root = child
+        } else {
+            replaceChild(parent, of: grandparent, with: child)
+        }
+    }
+
+}
@@ -113,6 +113,9 @@ typedef NSString * DrawToolIdentifier NS_TYPED_EXTENSIBLE_ENUM;
 - (BOOL)helpRequested:(DrawEvent *)event;
 - (nullable NSMenu *)menuForEvent:(DrawEvent *)event;
 
+/*! Called on the main thread when the page's hover tester finds a different graphic or selection handle under the mouse. Read the new values from the page's hoverTester. The default does nothing. If you draw hover feedback, draw it with a guest drawer and invalidate it with -[DrawPage setOverlayNeedsDisplayInRect:], so hovering never redraws the page's graphics. */
+- (void)hoverDidChangeOnPage:(DrawPage *)page NS_SWIFT_NAME(hoverDidChange(on:));
+
 #pragma mark - Activation
 
 - (BOOL)toolShouldActivateForDocument:(DrawDocument *)document;
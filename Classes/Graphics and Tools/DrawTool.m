@@ -260,8 +260,8 @@ static NSMutableDictionary *_tools = nil;
         _newGraphicRect.origin.x += _newGraphicOffset.x;
         _newGraphicRect.origin.y += _newGraphicOffset.y;
         if (!NSEqualRects(oldRect, _newGraphicRect)) {
-            [event.page setNeedsDisplayInRect:oldRect];
-            [event.page setNeedsDisplayInRect:_newGraphicRect];
+            [event.page setOverlayNeedsDisplayInRect:oldRect];
+            [event.page setOverlayNeedsDisplayInRect:_newGraphicRect];
         }
     }
     return NO;
@@ -278,7 +278,7 @@ static NSMutableDictionary *_tools = nil;
         [page removeGraphic:tempGraphic];
     }];
     if (needsDisplay) {
-        [_newGraphicPage setNeedsDisplayInRect:_newGraphicRect];
+        [_newGraphicPage setOverlayNeedsDisplayInRect:_newGraphicRect];
     }
 }
 
@@ -296,7 +296,7 @@ static NSMutableDictionary *_tools = nil;
             [strongSelf->_newGraphicImage drawInRect:strongSelf->_newGraphicRect fromRect:(NSRect){NSZeroPoint, strongSelf->_newGraphicImage.size} operation:NSCompositingOperationSourceOver fraction:0.5 respectFlipped:YES hints:nil];
         }
     }];
-    [_newGraphicPage setNeedsDisplayInRect:_newGraphicRect];
+    [_newGraphicPage setOverlayNeedsDisplayInRect:_newGraphicRect];
 }
 
 - (BOOL)mouseEntered:(DrawEvent *)event {
@@ -314,7 +314,7 @@ static NSMutableDictionary *_tools = nil;
         [_newGraphicPage removeGuestDrawer:_newGraphicToken];
         _newGraphicToken = nil;
         _newGraphicImage = nil;
-        [_newGraphicPage setNeedsDisplayInRect:_newGraphicRect];
+        [_newGraphicPage setOverlayNeedsDisplayInRect:_newGraphicRect];
         _newGraphicRect = NSZeroRect;
         return YES;
     }
@@ -362,6 +362,9 @@ static NSMutableDictionary *_tools = nil;
     return nil;
 }
 
+- (void)hoverDidChangeOnPage:(DrawPage *)page {
+}
+
 #pragma mark - Icon
 
 - (NSImage *)icon {
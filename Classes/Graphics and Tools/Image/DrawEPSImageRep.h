@@ -40,4 +40,11 @@
 - (NSMutableArray *)actions;
 - (void)setActions:(NSMutableArray *)actions;
 
+// Interpreting the EPS is expensive, so the recorded display list is shared by
+// every rep with the same EPS content, and rasterized copies are kept per device
+// scale so that repeated screen draws are just a blit.
++ (void)flushDisplayListCache;
+- (NSString *)displayListKey;
+- (void)flushRasterCache;
+
 @end
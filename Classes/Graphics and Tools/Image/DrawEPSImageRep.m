@@ -43,6 +43,26 @@
 static PSInterpreter		*_drawInterpreter = nil;
 static NSMutableArray	*_drawActions = nil;
 static NSLock				*_drawLock = nil;
+static NSMutableDictionary	*_displayLists = nil;
+
+// Don't keep rasters for absurd zoom levels, just replay the display list.
+#define DrawEPSMaxRasterPixels	(4096 * 4096)
+
+static NSString *DrawEPSContentHash(NSData *data)
+{
+   const unsigned char	*bytes = [data bytes];
+   NSUInteger				length = [data length];
+   NSUInteger				x;
+   uint64_t					hash = 0xcbf29ce484222325ULL;
+   
+   // FNV-1a over the whole EPS. -[NSData hash] only looks at the first few bytes.
+   for (x = 0; x < length; x++) {
+      hash ^= bytes[x];
+      hash *= 0x100000001b3ULL;
+   }
+   
+   return [NSString stringWithFormat:@"%016llx-%lu", (unsigned long long)hash, (unsigned long)length];
+}
 
 @implementation DrawEPSImageRep
 
@@ -51,40 +71,144 @@ static NSLock				*_drawLock = nil;
    [self poseAsClass:[NSEPSImageRep class]];
 }
 
-- (BOOL)draw
++ (void)flushDisplayListCache
+{
+   [_drawLock lock];
+   [_displayLists removeAllObjects];
+   [_drawLock unlock];
+}
+
+- (NSString *)displayListKey
+{
+   NSString		*key = [self instanceObjectForKey:@"displayListKey"];
+   
+   if (!key) {
+      key = DrawEPSContentHash([self EPSRepresentation]);
+      [self setInstanceObject:key forKey:@"displayListKey"];
+   }
+   
+   return key;
+}
+
+- (NSMutableArray *)_recordActions
+{
+   NSMutableArray		*actions = [NSMutableArray array];
+   
+   NS_DURING
+      if (!_drawInterpreter) {
+         _drawInterpreter = [[PSInterpreter alloc] init];
+      }
+      _drawActions = [actions retain];
+      [_drawInterpreter setDelegate:self];
+      [_drawInterpreter setString:[[[NSString alloc] initWithData:[self EPSRepresentation] encoding:NSISOLatin1StringEncoding] autorelease]];
+      [_drawInterpreter prepareForExecution];
+      [_drawInterpreter execute];
+      [_drawInterpreter setString:nil];
+      [_drawInterpreter setDelegate:nil];
+      [_drawActions release]; _drawActions = nil;
+   NS_HANDLER
+      // Ignore the error states.
+      [_drawActions release]; _drawActions = nil;
+   NS_ENDHANDLER
+   
+   return actions;
+}
+
+- (NSMutableArray *)_displayList
 {
    NSMutableArray		*actions = [self actions];
-   NSGraphicsContext	*context;
    
    if (!actions) {
-      [self setActions:[NSArray array]];
-      actions = [self actions];
+      NSString		*key = [self displayListKey];
+      
       if (!_drawLock) {
          _drawLock = [[NSLock alloc] init];
       }
       [_drawLock lock];
-      NS_DURING
-         if (!_drawInterpreter) {
-            _drawInterpreter = [[PSInterpreter alloc] init];
-         }
-         _drawActions = [actions retain];
-         [_drawInterpreter setDelegate:self];
-         [_drawInterpreter setString:[[[NSString alloc] initWithData:[self EPSRepresentation] encoding:NSISOLatin1StringEncoding] autorelease]];
-         [_drawInterpreter prepareForExecution];
-         [_drawInterpreter execute];
-         [_drawInterpreter setString:nil];
-         [_drawInterpreter setDelegate:nil];
-         [_drawActions release]; _drawActions = nil;
-      NS_HANDLER
-         // Ignore the error states.
-      NS_ENDHANDLER
+      if (!_displayLists) {
+         _displayLists = [[NSMutableDictionary alloc] init];
+      }
+      actions = [_displayLists objectForKey:key];
+      if (!actions) {
+         actions = [self _recordActions];
+         [_displayLists setObject:actions forKey:key];
+      }
       [_drawLock unlock];
+      // Share the list rather than copying it, it's never mutated after recording.
+      [self setInstanceObject:actions forKey:@"actions"];
    }
    
-   context = [NSGraphicsContext currentContext];
+   return actions;
+}
+
+- (void)_playDisplayList:(NSArray *)actions inContext:(NSGraphicsContext *)context
+{
    [[NSColor blackColor] set];
    [context prepareForPSExecution];
    [actions makeObjectsPerformSelector:@selector(performWithContext:) withObject:context];
+}
+
+- (void)flushRasterCache
+{
+   [self setInstanceObject:nil forKey:@"rasters"];
+}
+
+- (NSBitmapImageRep *)_rasterForScale:(CGFloat)scale
+{
+   NSMutableDictionary	*rasters = [self instanceObjectForKey:@"rasters"];
+   NSNumber					*key = [NSNumber numberWithDouble:scale];
+   NSBitmapImageRep		*raster = [rasters objectForKey:key];
+   
+   if (!raster) {
+      NSSize					size = [self size];
+      NSInteger				width = (NSInteger)ceil(size.width * scale);
+      NSInteger				height = (NSInteger)ceil(size.height * scale);
+      NSGraphicsContext		*context;
+      
+      if (width <= 0 || height <= 0 || width * height > DrawEPSMaxRasterPixels) {
+         return nil;
+      }
+      
+      raster = [[[NSBitmapImageRep alloc] initWithBitmapDataPlanes:NULL pixelsWide:width pixelsHigh:height bitsPerSample:8 samplesPerPixel:4 hasAlpha:YES isPlanar:NO colorSpaceName:NSDeviceRGBColorSpace bytesPerRow:0 bitsPerPixel:0] autorelease];
+      [raster setSize:size];
+      
+      context = [NSGraphicsContext graphicsContextWithBitmapImageRep:raster];
+      [NSGraphicsContext saveGraphicsState];
+      [NSGraphicsContext setCurrentContext:context];
+      CGContextScaleCTM([context CGContext], scale, scale);
+      [self _playDisplayList:[self _displayList] inContext:context];
+      [NSGraphicsContext restoreGraphicsState];
+      
+      if (!rasters) {
+         rasters = [NSMutableDictionary dictionary];
+         [self setInstanceObject:rasters forKey:@"rasters"];
+      }
+      [rasters setObject:raster forKey:key];
+   }
+   
+   return raster;
+}
+
+- (BOOL)draw
+{
+   NSMutableArray		*actions = [self _displayList];
+   NSGraphicsContext	*context = [NSGraphicsContext currentContext];
+   
+   if ([context isDrawingToScreen]) {
+      CGAffineTransform	transform = CGContextGetUserSpaceToDeviceSpaceTransform([context CGContext]);
+      CGFloat				scale = sqrt(fabs(transform.a * transform.d - transform.b * transform.c));
+      NSBitmapImageRep	*raster;
+      
+      // Quantize so that a live zoom doesn't grow a raster per frame.
+      scale = ceil(scale * 4.0) / 4.0;
+      raster = [self _rasterForScale:scale];
+      if (raster) {
+         return [raster drawInRect:(NSRect){NSZeroPoint, [self size]}];
+      }
+   }
+   
+   // Printing and PDF generation always go through the vector display list.
+   [self _playDisplayList:actions inContext:context];
    /* Need an implementation for this
    [[NSGraphicsContext currentContext] printFormat:@"clippath true setglobal /__ClippingUPath%d [ false upath ] /Generic defineresource false setglobal\n", getpid()];
    */
@@ -110,6 +234,7 @@ static NSLock				*_drawLock = nil;
    
    [self setInstanceObject:temp forKey:@"actions"];
    [temp release];
+   [self flushRasterCache];
 }
 
 - (void)interpreter:(PSInterpreter *)sender recordAction:(id <PSAction>)action
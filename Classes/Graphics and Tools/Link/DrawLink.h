@@ -39,6 +39,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 extern const AJRInspectorIdentifier AJRInspectorIdentifierLink;
 
+typedef NS_ENUM(uint8_t, DrawLinkRouting) {
+    DrawLinkRoutingStraight,   // A straight line, or whatever points the user added, between the ends.
+    DrawLinkRoutingOrthogonal, // Horizontal and vertical runs that go around other graphics. See DrawLinkRouter.
+};
+
 @interface DrawLink : DrawPen <AJRXMLCoding>
 
 - (id)initWithSource:(nullable DrawGraphic *)sourceGraphic;
@@ -59,6 +64,16 @@ extern const AJRInspectorIdentifier AJRInspectorIdentifierLink;
 - (void)updateDestinationPoint;
 @property (nullable,nonatomic,strong) DrawLinkCap *destinationCap;
 
+/*!
+ Recomputes the ends of the link after its source and/or destination changed shape, with a single bounds update and redisplay at the end. Straight links aim each end at the other, so changing either end of a line updates both.
+
+ You don't normally call this directly. Shape changes are batched by DrawLinkUpdater, which calls this once per link at the end of the event loop.
+ */
+- (void)updateEndpointsForChangedSource:(BOOL)sourceChanged destination:(BOOL)destinationChanged;
+
+/*! How the link gets from its source to its destination. Orthogonal routing only applies while the link is attached at both ends; otherwise the link behaves as a straight link. */
+@property (nonatomic,assign) DrawLinkRouting routing;
+
 - (CGFloat)angleInDegreesOfSourceSegment;
 - (CGFloat)angleInDegreesOfDestinationSegment;
 
@@ -68,4 +83,7 @@ extern const AJRInspectorIdentifier AJRInspectorIdentifierLink;
 
 @end
 
+extern NSString *DrawStringFromDrawLinkRouting(DrawLinkRouting routing);
+extern DrawLinkRouting DrawLinkRoutingFromString(NSString *string);
+
 NS_ASSUME_NONNULL_END
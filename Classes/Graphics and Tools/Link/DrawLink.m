@@ -86,6 +86,7 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
 @implementation DrawLink {
     NSPoint _sourceAttachmentPoint; // Where we want to be attached. Either one of source's handles or source's centroid.
     NSPoint _destinationAttachmentPoint;
+    BOOL _updatingEndpoints; // While set, setting an end point doesn't update bounds or redisplay; updateEndpointsForChangedSource:destination: does that once at the end.
 }
 
 - (id)init {
@@ -187,6 +188,10 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
 }
 
 - (void)updateSourcePoint {
+    if ([self _routesOrthogonally]) {
+        [self _updateOrthogonalRoute];
+        return;
+    }
     if (_source) {
         if (_sourceHandle.type != DrawHandleTypeIndexed) {
             _sourceAttachmentPoint = [_source centroid];
@@ -222,6 +227,10 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
 }
 
 - (void)updateDestinationPoint {
+    if ([self _routesOrthogonally]) {
+        [self _updateOrthogonalRoute];
+        return;
+    }
     if (_destination) {
         if (_destinationHandle.type != DrawHandleTypeIndexed) {
             NSInteger pointCount = [_path pointCount];
@@ -258,6 +267,119 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
     }
 }
 
+- (void)_updateAttachmentPoints {
+    if (_source) {
+        _sourceAttachmentPoint = _sourceHandle.type == DrawHandleTypeIndexed ? [_source pointForHandle:_sourceHandle] : [_source centroid];
+    }
+    if (_destination) {
+        _destinationAttachmentPoint = _destinationHandle.type == DrawHandleTypeIndexed ? [_destination pointForHandle:_destinationHandle] : [_destination centroid];
+    }
+}
+
+- (void)updateEndpointsForChangedSource:(BOOL)sourceChanged destination:(BOOL)destinationChanged {
+    BOOL isLine = [self isLine];
+    BOOL updateSource = sourceChanged || (destinationChanged && isLine);
+    BOOL updateDestination = destinationChanged || (sourceChanged && isLine);
+
+    if (!updateSource && !updateDestination) {
+        return;
+    }
+
+    // Where we were needs redrawing as well as where we end up.
+    [self setNeedsDisplay];
+
+    _updatingEndpoints = YES;
+    if ([self _routesOrthogonally]) {
+        // Moving either end can change the whole route.
+        [self _updateOrthogonalRoute];
+    } else {
+        if (updateSource && updateDestination) {
+            // Each end of a line aims at the other's attachment point, so get both current before computing either intersection.
+            [self _updateAttachmentPoints];
+        }
+        if (updateSource) {
+            [self updateSourcePoint];
+        }
+        if (updateDestination) {
+            [self updateDestinationPoint];
+        }
+    }
+    _updatingEndpoints = NO;
+
+    [self updateBounds];
+    [self setNeedsDisplay];
+}
+
+#pragma mark - Routing
+
+- (void)setRouting:(DrawLinkRouting)routing {
+    if (_routing != routing) {
+        __weak DrawLink *weakSelf = self;
+        DrawLinkRouting undoRouting = _routing;
+        AJRBezierPath *undoPath = [_path copy];
+        [self.document registerUndoWithTarget:self handler:^(id  _Nonnull target) {
+            DrawLink *strongSelf = weakSelf;
+            if (strongSelf != nil) {
+                [strongSelf setRouting:undoRouting];
+                [strongSelf setPath:undoPath];
+                [strongSelf updateBounds];
+            }
+        }];
+
+        _routing = routing;
+        if (_routing == DrawLinkRoutingStraight) {
+            [[self.page linkRouter] linkDidStopRouting:self];
+            if ([_path elementCount] > 2) {
+                // Drop the route's corners, and let the ends find each other again.
+                NSPoint start = [_path pointAtIndex:0];
+                NSPoint end = [_path pointAtIndex:[_path pointCount] - 1];
+                [self setNeedsDisplay];
+                [_path removeAllPoints];
+                [_path moveToPoint:start];
+                [_path lineToPoint:end];
+            }
+        }
+        [self updateEndpointsForChangedSource:YES destination:YES];
+    }
+}
+
+- (BOOL)_routesOrthogonally {
+    // While the link is being created, the user is still placing its points.
+    return _routing == DrawLinkRoutingOrthogonal && _source != nil && _destination != nil && self.page != nil && !self.creating;
+}
+
+- (void)_updateOrthogonalRoute {
+    NSArray<NSValue *> *route = [[self.page linkRouter] routeForLink:self];
+    if ([route count] < 2) {
+        return;
+    }
+
+    BOOL wasUpdating = _updatingEndpoints;
+    if (!wasUpdating) {
+        [self setNeedsDisplay];
+    }
+    _updatingEndpoints = YES;
+
+    [_path removeAllPoints];
+    [_path moveToPoint:[route[0] pointValue]];
+    for (NSInteger x = 1; x < (NSInteger)[route count]; x++) {
+        [_path lineToPoint:[route[x] pointValue]];
+    }
+    // The route already ends on the graphics' edges, so that's where we're attached.
+    _sourceAttachmentPoint = [[route firstObject] pointValue];
+    _destinationAttachmentPoint = [[route lastObject] pointValue];
+    [self setSourcePoint:_sourceAttachmentPoint];
+    [self setDestinationPoint:_destinationAttachmentPoint];
+
+    _updatingEndpoints = wasUpdating;
+    if (!wasUpdating) {
+        [self updateBounds];
+        [self setNeedsDisplay];
+    }
+}
+
+#pragma mark - Source and Destination
+
 - (void)setSource:(DrawGraphic *)source withHandle:(DrawHandle)handle {
     if (_source != source) {
         if (_source) {
@@ -290,8 +412,10 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
     if (_sourceCap) [_sourceCap update];
     if (_destinationCap) [_destinationCap update];
 
-    [self updateBounds];
-    [self setNeedsDisplay];
+    if (!_updatingEndpoints) {
+        [self updateBounds];
+        [self setNeedsDisplay];
+    }
 }
 
 - (NSPoint)adjustedSourcePoint {
@@ -336,8 +460,10 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
     if (_destinationCap) {
         [_destinationCap update];
     }
-    [self updateBounds];
-    [self setNeedsDisplay];
+    if (!_updatingEndpoints) {
+        [self updateBounds];
+        [self setNeedsDisplay];
+    }
 }
 
 - (NSPoint)adjustedDestinationPoint {
@@ -473,6 +599,9 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
 
     if (_destination) {
         self.creating = NO;
+        if (_routing == DrawLinkRoutingOrthogonal) {
+            [self updateEndpointsForChangedSource:YES destination:YES];
+        }
         return YES;
     }
 
@@ -575,23 +704,27 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
 }
 
 - (void)graphicDidChangeShape:(DrawGraphic *)graphic {
-    if (graphic == _source) {
-        [self updateSourcePoint];
-        if ([self isLine]) {
-            [self updateDestinationPoint];
-        }
-    } else if (graphic == _destination) {
-        [self updateDestinationPoint];
-        if ([self isLine]) {
-            [self updateSourcePoint];
-        }
-    }
+    [self updateEndpointsForChangedSource:graphic == _source destination:graphic != _source && graphic == _destination];
 }
 
 - (void)setFrame:(NSRect)frame {
     [super setFrame:frame];
-    [self graphicDidChangeShape:_source];
-    [self graphicDidChangeShape:_destination];
+    // A move may only have been recorded as a path offset, and we're about to read and rewrite our ends.
+    [self bakePathTransform];
+    [self updateEndpointsForChangedSource:YES destination:YES];
+}
+
+- (void)updateBounds {
+    [super updateBounds];
+    // Our ends cache the union of their links' bounds.
+    [_source noteRelatedBoundsAreDirty];
+    [_destination noteRelatedBoundsAreDirty];
+}
+
+- (void)noteBoundsAreDirty {
+    [super noteBoundsAreDirty];
+    [_source noteRelatedBoundsAreDirty];
+    [_destination noteRelatedBoundsAreDirty];
 }
 
 - (void)graphicWillRemoveFromDocument:(DrawDocument *)document {
@@ -624,6 +757,7 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
         new->_destinationCap = [_destinationCap copyWithZone:aZone];
         new->_sourceAttachmentPoint = _sourceAttachmentPoint;
         new->_destinationAttachmentPoint = _destinationAttachmentPoint;
+        new->_routing = _routing;
     }
     return new;
 }
@@ -663,6 +797,9 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
     [coder decodeObjectForKey:@"destinationCap" setter:^(id  _Nonnull object) {
         self->_destinationCap = object;
     }];
+    [coder decodeStringForKey:@"routing" setter:^(NSString * _Nonnull string) {
+        self->_routing = DrawLinkRoutingFromString(string);
+    }];
 }
 
 - (void)encodeWithXMLCoder:(AJRXMLCoder *)coder {
@@ -678,6 +815,9 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
     [coder encodePoint:_destinationPoint forKey:@"destinationPoint"];
     [coder encodePoint:_destinationAttachmentPoint forKey:@"destinationAttachmentPoint"];
     [coder encodeObject:_destinationCap forKey:@"destinationCap"];
+    if (_routing != DrawLinkRoutingStraight) {
+        [coder encodeString:DrawStringFromDrawLinkRouting(_routing) forKey:@"routing"];
+    }
 }
 
 - (id)finalizeXMLDecodingWithError:(NSError * _Nullable __autoreleasing *)error {
@@ -705,7 +845,8 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
             && NSEqualPoints(_destinationPoint, other->_destinationPoint)
             && NSEqualPoints(_destinationAttachmentPoint, other->_destinationAttachmentPoint)
             && AJREqual(_destinationCap, other->_destinationCap)
-            && _destinationCap.link == self);
+            && _destinationCap.link == self
+            && _routing == other->_routing);
 }
 
 - (BOOL)isEqual:(id)other {
@@ -848,3 +989,18 @@ const AJRInspectorIdentifier AJRInspectorIdentifierLink = @"link";
 }
 
 @end
+
+NSString *DrawStringFromDrawLinkRouting(DrawLinkRouting routing) {
+    switch (routing) {
+        case DrawLinkRoutingStraight:   return @"straight";
+        case DrawLinkRoutingOrthogonal: return @"orthogonal";
+    }
+    return @"straight";
+}
+
+DrawLinkRouting DrawLinkRoutingFromString(NSString *string) {
+    if ([string isEqualToString:@"orthogonal"]) {
+        return DrawLinkRoutingOrthogonal;
+    }
+    return DrawLinkRoutingStraight;
+}
@@ -0,0 +1,412 @@
+/*
+ DrawLinkRouter.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Routes orthogonal links around the other graphics on a page.
+
+ Each page has one router, which keeps two spatial indexes: the bounds of the page's graphics, which are the obstacles, and the corridor each orthogonal link was last routed through. Routing a link only considers the obstacles inside its corridor, and when a graphic moves, only the links whose corridors it left or entered need routing again, along with the links attached to it, which `DrawLinkUpdater` already knows about.
+
+ The route itself is a shortest path, with a penalty per bend, over the grid of lines that run just outside the edges of the source, the destination and the obstacles. Links leave and enter their graphics at the middle of a side.
+ */
+@objcMembers
+open class DrawLinkRouter : NSObject {
+
+    /// How far routes stay away from the graphics they pass.
+    public static var margin : CGFloat = 12.0
+    /// Routing only looks at this many obstacles, the ones nearest the link, so a link across a dense page costs about the same as one across an empty page.
+    public static var maximumObstacles = 24
+    /// Beyond this many grid points we don't search, and fall back to a simple elbow.
+    internal static let maximumGridSize = 4096
+
+    open private(set) weak var page : DrawPage?
+    internal let obstacles = DrawSpatialIndex<DrawGraphic>()
+    internal let corridors = DrawSpatialIndex<DrawLink>()
+    internal private(set) var obstaclesAreLoaded = false
+
+    public init(page: DrawPage) {
+        self.page = page
+        super.init()
+    }
+
+    // MARK: - Page Changes
+
+    internal func isObstacle(_ graphic: DrawGraphic) -> Bool {
+        return !(graphic is DrawLink)
+    }
+
+    internal func loadObstaclesIfNeeded() {
+        guard !obstaclesAreLoaded, let page, let document = page.document else { return }
+        for layer in document.layers where layer.visible {
+            for graphic in page.graphics(for: layer) as? [DrawGraphic] ?? [] where isObstacle(graphic) {
+                obstacles.insert(graphic, rect: graphic.bounds)
+            }
+        }
+        obstaclesAreLoaded = true
+    }
+
+    open func graphicWasAdded(_ graphic: DrawGraphic) {
+        if obstaclesAreLoaded && isObstacle(graphic) {
+            obstacles.insert(graphic, rect: graphic.bounds)
+        }
+    }
+
+    open func graphicWasRemoved(_ graphic: DrawGraphic) {
+        if let link = graphic as? DrawLink {
+            corridors.remove(link)
+        } else {
+            obstacles.remove(graphic)
+        }
+    }
+
+    /**
+     Updates `graphic`'s entry in the obstacle index and returns the orthogonal links whose corridors it moved into or out of. Links attached to `graphic` aren't included, since they're updated anyway.
+     */
+    open func graphicDidChangeShape(_ graphic: DrawGraphic) -> [DrawLink] {
+        guard obstaclesAreLoaded, isObstacle(graphic), let oldRect = obstacles.rect(for: graphic) else {
+            return []
+        }
+        let newRect = graphic.bounds
+        if oldRect == newRect {
+            return []
+        }
+        obstacles.insert(graphic, rect: newRect)
+        if corridors.count == 0 {
+            return []
+        }
+        return corridors.elements(intersecting: oldRect.union(newRect)).filter { $0.source !== graphic && $0.destination !== graphic }
+    }
+
+    // MARK: - Routing
+
+    /// Returns the points of an orthogonal route for `link`, from the edge of its source to the edge of its destination, or `nil` if the link isn't attached at both ends.
+    @objc(routeForLink:)
+    open func route(for link: DrawLink) -> [NSValue]? {
+        guard let source = link.source, let destination = link.destination else {
+            corridors.remove(link)
+            return nil
+        }
+        loadObstaclesIfNeeded()
+
+        let margin = DrawLinkRouter.margin
+        let sourceFrame = source.frame
+        let destinationFrame = destination.frame
+        let corridor = sourceFrame.union(destinationFrame).insetBy(dx: -4.0 * margin, dy: -4.0 * margin)
+        let center = NSPoint(x: corridor.midX, y: corridor.midY)
+
+        var nearby = obstacles.elements(intersecting: corridor).compactMap { graphic -> NSRect? in
+            if graphic === source || graphic === destination || graphic.ignore {
+                return nil
+            }
+            return graphic.frame
+        }
+        if nearby.count > DrawLinkRouter.maximumObstacles {
+            nearby.sort { hypot($0.midX - center.x, $0.midY - center.y) < hypot($1.midX - center.x, $1.midY - center.y) }
+            nearby.removeLast(nearby.count - DrawLinkRouter.maximumObstacles)
+        }
+
+        let points = DrawLinkRouter.orthogonalRoute(from: sourceFrame, to: destinationFrame, avoiding: nearby, margin: margin)
+        var routeBounds = corridor
+        for point in points {
+            routeBounds = routeBounds.union(NSRect(origin: point, size: .zero))
+        }
+        corridors.insert(link, rect: routeBounds)
+
+        return points.map { NSValue(point: $0) }
+    }
+
+    /// Forgets `link`'s corridor, for example when it stops routing orthogonally.
+    open func linkDidStopRouting(_ link: DrawLink) {
+        corridors.remove(link)
+    }
+
+    // MARK: - Search
+
+    internal enum Direction : Int, CaseIterable {
+        case right = 0, up, left, down
+
+        var reversed : Direction {
+            return Direction(rawValue: (rawValue + 2) % 4)!
+        }
+    }
+
+    internal struct Port {
+        var point : NSPoint
+        var stub : NSPoint
+        /// The direction pointing away from the graphic.
+        var direction : Direction
+    }
+
+    internal class func ports(for rect: NSRect, margin: CGFloat) -> [Port] {
+        return [
+            Port(point: NSPoint(x: rect.maxX, y: rect.midY), stub: NSPoint(x: rect.maxX + margin, y: rect.midY), direction: .right),
+            Port(point: NSPoint(x: rect.midX, y: rect.maxY), stub: NSPoint(x: rect.midX, y: rect.maxY + margin), direction: .up),
+            Port(point: NSPoint(x: rect.minX, y: rect.midY), stub: NSPoint(x: rect.minX - margin, y: rect.midY), direction: .left),
+            Port(point: NSPoint(x: rect.midX, y: rect.minY), stub: NSPoint(x: rect.midX, y: rect.minY - margin), direction: .down),
+        ]
+    }
+
+    /// Sorted, with values closer than half a point merged.
+    internal class func gridLines(_ values: [CGFloat]) -> [CGFloat] {
+        var lines = [CGFloat]()
+        for value in values.sorted() where lines.last.map({ value - $0 > 0.5 }) ?? true {
+            lines.append(value)
+        }
+        return lines
+    }
+
+    /**
+     Finds an orthogonal route from `source` to `destination` that stays `margin` clear of `obstacles`, and of the source and destination themselves, preferring short routes with few bends.
+
+     - returns: The route's points, starting on an edge of `source` and ending on an edge of `destination`. If no route is found, a simple elbow between the facing sides.
+     */
+    internal class func orthogonalRoute(from source: NSRect, to destination: NSRect, avoiding obstacles: [NSRect], margin: CGFloat) -> [NSPoint] {
+        let sourcePorts = ports(for: source, margin: margin)
+        let destinationPorts = ports(for: destination, margin: margin)
+        let solids = obstacles + [source, destination]
+        let blocked = solids.map { $0.insetBy(dx: 1.0 - margin, dy: 1.0 - margin) }
+
+        var xValues = [(source.midX + destination.midX) / 2.0]
+        var yValues = [(source.midY + destination.midY) / 2.0]
+        if source.maxX < destination.minX { xValues.append((source.maxX + destination.minX) / 2.0) }
+        if destination.maxX < source.minX { xValues.append((destination.maxX + source.minX) / 2.0) }
+        if source.maxY < destination.minY { yValues.append((source.maxY + destination.minY) / 2.0) }
+        if destination.maxY < source.minY { yValues.append((destination.maxY + source.minY) / 2.0) }
+        for rect in solids {
+            xValues.append(rect.minX - margin); xValues.append(rect.maxX + margin)
+            yValues.append(rect.minY - margin); yValues.append(rect.maxY + margin)
+        }
+        for port in sourcePorts + destinationPorts {
+            xValues.append(port.stub.x)
+            yValues.append(port.stub.y)
+        }
+        let xs = gridLines(xValues)
+        let ys = gridLines(yValues)
+
+        guard xs.count * ys.count <= maximumGridSize,
+              let route = search(xs: xs, ys: ys, blocked: blocked, sourcePorts: sourcePorts, destinationPorts: destinationPorts, margin: margin) else {
+            return elbow(from: source, to: destination)
+        }
+        return simplify(route)
+    }
+
+    internal class func search(xs: [CGFloat], ys: [CGFloat], blocked: [NSRect], sourcePorts: [Port], destinationPorts: [Port], margin: CGFloat) -> [NSPoint]? {
+        let columns = xs.count
+        let nodeCount = xs.count * ys.count
+        let goalBase = nodeCount * 4
+        let bendPenalty = 2.0 * margin
+
+        func index(of point: NSPoint) -> Int? {
+            guard let x = xs.firstIndex(where: { abs($0 - point.x) <= 0.5 }), let y = ys.firstIndex(where: { abs($0 - point.y) <= 0.5 }) else {
+                return nil
+            }
+            return y * columns + x
+        }
+        func point(of node: Int) -> NSPoint {
+            return NSPoint(x: xs[node % columns], y: ys[node / columns])
+        }
+        func isOpen(_ a: NSPoint, _ b: NSPoint) -> Bool {
+            let minX = min(a.x, b.x), maxX = max(a.x, b.x), minY = min(a.y, b.y), maxY = max(a.y, b.y)
+            for rect in blocked where rect.minX < maxX && rect.maxX > minX && rect.minY < maxY && rect.maxY > minY {
+                return false
+            }
+            // A zero length run still has to be outside everything.
+            for rect in blocked where minX == maxX && minY == maxY && rect.contains(a) {
+                return false
+            }
+            return true
+        }
+        func neighbor(of node: Int, _ direction: Direction) -> Int? {
+            let x = node % columns, y = node / columns
+            switch direction {
+            case .right: return x + 1 < columns ? node + 1 : nil
+            case .left:  return x > 0 ? node - 1 : nil
+            case .up:    return y + 1 < ys.count ? node + columns : nil
+            case .down:  return y > 0 ? node - columns : nil
+            }
+        }
+
+        let goals = destinationPorts.compactMap { port -> (node: Int, port: Port)? in
+            guard let node = index(of: port.stub), isOpen(port.stub, port.stub) else { return nil }
+            return (node, port)
+        }
+        if goals.isEmpty {
+            return nil
+        }
+        func heuristic(_ node: Int) -> CGFloat {
+            let p = point(of: node)
+            return goals.map { abs($0.port.stub.x - p.x) + abs($0.port.stub.y - p.y) }.min()! + margin
+        }
+
+        var best = [Int:CGFloat]()
+        var previous = [Int:Int]()
+        var heap = DrawRouteHeap()
+
+        for port in sourcePorts {
+            guard let node = index(of: port.stub), isOpen(port.stub, port.stub) else { continue }
+            let state = node * 4 + port.direction.rawValue
+            best[state] = margin
+            heap.push(margin + heuristic(node), cost: margin, state: state)
+        }
+
+        while let entry = heap.pop() {
+            let cost = entry.cost
+            let state = entry.state
+            if cost > best[state] ?? .greatestFiniteMagnitude {
+                continue
+            }
+            if state >= goalBase {
+                // Walk back from the goal to a source stub.
+                let goal = goals[state - goalBase]
+                var route = [goal.port.point]
+                var current = previous[state]!
+                while true {
+                    route.append(point(of: current / 4))
+                    guard let prior = previous[current] else { break }
+                    current = prior
+                }
+                let start = current / 4
+                let startDirection = Direction(rawValue: current % 4)!
+                let port = sourcePorts.first { $0.direction == startDirection && index(of: $0.stub) == start }!
+                route.append(port.point)
+                return route.reversed()
+            }
+
+            let node = state / 4
+            let direction = Direction(rawValue: state % 4)!
+
+            for (goalIndex, goal) in goals.enumerated() where goal.node == node && direction != goal.port.direction {
+                let total = cost + margin + (direction == goal.port.direction.reversed ? 0.0 : bendPenalty)
+                let goalState = goalBase + goalIndex
+                if total < best[goalState] ?? .greatestFiniteMagnitude {
+                    best[goalState] = total
+                    previous[goalState] = state
+                    heap.push(total, cost: total, state: goalState)
+                }
+            }
+
+            for next in Direction.allCases where next != direction.reversed {
+                guard let neighbor = neighbor(of: node, next) else { continue }
+                let from = point(of: node), to = point(of: neighbor)
+                if !isOpen(from, to) {
+                    continue
+                }
+                let nextCost = cost + abs(to.x - from.x) + abs(to.y - from.y) + (next == direction ? 0.0 : bendPenalty)
+                let nextState = neighbor * 4 + next.rawValue
+                if nextCost < best[nextState] ?? .greatestFiniteMagnitude {
+                    best[nextState] = nextCost
+                    previous[nextState] = state
+                    heap.push(nextCost + heuristic(neighbor), cost: nextCost, state: nextState)
+                }
+            }
+        }
+        return nil
+    }
+
+    /// Drops points in the middle of straight runs.
+    internal class func simplify(_ points: [NSPoint]) -> [NSPoint] {
+        var result = [NSPoint]()
+        for point in points {
+            if let last = result.last, abs(last.x - point.x) < 0.001 && abs(last.y - point.y) < 0.001 {
+                continue
+            }
+            if result.count >= 2 {
+                let a = result[result.count - 2], b = result[result.count - 1]
+                if (abs(a.x - b.x) < 0.001 && abs(b.x - point.x) < 0.001) || (abs(a.y - b.y) < 0.001 && abs(b.y - point.y) < 0.001) {
+                    result[result.count - 1] = point
+                    continue
+                }
+            }
+            result.append(point)
+        }
+        return result
+    }
+
+    /// A route that ignores obstacles: out of the side of `source` facing `destination`, across halfway, and into the facing side of `destination`.
+    internal class func elbow(from source: NSRect, to destination: NSRect) -> [NSPoint] {
+        let dx = destination.midX - source.midX
+        let dy = destination.midY - source.midY
+        if abs(dx) >= abs(dy) {
+            let start = NSPoint(x: dx >= 0.0 ? source.maxX : source.minX, y: source.midY)
+            let end = NSPoint(x: dx >= 0.0 ? destination.minX : destination.maxX, y: destination.midY)
+            let middle = (start.x + end.x) / 2.0
+            return simplify([start, NSPoint(x: middle, y: start.y), NSPoint(x: middle, y: end.y), end])
+        } else {
+            let start = NSPoint(x: source.midX, y: dy >= 0.0 ? source.maxY : source.minY)
+            let end = NSPoint(x: destination.midX, y: dy >= 0.0 ? destination.minY : destination.maxY)
+            let middle = (start.y + end.y) / 2.0
+            return simplify([start, NSPoint(x: start.x, y: middle), NSPoint(x: end.x, y: middle), end])
+        }
+    }
+
+}
+
+/// A binary min-heap of search states, ordered by estimated total cost.
+internal struct DrawRouteHeap {
+
+    private var entries = [(priority: CGFloat, cost: CGFloat, state: Int)]()
+
+    mutating func push(_ priority: CGFloat, cost: CGFloat, state: Int) {
+        entries.append((priority, cost, state))
+        var child = entries.count - 1
+        while child > 0 {
+            let parent = (child - 1) / 2
+            if entries[parent].priority <= entries[child].priority {
+                break
+            }
+            entries.swapAt(parent, child)
+            child = parent
+        }
+    }
+
+    mutating func pop() -> (priority: CGFloat, cost: CGFloat, state: Int)? {
+        guard let first = entries.first else { return nil }
+        let last = entries.removeLast()
+        if !entries.isEmpty {
+            entries[0] = last
+            var parent = 0
+            while true {
+                let left = 2 * parent + 1, right = left + 1
+                var smallest = parent
+                if left < entries.count && entries[left].priority < entries[smallest].priority { smallest = left }
+                if right < entries.count && entries[right].priority < entries[smallest].priority { smallest = right }
+                if smallest == parent {
+                    break
+                }
+                entries.swapAt(parent, smallest)
+                parent = smallest
+            }
+        }
+        return first
+    }
+
+}
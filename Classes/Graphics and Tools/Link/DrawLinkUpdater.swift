@@ -0,0 +1,168 @@
+/*
+ DrawLinkUpdater.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Batches shape changes, and the link updates they cause.
+
+ A graphic's `relatedGraphics` are the links attached to it, so it already is the dependency graph from graphics to links. What used to happen is that every change to a graphic told each of its links right away, and each link then recomputed the end that changed and, for straight links, the other end too, updating its bounds and dirtying the page after each step. Moving a hub with hundreds of links, or a selection that holds both ends of many links, repeated that work for every link several times per mouse event.
+
+ Now shape changes only mark the affected ends of each link as stale. At the end of the event loop, every stale link recomputes both its ends in one pass, with one bounds update and one redisplay. A link whose shape changes as a result tells its own related graphics the same way, so chains of links settle one step per event loop, never by recursion.
+ */
+@objcMembers
+open class DrawLinkUpdater : NSObject {
+
+    internal struct PendingUpdate {
+        var link : DrawLink
+        var sourceChanged : Bool
+        var destinationChanged : Bool
+    }
+
+    /// Main thread only, like the graphics it tracks.
+    internal static let shared = DrawLinkUpdater()
+
+    /// Graphics whose aspects haven't yet been told about a shape change, in the order they changed.
+    internal private(set) var changedGraphics = [DrawGraphic]()
+    private var changedGraphicIdentifiers = Set<ObjectIdentifier>()
+    /// Kept in the order links were first touched, so updates are deterministic.
+    internal private(set) var pending = [PendingUpdate]()
+    private var pendingIndexes = [ObjectIdentifier:Int]()
+    private var flushScheduled = false
+
+    /// More passes than this during a full flush means links are feeding each other changes, so we leave the rest for the event loop.
+    internal static let maximumFlushPasses = 64
+
+    // MARK: - Shape Changes
+
+    /// Queues telling `graphic`'s aspects and related graphics that its shape changed until the end of the event loop. This is what `-[DrawGraphic informAspectsOfShapeChange]` does.
+    @objc(scheduleShapeChangeOfGraphic:)
+    open class func scheduleShapeChange(of graphic: DrawGraphic) {
+        shared.scheduleShapeChange(of: graphic)
+    }
+
+    /// Tells `graphic`'s related graphics that its shape changed. Links are queued for the end of the event loop, anything else is told immediately, as before.
+    open class func graphicDidChangeShape(_ graphic: DrawGraphic) {
+        shared.graphicDidChangeShape(graphic)
+    }
+
+    /// Applies every queued shape change and link update now, including the ones they cause in turn, rather than at the end of the event loop. Call this before anything reads the document as a whole, such as saving, printing or exporting.
+    open class func flush() {
+        shared.flushAll()
+    }
+
+    internal var hasPendingChanges : Bool {
+        return !changedGraphics.isEmpty || !pending.isEmpty
+    }
+
+    internal func scheduleShapeChange(of graphic: DrawGraphic) {
+        if changedGraphicIdentifiers.insert(ObjectIdentifier(graphic)).inserted {
+            changedGraphics.append(graphic)
+        }
+        scheduleFlush()
+    }
+
+    internal func graphicDidChangeShape(_ graphic: DrawGraphic) {
+        for related in graphic.relatedGraphics {
+            if let link = related as? DrawLink {
+                enqueue(link, sourceChanged: link.source === graphic, destinationChanged: link.destination === graphic)
+            } else if related.responds(to: #selector(DrawAspect.graphicDidChangeShape(_:))) {
+                related.perform(#selector(DrawAspect.graphicDidChangeShape(_:)), with: graphic)
+            }
+        }
+        // Orthogonal links that route around the graphic also need another look, but only the ones whose corridors it moved through.
+        if let page = graphic.page {
+            for link in page.linkRouter.graphicDidChangeShape(graphic) {
+                enqueue(link, sourceChanged: true, destinationChanged: true)
+            }
+        }
+    }
+
+    internal func enqueue(_ link: DrawLink, sourceChanged: Bool, destinationChanged: Bool) {
+        if !sourceChanged && !destinationChanged {
+            return
+        }
+        let key = ObjectIdentifier(link)
+        if let index = pendingIndexes[key] {
+            pending[index].sourceChanged = pending[index].sourceChanged || sourceChanged
+            pending[index].destinationChanged = pending[index].destinationChanged || destinationChanged
+        } else {
+            pendingIndexes[key] = pending.count
+            pending.append(PendingUpdate(link: link, sourceChanged: sourceChanged, destinationChanged: destinationChanged))
+        }
+        scheduleFlush()
+    }
+
+    private func scheduleFlush() {
+        if !flushScheduled {
+            flushScheduled = true
+            // Common modes, so the links keep up while the mouse is being tracked.
+            perform(#selector(flushScheduledUpdates), with: nil, afterDelay: 0.0, inModes: [.common])
+        }
+    }
+
+    internal func flushScheduledUpdates() {
+        flushScheduled = false
+        flush()
+    }
+
+    /// Applies one batch: the queued shape changes, then the link updates queued so far, including the ones those shape changes caused.
+    internal func flush() {
+        if flushScheduled {
+            NSObject.cancelPreviousPerformRequests(withTarget: self, selector: #selector(flushScheduledUpdates), object: nil)
+            flushScheduled = false
+        }
+        // Take the whole batch first. Anything the updates cause goes into the next batch.
+        let graphics = changedGraphics
+        changedGraphics.removeAll(keepingCapacity: true)
+        changedGraphicIdentifiers.removeAll(keepingCapacity: true)
+        for graphic in graphics {
+            graphic.informAspectsOfShapeChangeNow()
+        }
+
+        let updates = pending
+        pending.removeAll(keepingCapacity: true)
+        pendingIndexes.removeAll(keepingCapacity: true)
+
+        for update in updates {
+            update.link.updateEndpoints(forChangedSource: update.sourceChanged, destination: update.destinationChanged)
+        }
+    }
+
+    internal func flushAll() {
+        var passes = 0
+        while hasPendingChanges && passes < DrawLinkUpdater.maximumFlushPasses {
+            flush()
+            passes += 1
+        }
+    }
+
+}
@@ -111,6 +111,7 @@ static NSCursor *cursor = nil; \
 // MARK: - Path Modifiers
 
 - (BOOL)appendLineToPoint:(NSPoint)point {
+    [self bakePathTransform];
     [_path lineToPoint:point];
     return YES;
 }
@@ -121,6 +122,7 @@ static NSCursor *cursor = nil; \
 
 - (BOOL)appendMoveToPoint:(NSPoint)point {
     if ([self canAppendMoveToPoint:point]) {
+        [self bakePathTransform];
         [_path moveToPoint:point];
         return YES;
     }
@@ -132,11 +134,13 @@ static NSCursor *cursor = nil; \
 }
 
 - (BOOL)appendBezierCurveToPoint:(NSPoint)point controlPoint1:(NSPoint)controlPoint1 controlPoint2:(NSPoint)controlPoint2 {
+    [self bakePathTransform];
     [_path curveToPoint:point controlPoint1:controlPoint1 controlPoint2:controlPoint2];
     return YES;
 }
 
 - (BOOL)insertPoint:(NSPoint)point atIndex:(NSUInteger)index {
+    [self bakePathTransform];
     [_path insertLineToPoint:point atIndex:index];
     return YES;
 }
@@ -150,6 +154,7 @@ static NSCursor *cursor = nil; \
         width = 6.0;
     }
     
+    [self bakePathTransform];
     elementIndex = [_path elementIndexOfElementHitByPoint:point atTValue:&t width:width];
     
     if (elementIndex != NSNotFound) {
@@ -167,11 +172,13 @@ static NSCursor *cursor = nil; \
 }
 
 - (BOOL)removePointAtIndex:(NSUInteger)index {
+    [self bakePathTransform];
     [_path removeElementAtIndex:index];
     return YES;
 }
 
 - (BOOL)removePoint:(NSPoint)point {
+    [self bakePathTransform];
     if ([_path pointCount] > 2) {
         DrawHandle hitHandle = [_path drawHandleForPoint:point error:[self.page error]];
         if (hitHandle.type == DrawHandleTypeIndexed) {
@@ -190,6 +197,7 @@ static NSCursor *cursor = nil; \
         width = 6.0;
     }
 
+    [self bakePathTransform];
     elementIndex = [_path elementIndexOfElementHitByPoint:point atTValue:&t width:width];
 
     if (elementIndex != NSNotFound) {
@@ -226,7 +234,7 @@ static NSCursor *cursor = nil; \
 }
 
 - (void)updateBounds {
-    NSRect frame = [_path controlPointBounds];
+    NSRect frame = [[self path] controlPointBounds];
 
     _frameAndBoundsAreDirty = NO;
 
@@ -263,6 +271,7 @@ static NSCursor *cursor = nil; \
         NSPoint points[3];
         AJRBezierPathElement elementType;
         
+        [self bakePathTransform];
         for (NSInteger x = 0; x < (const NSInteger)[_path elementCount]; x++) {
             elementType = [_path elementAtIndex:x associatedPoints:points];
             switch (elementType) {
@@ -317,6 +326,7 @@ static NSCursor *cursor = nil; \
 }
 
 - (DrawHandle)handleForPoint:(NSPoint)point {
+    [self bakePathTransform];
     if (self.editing) {
         DrawHandle handle = [_path drawHandleForPoint:point error:[self.page error]];
 
@@ -377,6 +387,7 @@ static NSCursor *cursor = nil; \
         return [super setHandle:handle toLocation:point];
     }
     
+    [self bakePathTransform];
     if (_creating) {
         if (handle.elementIndex == [_path elementCount] - (_closed ? 1 : 0)) {
             [self appendLineToPoint:point];
@@ -77,6 +77,10 @@ NSString *DrawPenBezierAspectKey = @"DrawPenBezierAspectKey";
     return NO;
 }
 
+- (BOOL)canDrawTranslatedPath {
+    return YES;
+}
+
 #pragma mark - AJRXMLCoding
 
 + (NSString *)ajr_nameForXMLArchiving {
@@ -63,6 +63,8 @@ static NSMutableDictionary *registeredDraggers = nil;
     BOOL _hasDragged;
     BOOL _draggingGraphcis;
     BOOL _shortCircuitedMouseDown;
+    BOOL _showingHandleCursor;
+    BOOL _drawingInteractively;
 }
 
 + (void)initialize {
@@ -110,6 +112,16 @@ static NSMutableDictionary *registeredDraggers = nil;
     return [NSCursor arrowCursor];
 }
 
+- (void)hoverDidChangeOnPage:(DrawPage *)page {
+    BOOL overHandle = [[page hoverTester] hoveredHandle].type != DrawHandleTypeMissed;
+
+    // Only touch the cursor when we're the reason it changed, since editing graphics, like the pen, set their own.
+    if (overHandle != _showingHandleCursor) {
+        _showingHandleCursor = overHandle;
+        [[page enclosingScrollView] setDocumentCursor:overHandle ? [NSCursor crosshairCursor] : [self cursor]];
+    }
+}
+
 - (BOOL)mouseDown:(DrawEvent *)event {
     DrawDocument *document = [event document];
     DrawPage *page = [event page];
@@ -208,7 +220,7 @@ static NSMutableDictionary *registeredDraggers = nil;
                 if (strongSelf->_animationOffset > 5.0) {
                     strongSelf->_animationOffset = 0.0;
                 }
-                [strongSelf->_mouseDown.page setNeedsDisplayInRect:NSInsetRect(strongSelf->_selectionBounds, -2.0, -2.0)];
+                [strongSelf->_mouseDown.page setOverlayNeedsDisplayInRect:NSInsetRect(strongSelf->_selectionBounds, -2.0, -2.0)];
             }
         }];
     }
@@ -249,11 +261,13 @@ static NSMutableDictionary *registeredDraggers = nil;
                 // This only happens if we didn't find anything above.
                 hitGraphic = [_hitGraphics objectAtIndex:0];
                 // However replace selection if the shift key isn't held, otherwise add.
+                [document beginSelectionChanges];
                 if (!([event modifierFlags] & NSEventModifierFlagShift)) {
                     // It's safe to remove everything, because none of our hit graphics are in the selection.
                     [document clearSelection];
                 }
                 [document addGraphicToSelection:hitGraphic];
+                [document endSelectionChanges];
             }
 
             // Finally, in either case, compute the bounds we're working with...
@@ -293,6 +307,12 @@ static NSMutableDictionary *registeredDraggers = nil;
 
     // This check may seem a little odd, but will happen when the view is contrained to a grid, since this could cause multiple mouse drags, but no actual movement of our point.
     if (!((delta.x == 0.0) && (delta.y == 0.0))) {
+        // Draw what we're moving at interactive quality until the drag ends.
+        if (!_drawingInteractively) {
+            _drawingInteractively = YES;
+            [document beginInteractiveDrawingOfGraphics:[document sortedSelection]];
+        }
+
         // First, erase the old graphics.
         [page setNeedsDisplayInRect:_selectionBounds];
 
@@ -323,7 +343,7 @@ static NSMutableDictionary *registeredDraggers = nil;
     NSPoint currentPoint = [event locationOnPage];
 
     if (!NSEqualRects(NSZeroRect, _selectionBounds)) {
-        [_mouseDown.page setNeedsDisplayInRect:NSInsetRect(_selectionBounds, -2.0, -2.0)];
+        [_mouseDown.page setOverlayNeedsDisplayInRect:NSInsetRect(_selectionBounds, -2.0, -2.0)];
     }
 
     _selectionBounds.origin = firstPoint;
@@ -331,7 +351,7 @@ static NSMutableDictionary *registeredDraggers = nil;
     _selectionBounds.size.height = currentPoint.y - firstPoint.y;
     _selectionBounds = AJRNormalizeRect(_selectionBounds);
 
-    [_mouseDown.page setNeedsDisplayInRect:_selectionBounds];
+    [_mouseDown.page setOverlayNeedsDisplayInRect:_selectionBounds];
 
     [self setSelection:[_mouseDown.page graphicsHitByRect:_selectionBounds]];
 
@@ -377,8 +397,10 @@ static NSMutableDictionary *registeredDraggers = nil;
             [document removeGraphicFromSelection:graphic];
         }
     } else {
+        [document beginSelectionChanges];
         [document clearSelection];
         [document addGraphicToSelection:graphic];
+        [document endSelectionChanges];
     }
 }
 
@@ -416,10 +438,12 @@ static NSMutableDictionary *registeredDraggers = nil;
             }
         }
 
-        [[event document] clearSelection];
+        [document beginSelectionChanges];
+        [document clearSelection];
 
         graphic = [_hitGraphics objectAtIndex:index];
         [document addGraphicToSelection:graphic];
+        [document endSelectionChanges];
     }
 }
 
@@ -438,10 +462,11 @@ static NSMutableDictionary *registeredDraggers = nil;
                 [notInNewSelection addObject:graphic];
             }
         }
-        for (DrawGraphic *graphic in notInNewSelection) {
-            [document removeGraphicFromSelection:graphic];
-        }
+        // The marquee calls us on every drag, so make the whole change look like one to observers and the inspectors.
+        [document beginSelectionChanges];
+        [document removeGraphicsFromSelection:notInNewSelection];
         [document addGraphicsToSelection:newSelection];
+        [document endSelectionChanges];
     }
 }
 
@@ -456,12 +481,17 @@ static NSMutableDictionary *registeredDraggers = nil;
     if (_selectionDrawerToken != 0) {
         [_mouseDown.page removeGuestDrawer:_selectionDrawerToken];
         _selectionDrawerToken = 0;
-        [_mouseDown.page setNeedsDisplayInRect:NSInsetRect(_selectionBounds, -1.0, -1.0)];
+        [_mouseDown.page setOverlayNeedsDisplayInRect:NSInsetRect(_selectionBounds, -1.0, -1.0)];
     }
 
     [_selectionAnimator invalidate];
     _selectionAnimator = nil;
     _mouseDown = nil;
+
+    if (_drawingInteractively) {
+        _drawingInteractively = NO;
+        [document endInteractiveDrawing];
+    }
     _selectionBounds = NSZeroRect;
 
     if (_hasDragged) {
@@ -33,10 +33,38 @@ import AJRInterface
 
 let DrawPathAnalysisIdentifier = "pathAnalysis"
 
+/**
+ Draws the corners found by `AJRPathAnalyzer` over a graphic's path.
+
+ Analysis never happens on the main thread. When the graphic changes shape, a copy of its path is analyzed on a background queue, and the result is published back on the main queue in one assignment, so drawing only ever sees a complete analysis. A generation count throws away results that were overtaken by a newer change.
+
+ Paths that only grow, like a squiggle being drawn, are analyzed in chunks of `chunkSize` elements. Only the last chunk and whatever was appended after it are re-analyzed. Chunk boundaries always count as corners, so once the path stops changing for `settleDelay` seconds, the chunks are replaced by one pass over the whole path.
+
+ The overlay path built from the corners is cached until the next analysis is published. Only its line width, which depends on the zoom, is set per draw.
+ */
 @objcMembers
 open class DrawPathAnalysisAspect : DrawAspect {
 
-    open var analyzer : AJRPathAnalyzer
+    /// One analyzed run of path elements.
+    internal struct Chunk {
+        var start : Int
+        var end : Int
+        /// The end point of element `start` when the chunk was analyzed, used to detect whether the path before the chunk has changed.
+        var startPoint : NSPoint
+        /// The corner points of each contour in the run.
+        var corners : [[NSPoint]]
+    }
+
+    internal static let queue = DispatchQueue(label: "com.ajr.draw.path-analysis", qos: .utility)
+    public static var chunkSize = 256
+    public static var settleDelay : TimeInterval = 0.5
+
+    /// The analysis of the whole path, as of the last full pass.
+    open private(set) var analyzer : AJRPathAnalyzer
+
+    internal private(set) var chunks = [Chunk]()
+    private var overlayPath : AJRBezierPath? = nil
+    private var generation = 0
 
     // MARK: - Creation
 
@@ -46,35 +74,144 @@ open class DrawPathAnalysisAspect : DrawAspect {
     }
 
     public override init(graphic: DrawGraphic?) {
-        self.analyzer = AJRPathAnalyzer(path: graphic?.path ?? AJRBezierPath())
+        self.analyzer = AJRPathAnalyzer(path: AJRBezierPath())
         super.init(graphic: graphic)
+        analyzeFullPath()
+    }
+
+    // MARK: - Analysis
+
+    open override func graphicDidChangeShape(_ graphic: DrawGraphic) {
+        super.graphicDidChangeShape(graphic)
+        scheduleAnalysis()
+    }
+
+    internal func scheduleAnalysis() {
+        guard let path = graphic?.path else { return }
+        let elementCount = path.elementCount
+
+        guard var last = chunks.last,
+              elementCount >= last.end,
+              last.start < elementCount,
+              DrawPathAnalysisAspect.endPoint(of: path, at: last.start) == last.startPoint else {
+            analyzeFullPath()
+            return
+        }
+
+        // The path only grew, so everything before the last chunk still stands.
+        var kept = Array(chunks.dropLast())
+        if last.end - last.start >= DrawPathAnalysisAspect.chunkSize && last.end < elementCount {
+            kept.append(last)
+            last = Chunk(start: last.end - 1, end: last.end, startPoint: DrawPathAnalysisAspect.endPoint(of: path, at: last.end - 1), corners: [])
+        }
+        guard let subpath = DrawPathAnalysisAspect.subpath(of: path, from: last.start) else {
+            analyzeFullPath()
+            return
+        }
+
+        generation += 1
+        let generation = self.generation
+        let start = last.start
+        let startPoint = last.startPoint
+        DrawPathAnalysisAspect.queue.async {
+            let corners = DrawPathAnalysisAspect.corners(of: AJRPathAnalyzer(path: subpath))
+            DispatchQueue.main.async { [weak self] in
+                guard let self, self.generation == generation else { return }
+                self.publish(kept + [Chunk(start: start, end: elementCount, startPoint: startPoint, corners: corners)], analyzer: nil)
+            }
+        }
+
+        NSObject.cancelPreviousPerformRequests(withTarget: self, selector: #selector(analyzeFullPath), object: nil)
+        perform(#selector(analyzeFullPath), with: nil, afterDelay: DrawPathAnalysisAspect.settleDelay)
+    }
+
+    @objc internal func analyzeFullPath() {
+        NSObject.cancelPreviousPerformRequests(withTarget: self, selector: #selector(analyzeFullPath), object: nil)
+        guard let path = graphic?.path.copy() as? AJRBezierPath else { return }
+
+        generation += 1
+        let generation = self.generation
+        DrawPathAnalysisAspect.queue.async {
+            let analyzer = AJRPathAnalyzer(path: path)
+            let chunk = Chunk(start: 0, end: path.elementCount, startPoint: DrawPathAnalysisAspect.endPoint(of: path, at: 0), corners: DrawPathAnalysisAspect.corners(of: analyzer))
+            DispatchQueue.main.async { [weak self] in
+                guard let self, self.generation == generation else { return }
+                self.publish([chunk], analyzer: analyzer)
+            }
+        }
+    }
+
+    internal func publish(_ chunks: [Chunk], analyzer: AJRPathAnalyzer?) {
+        if let analyzer {
+            self.analyzer = analyzer
+        }
+        self.chunks = chunks
+        overlayPath = nil
+        graphic?.setNeedsDisplay()
+    }
+
+    internal class func corners(of analyzer: AJRPathAnalyzer) -> [[NSPoint]] {
+        return analyzer.contours.map { contour in contour.corners.map { $0.point } }
+    }
+
+    internal class func endPoint(of path: AJRBezierPath, at index: Int) -> NSPoint {
+        var points = [NSPoint](repeating: .zero, count: 3)
+        if index < 0 || index >= path.elementCount {
+            return .zero
+        }
+        switch path.element(at: index, associatedPoints: &points) {
+        case .cubicCurveTo:
+            return points[2]
+        case .close:
+            return .zero
+        default:
+            return points[0]
+        }
+    }
+
+    /// Returns the elements from `start` on as a new path beginning at element `start`'s end point, or `nil` if the run closes a subpath, which we can't reproduce out of context.
+    internal class func subpath(of path: AJRBezierPath, from start: Int) -> AJRBezierPath? {
+        let subpath = AJRBezierPath()
+        var points = [NSPoint](repeating: .zero, count: 3)
+
+        subpath.move(to: endPoint(of: path, at: start))
+        for index in start + 1 ..< max(start + 1, path.elementCount) {
+            switch path.element(at: index, associatedPoints: &points) {
+            case .moveTo:
+                subpath.move(to: points[0])
+            case .lineTo:
+                subpath.line(to: points[0])
+            case .cubicCurveTo:
+                subpath.curve(to: points[2], controlPoint1: points[0], controlPoint2: points[1])
+            default:
+                return nil
+            }
+        }
+        return subpath
     }
 
     // MARK: - DrawAspect
 
     open override func draw(_ path: AJRBezierPath, with priority: DrawAspectPriority) -> DrawGraphicCompletionBlock? {
-        let scale = NSAffineTransform.currentScale
-        let thickPath = AJRBezierPath()
-        let thinPath = AJRBezierPath()
-        var previousPoint = NSPoint.zero
-
-        for (index, contour) in analyzer.contours.enumerated() {
-            for corner in contour.corners {
-                if index == 0 {
-                    previousPoint = corner.point
-                } else {
-                    thickPath.move(to: previousPoint)
-                    thickPath.line(to: corner.point)
-                    previousPoint = corner.point
+        if overlayPath == nil {
+            let overlayPath = AJRBezierPath()
+            for chunk in chunks {
+                for corners in chunk.corners {
+                    if let first = corners.first {
+                        overlayPath.move(to: first)
+                        for corner in corners.dropFirst() {
+                            overlayPath.line(to: corner)
+                        }
+                    }
                 }
             }
+            self.overlayPath = overlayPath
         }
 
-        thickPath.lineWidth = 4.0 / scale
-        thickPath.stroke(color: NSColor.blue)
-
-        thinPath.lineWidth = 1.0 / scale
-        thinPath.stroke(color: NSColor.purple)
+        if let overlayPath {
+            overlayPath.lineWidth = 4.0 / NSAffineTransform.currentScale
+            overlayPath.stroke(color: NSColor.blue)
+        }
 
         return nil
     }
@@ -83,7 +220,10 @@ open class DrawPathAnalysisAspect : DrawAspect {
 
     open override func copy(with zone: NSZone? = nil) -> Any {
         let aspect = super.copy(with: nil) as! DrawPathAnalysisAspect
-        aspect.analyzer = AJRPathAnalyzer(path: analyzer.path)
+        // Published analyses are never mutated, so the copy can share them.
+        aspect.analyzer = analyzer
+        aspect.chunks = chunks
+        aspect.overlayPath = overlayPath
         return aspect
     }
 
@@ -94,9 +234,12 @@ open class DrawPathAnalysisAspect : DrawAspect {
         coder.decodeObject(forKey: "width") { object in
             if let object = object as? AJRPathAnalyzer {
                 self.analyzer = object
+                self.chunks = [Chunk(start: 0, end: object.path.elementCount, startPoint: DrawPathAnalysisAspect.endPoint(of: object.path, at: 0), corners: DrawPathAnalysisAspect.corners(of: object))]
             } else {
                 self.analyzer = AJRPathAnalyzer(path: AJRBezierPath())
+                self.chunks = []
             }
+            self.overlayPath = nil
         }
     }
 
@@ -33,8 +33,17 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class DrawSquiggleSimplifier;
+
 @interface DrawSquiggle : DrawPen
 
+/*! When YES, the default, squiggles drop points while they're being drawn that lie within a zoom dependent tolerance of the stroke. */
++ (BOOL)simplifiesWhileTracking;
++ (void)setSimplifiesWhileTracking:(BOOL)flag;
+
+/*! The simplifier used while the squiggle was drawn, if any. It's kept so the reduction can be reported after the fact, and isn't archived. */
+@property (nullable,nonatomic,readonly) DrawSquiggleSimplifier *simplifier;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -32,23 +32,74 @@
 #import "DrawSquiggle.h"
 
 #import "DrawPage.h"
+#import <Draw/Draw-Swift.h>
 
-@implementation DrawSquiggle
+#import <AJRFoundation/AJRFoundation.h>
+
+@implementation DrawSquiggle {
+    DrawSquiggleOverlay *_overlay;
+}
+
+static BOOL _simplifiesWhileTracking = YES;
+
++ (BOOL)simplifiesWhileTracking {
+    return _simplifiesWhileTracking;
+}
+
++ (void)setSimplifiesWhileTracking:(BOOL)flag {
+    _simplifiesWhileTracking = flag;
+}
+
+- (BOOL)startTrackingAt:(NSPoint)startPoint {
+    if (self.creating && self.page) {
+        // While the squiggle is being drawn, the page doesn't draw us at all. Instead, each new segment is drawn into an overlay, so the cost per event doesn't depend on how long the squiggle has become.
+        DrawStroke *stroke = [self primaryStroke];
+        NSColor *color = stroke.active ? stroke.color : NSColor.blackColor;
+        CGFloat width = stroke.active ? stroke.width : 1.0;
+        _overlay = [[DrawSquiggleOverlay alloc] initWithPage:self.page color:color lineWidth:width];
+        [_overlay beginAtPoint:[self.path lastPoint]];
+        self.ignore = YES;
+    }
+    return [super startTrackingAt:startPoint];
+}
 
 - (BOOL)continueTracking:(NSPoint)lastPoint at:(NSPoint)currentPoint {
     if (self.creating) {
-        self.ignore = YES;
-        [self.page displayRect:[self bounds]];
-        self.ignore = NO;
         _handle.type = DrawHandleTypeIndexed;
+        // The first drag places the initial move to, so start simplifying from the point after that.
+        if (_simplifier == nil && _simplifiesWhileTracking && _handle.elementIndex > 0) {
+            _simplifier = [[DrawSquiggleSimplifier alloc] initWithAnchor:lastPoint tolerance:[DrawSquiggleSimplifier toleranceForScale:[self.page scale]]];
+        }
+        if (_simplifier && ![_simplifier addPoint:currentPoint]) {
+            // Still within tolerance of a straight run, so slide the last point rather than adding one.
+            _handle.elementIndex--;
+        }
         [self setHandle:_handle toLocation:currentPoint];
         _handle.elementIndex++;
-        [self.page displayRect:[self bounds]];
+        if (_overlay) {
+            [_overlay appendPoint:currentPoint];
+        } else {
+            [self.page displayRect:[self bounds]];
+        }
         return YES;
     }
     return [super continueTracking:lastPoint at:currentPoint];
 }
 
+- (void)stopTracking:(NSPoint)lastPoint at:(NSPoint)stopPoint {
+    [super stopTracking:lastPoint at:stopPoint];
+    if (_simplifier) {
+        AJRLogDebug(@"Squiggle: kept %ld of %ld points (%.1f%% reduction)\n", (long)_simplifier.outputPointCount, (long)_simplifier.inputPointCount, _simplifier.reductionRatio * 100.0);
+    }
+    if (_overlay) {
+        // Hand the finished path back to the page in one invalidation.
+        [_overlay end];
+        _overlay = nil;
+        self.ignore = NO;
+        [self setNeedsDisplay];
+    }
+}
+
 - (BOOL)isEqualToSquiggle:(DrawSquiggle *)other {
     return (self.class == other.class
             && [super isEqualToPen:other]);
@@ -0,0 +1,184 @@
+/*
+ DrawSquiggleOverlay.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ The overlay's pixels. Images made from the bitmap retain it through their data provider, so the memory outlives `DrawSquiggleOverlay.end()` for as long as Core Graphics holds on to one of them.
+ */
+private final class DrawSquiggleBitmap {
+
+    let data : UnsafeMutableRawPointer
+
+    init(byteCount: Int) {
+        data = UnsafeMutableRawPointer.allocate(byteCount: byteCount, alignment: 16)
+        data.initializeMemory(as: UInt8.self, repeating: 0, count: byteCount)
+    }
+
+    deinit {
+        data.deallocate()
+    }
+
+}
+
+/**
+ Accumulates a squiggle's stroke in an offscreen bitmap while it's being drawn.
+
+ Each mouse drag strokes only the newest segment into the bitmap and invalidates only that segment's bounds. When the page's overlay view redraws that small rect, the overlay composites the matching slice of the bitmap over the page's content, which doesn't redraw at all. The rest of the stroke stays on screen from the previous frames, so the cost per event doesn't grow with the length of the stroke.
+
+ The bitmap covers the page's visible rect at device resolution. It's laid out so page coordinates map directly to pixel coordinates, without a flip. That way `CGContext.draw(_:in:)` puts it the right way up in both flipped and unflipped pages.
+ */
+@objcMembers
+open class DrawSquiggleOverlay : NSObject {
+
+    /// The largest bitmap edge, in pixels. Beyond this the overlay gives up some resolution rather than memory.
+    public static let maximumPixelDimension : CGFloat = 8192.0
+
+    open private(set) weak var page : DrawPage?
+    open private(set) var color : NSColor
+    open private(set) var lineWidth : CGFloat
+
+    private var context : CGContext?
+    private var bitmap : DrawSquiggleBitmap?
+    private var pixelsWide = 0
+    private var pixelsHigh = 0
+    private var bytesPerRow = 0
+    /// The part of the page the bitmap covers.
+    private var coverage = NSRect.zero
+    /// Pixels per page unit.
+    private var pixelScale : CGFloat = 1.0
+    private var token : DrawDrawingToken?
+    private var lastPoint = NSPoint.zero
+
+    public init(page: DrawPage, color: NSColor, lineWidth: CGFloat) {
+        self.page = page
+        self.color = color
+        self.lineWidth = max(lineWidth, 0.0)
+    }
+
+    // MARK: - Tracking
+
+    @objc(beginAtPoint:)
+    open func begin(at point: NSPoint) {
+        guard let page else { return }
+
+        coverage = page.visibleRect
+        if coverage.isEmpty {
+            coverage = page.bounds
+        }
+        let deviceScale = (page.window?.backingScaleFactor ?? 1.0) * page.scale
+        pixelScale = min(deviceScale, DrawSquiggleOverlay.maximumPixelDimension / max(coverage.width, coverage.height, 1.0))
+        pixelsWide = max(1, Int((coverage.width * pixelScale).rounded(.up)))
+        pixelsHigh = max(1, Int((coverage.height * pixelScale).rounded(.up)))
+        bytesPerRow = pixelsWide * 4
+
+        let bitmap = DrawSquiggleBitmap(byteCount: bytesPerRow * pixelsHigh)
+        self.bitmap = bitmap
+        if let context = CGContext(data: bitmap.data, width: pixelsWide, height: pixelsHigh, bitsPerComponent: 8, bytesPerRow: bytesPerRow, space: CGColorSpace(name: CGColorSpace.sRGB)!, bitmapInfo: CGImageAlphaInfo.premultipliedLast.rawValue) {
+            context.scaleBy(x: pixelScale, y: pixelScale)
+            context.translateBy(x: -coverage.origin.x, y: -coverage.origin.y)
+            context.setStrokeColor(color.usingColorSpace(.sRGB)?.cgColor ?? NSColor.black.cgColor)
+            context.setLineWidth(lineWidth)
+            context.setLineCap(.round)
+            context.setLineJoin(.round)
+            context.setShouldAntialias(true)
+            self.context = context
+        }
+
+        lastPoint = point
+        token = page.addGuestDrawer { [weak self] page, dirtyRect in
+            self?.draw(in: dirtyRect)
+        }
+    }
+
+    /// Strokes the segment from the last point to `point` and invalidates just that segment.
+    @objc(appendPoint:)
+    open func append(_ point: NSPoint) {
+        guard let context, let page else { return }
+
+        context.beginPath()
+        context.move(to: lastPoint)
+        context.addLine(to: point)
+        context.strokePath()
+
+        let outset = -(lineWidth / 2.0 + 1.0)
+        let segment = NSRect(x: min(lastPoint.x, point.x), y: min(lastPoint.y, point.y), width: abs(point.x - lastPoint.x), height: abs(point.y - lastPoint.y)).insetBy(dx: outset, dy: outset)
+        lastPoint = point
+        page.setOverlayNeedsDisplay(segment)
+    }
+
+    /// Removes the overlay from the page and lets go of the bitmap. The caller is responsible for invalidating the final graphic.
+    open func end() {
+        if let token {
+            page?.removeGuestDrawer(token)
+        }
+        token = nil
+        context = nil
+        bitmap = nil
+    }
+
+    // MARK: - Drawing
+
+    /// Composites the slice of the bitmap under `dirtyRect`. No pixels are copied; the image reads straight from the bitmap, and keeps it alive until Core Graphics is done with the image.
+    internal func draw(in dirtyRect: NSRect) {
+        guard let bitmap, let cgContext = NSGraphicsContext.current?.cgContext else { return }
+
+        let x0 = max(0, Int(((dirtyRect.minX - coverage.minX) * pixelScale).rounded(.down)))
+        let x1 = min(pixelsWide, Int(((dirtyRect.maxX - coverage.minX) * pixelScale).rounded(.up)))
+        let y0 = max(0, Int(((dirtyRect.minY - coverage.minY) * pixelScale).rounded(.down)))
+        let y1 = min(pixelsHigh, Int(((dirtyRect.maxY - coverage.minY) * pixelScale).rounded(.up)))
+        if x1 <= x0 || y1 <= y0 {
+            return
+        }
+
+        // Bitmap rows are stored top down, so the slice starts at the row for y1.
+        let start = bitmap.data + (pixelsHigh - y1) * bytesPerRow + x0 * 4
+        let size = (y1 - y0 - 1) * bytesPerRow + (x1 - x0) * 4
+        let info = Unmanaged.passRetained(bitmap).toOpaque()
+        guard let provider = CGDataProvider(dataInfo: info, data: start, size: size, releaseData: { info, _, _ in
+            if let info {
+                Unmanaged<DrawSquiggleBitmap>.fromOpaque(info).release()
+            }
+        }) else {
+            Unmanaged<DrawSquiggleBitmap>.fromOpaque(info).release()
+            return
+        }
+        guard let image = CGImage(width: x1 - x0, height: y1 - y0, bitsPerComponent: 8, bitsPerPixel: 32, bytesPerRow: bytesPerRow, space: CGColorSpace(name: CGColorSpace.sRGB)!, bitmapInfo: CGBitmapInfo(rawValue: CGImageAlphaInfo.premultipliedLast.rawValue), provider: provider, decode: nil, shouldInterpolate: false, intent: .defaultIntent) else {
+            return
+        }
+        let rect = NSRect(x: coverage.minX + CGFloat(x0) / pixelScale,
+                          y: coverage.minY + CGFloat(y0) / pixelScale,
+                          width: CGFloat(x1 - x0) / pixelScale,
+                          height: CGFloat(y1 - y0) / pixelScale)
+        cgContext.draw(image, in: rect)
+    }
+
+}
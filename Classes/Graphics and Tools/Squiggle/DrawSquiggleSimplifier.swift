@@ -0,0 +1,134 @@
+/*
+ DrawSquiggleSimplifier.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Simplifies a freehand stroke as it's drawn.
+
+ This is a streaming form of Ramer–Douglas–Peucker. The simplifier keeps an anchor, which is the last vertex that's fixed in place, and a window of the raw points received since then. As long as every point in the window lies within `tolerance` of the line from the anchor to the newest point, the stroke's last vertex just slides to the newest point. As soon as one doesn't, the previous vertex becomes the new anchor and a new vertex is started. Every raw point therefore stays within `tolerance` of the simplified stroke.
+
+ The window is capped at `maximumWindow` points, so each point costs O(1) no matter how long the stroke gets.
+ */
+@objcMembers
+open class DrawSquiggleSimplifier : NSObject {
+
+    /// The default allowable error, in screen points. This is divided by the page's scale, so zooming in keeps more detail.
+    public static var defaultScreenTolerance : CGFloat = 0.75
+
+    open class func tolerance(forScale scale: CGFloat) -> CGFloat {
+        return defaultScreenTolerance / max(scale, 0.01)
+    }
+
+    open private(set) var tolerance : CGFloat
+    open var maximumWindow = 64
+
+    /// The number of points passed to `add(_:)`, plus the first anchor.
+    open private(set) var inputPointCount = 1
+    /// The number of vertices in the simplified stroke, including the first anchor.
+    open private(set) var outputPointCount = 1
+
+    private var anchor : NSPoint
+    private var window = [NSPoint]()
+
+    @objc(initWithAnchor:tolerance:)
+    public init(anchor: NSPoint, tolerance: CGFloat) {
+        self.anchor = anchor
+        self.tolerance = tolerance
+    }
+
+    /**
+     Adds the next raw point.
+
+     - returns: `true` if the point should be appended to the stroke as a new vertex, or `false` if it should replace the stroke's last vertex.
+     */
+    @objc(addPoint:)
+    open func add(_ point: NSPoint) -> Bool {
+        inputPointCount += 1
+        if !window.isEmpty && window.count < maximumWindow && fits(point) {
+            window.append(point)
+            return false
+        }
+        if let last = window.last {
+            anchor = last
+        }
+        window = [point]
+        outputPointCount += 1
+        return true
+    }
+
+    /// The fraction of the input points removed, from `0.0` (nothing removed) up towards `1.0`.
+    open var reductionRatio : Double {
+        return inputPointCount > 0 ? 1.0 - Double(outputPointCount) / Double(inputPointCount) : 0.0
+    }
+
+    internal func fits(_ point: NSPoint) -> Bool {
+        let dx = point.x - anchor.x
+        let dy = point.y - anchor.y
+        let lengthSquared = dx * dx + dy * dy
+        let toleranceSquared = tolerance * tolerance
+
+        for sample in window {
+            let sx = sample.x - anchor.x
+            let sy = sample.y - anchor.y
+            var distanceSquared : CGFloat
+            if lengthSquared == 0.0 {
+                distanceSquared = sx * sx + sy * sy
+            } else {
+                // Distance to the segment, not the infinite line, so doubling back gets its own vertex.
+                let t = max(0.0, min(1.0, (sx * dx + sy * dy) / lengthSquared))
+                let ex = sx - t * dx
+                let ey = sy - t * dy
+                distanceSquared = ex * ex + ey * ey
+            }
+            if distanceSquared > toleranceSquared {
+                return false
+            }
+        }
+        return true
+    }
+
+    /// Simplifies a complete list of points, which is handy for comparing against unsimplified strokes.
+    open class func simplify(_ points: [NSPoint], tolerance: CGFloat) -> [NSPoint] {
+        guard let first = points.first else { return [] }
+        let simplifier = DrawSquiggleSimplifier(anchor: first, tolerance: tolerance)
+        var result = [first]
+        for point in points.dropFirst() {
+            if simplifier.add(point) {
+                result.append(point)
+            } else {
+                result[result.count - 1] = point
+            }
+        }
+        return result
+    }
+
+}
@@ -396,6 +396,11 @@ open class DrawText : DrawAspect {
 
     // MARK: - DrawAspect
 
+    /// Laying out and drawing glyphs that are only a pixel or two tall isn't worth it.
+    open override var drawsAtReducedDetail: Bool {
+        return false
+    }
+
     open override class func defaultAspect(for graphic: DrawGraphic) -> DrawAspect? {
         return DrawText(graphic: graphic)
     }
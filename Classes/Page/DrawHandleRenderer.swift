@@ -0,0 +1,136 @@
+/*
+ DrawHandleRenderer.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Draws selection handles in batches.
+
+ Drawing a handle used to mean drawing the handle `NSImage` once per handle, which picks an image rep, sets up compositing and restores it again each time. With a large selection that was most of a frame. Now, while a page draws its selection, `-[DrawGraphic drawHandleAtPoint:]` just hands the point to the page's renderer, and the renderer draws them all at the end in one pass: the handle image is rendered once per device size into a `CGImage`, and then drawn at each point with no state changes in between.
+ */
+@objcMembers
+open class DrawHandleRenderer : NSObject {
+
+    internal struct ImageKey : Hashable {
+        var pixelsWide : Int
+        var pixelsHigh : Int
+    }
+
+    internal static var images = [ImageKey:CGImage]()
+
+    open private(set) weak var page : DrawPage?
+    /// The centers of the handles collected since `beginBatch()`, in page coordinates.
+    internal private(set) var points = [NSPoint]()
+    /// True between `beginBatch()` and `endBatch()`. Graphics check this to decide whether to draw their handles themselves.
+    open private(set) var isBatching = false
+
+    public init(page: DrawPage) {
+        self.page = page
+        super.init()
+    }
+
+    // MARK: - Batching
+
+    open func beginBatch() {
+        points.removeAll(keepingCapacity: true)
+        isBatching = true
+    }
+
+    @objc(addHandleAtPoint:)
+    open func addHandle(at point: NSPoint) {
+        points.append(point)
+    }
+
+    /// Draws every handle added since `beginBatch()` into the current graphics context.
+    open func endBatch() {
+        isBatching = false
+        defer {
+            points.removeAll(keepingCapacity: true)
+        }
+
+        guard !points.isEmpty,
+              let page,
+              let context = NSGraphicsContext.current?.cgContext
+        else { return }
+
+        let scale = page.scale > 0.0 ? page.scale : 1.0
+        let imageSize = DrawGraphic.handleImage().size
+        let size = NSSize(width: imageSize.width / scale, height: imageSize.height / scale)
+        // Same placement as -[DrawGraphic drawHandleAtPoint:].
+        let offset = NSPoint(x: -size.width / 2.0, y: page.isFlipped ? -size.height / 2.0 : size.height / 2.0)
+        let toDevice = context.userSpaceToDeviceSpaceTransform
+        let toUser = toDevice.inverted()
+
+        guard let image = DrawHandleRenderer.handleImage(pixelsWide: Int((imageSize.width * abs(toDevice.a) / scale).rounded()),
+                                                         pixelsHigh: Int((imageSize.height * abs(toDevice.d) / scale).rounded()))
+        else { return }
+
+        context.saveGState()
+        context.setBlendMode(.copy)
+        context.interpolationQuality = .none
+        for point in points {
+            // Snap to whole device pixels, the way -centerScanRect: would, without a trip through the view per handle.
+            var rect = CGRect(x: point.x + offset.x, y: point.y + offset.y, width: size.width, height: size.height).applying(toDevice)
+            rect.origin.x.round()
+            rect.origin.y.round()
+            rect.size.width.round()
+            rect.size.height.round()
+            context.draw(image, in: rect.applying(toUser))
+        }
+        context.restoreGState()
+    }
+
+    // MARK: - Images
+
+    /// Returns the handle image rendered at the given device size, rendering it the first time it's asked for.
+    internal class func handleImage(pixelsWide: Int, pixelsHigh: Int) -> CGImage? {
+        guard pixelsWide > 0, pixelsHigh > 0 else { return nil }
+
+        let key = ImageKey(pixelsWide: pixelsWide, pixelsHigh: pixelsHigh)
+        if let image = images[key] {
+            return image
+        }
+
+        guard let colorSpace = CGColorSpace(name: CGColorSpace.sRGB),
+              let bitmap = CGContext(data: nil, width: pixelsWide, height: pixelsHigh, bitsPerComponent: 8, bytesPerRow: 0, space: colorSpace, bitmapInfo: CGImageAlphaInfo.premultipliedFirst.rawValue | CGBitmapInfo.byteOrder32Host.rawValue)
+        else { return nil }
+
+        NSGraphicsContext.saveGraphicsState()
+        NSGraphicsContext.current = NSGraphicsContext(cgContext: bitmap, flipped: false)
+        DrawGraphic.handleImage().draw(in: NSRect(x: 0.0, y: 0.0, width: CGFloat(pixelsWide), height: CGFloat(pixelsHigh)))
+        NSGraphicsContext.restoreGraphicsState()
+
+        let image = bitmap.makeImage()
+        images[key] = image
+        return image
+    }
+
+}
@@ -0,0 +1,360 @@
+/*
+ DrawHoverTester.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Answers "what's under the mouse" for hover feedback without blocking the main thread.
+
+ `mouseMoved:` arrives far more often than the page can afford a full hit test, and hovering doesn't need the answer before the next event is handled. So the tester takes an immutable snapshot of the page's geometry on the main thread, built from each graphic's `flattenedPath`, and runs the query against that snapshot on a background queue. Only the result, a graphic and handle, comes back to the main thread.
+
+ Each graphic's share of the snapshot is cached until that graphic changes, so after an edit the next snapshot only recomputes the graphics that were edited, and the rest is relinked from the cache.
+
+ Only the newest query matters. A query that's overtaken by a newer mouse move stops between graphics, and a result that arrives after a newer query was issued is dropped.
+ */
+@objcMembers
+open class DrawHoverTester : NSObject {
+
+    internal static let queue = DispatchQueue(label: "com.ajr.draw.hover", qos: .userInteractive)
+
+    // MARK: - Properties
+
+    open private(set) weak var page : DrawPage?
+    /// The graphic most recently found under the mouse, or `nil`.
+    open private(set) weak var hoveredGraphic : DrawGraphic?
+    /// The selection handle most recently found under the mouse, or `DrawHandleMissed`.
+    open private(set) var hoveredHandle : DrawHandle = DrawHandleMissed
+
+    /// Main thread only.
+    private var snapshot : DrawHoverSnapshot?
+    /// Each top level graphic's entries, reused across snapshots until the graphic changes. Main thread only.
+    private var entryCache = [ObjectIdentifier:[DrawHoverSnapshot.Entry]]()
+    private var entryCacheScale : CGFloat = 0.0
+
+    /// Guards `latestQuery` and `pending`, which the worker reads.
+    private let lock = NSLock()
+    private var latestQuery = 0
+    private var pending : (point: NSPoint, snapshot: DrawHoverSnapshot, query: Int)?
+
+    // MARK: - Creation
+
+    /// The tester only listens to the page's current document, so the page makes a new tester when its document changes.
+    public init(page: DrawPage) {
+        self.page = page
+        super.init()
+        if let document = page.document {
+            NotificationCenter.default.addObserver(self, selector: #selector(documentDidChange(_:)), name: .DrawViewDidChangeSelection, object: document)
+            NotificationCenter.default.addObserver(self, selector: #selector(documentDidChange(_:)), name: .DrawLayerDidChange, object: document)
+        }
+    }
+
+    deinit {
+        NotificationCenter.default.removeObserver(self)
+    }
+
+    // MARK: - Queries
+
+    /// Throws away the geometry snapshot, but keeps the cached geometry of each graphic. The page calls this when graphics are added or reordered, the document when the selection changes, and the tester itself when the layers change.
+    open func invalidate() {
+        snapshot = nil
+    }
+
+    /// Throws away the snapshot and the cached geometry of `graphic` and the groups it's in. The page calls this whenever a graphic changes or is removed.
+    @objc(invalidateGraphic:)
+    open func invalidate(_ graphic: DrawGraphic) {
+        snapshot = nil
+        var current : DrawGraphic? = graphic
+        while let graphic = current {
+            entryCache[ObjectIdentifier(graphic)] = nil
+            current = graphic.supergraphic
+        }
+    }
+
+    @objc private func documentDidChange(_ notification: Notification) {
+        invalidate()
+    }
+
+    /**
+     Starts a hover query at `point`, in page coordinates. Returns immediately. When the query finishes, and nothing newer has been asked for, `hoveredGraphic` and `hoveredHandle` are updated and, if they changed, the current tool is told.
+     */
+    open func hover(at point: NSPoint) {
+        guard let snapshot = currentSnapshot() else { return }
+
+        lock.lock()
+        latestQuery += 1
+        let needsWorker = pending == nil
+        pending = (point, snapshot, latestQuery)
+        lock.unlock()
+
+        // A worker already queued will pick up the newest point, so there's never more than one query waiting.
+        if needsWorker {
+            DrawHoverTester.queue.async { [weak self] in
+                self?.runPendingQuery()
+            }
+        }
+    }
+
+    /// Forgets any hover state, for example when the mouse leaves the page.
+    open func cancel() {
+        lock.lock()
+        latestQuery += 1
+        pending = nil
+        lock.unlock()
+        publish(graphic: nil, handle: DrawHandleMissed)
+    }
+
+    internal func isStale(_ query: Int) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return query != latestQuery
+    }
+
+    internal func currentSnapshot() -> DrawHoverSnapshot? {
+        guard let page, let document = page.document else { return nil }
+        if let snapshot, snapshot.scale == page.scale {
+            return snapshot
+        }
+        // Stroke slop depends on the zoom, so cached geometry doesn't survive it.
+        if entryCacheScale != page.scale {
+            entryCache.removeAll()
+            entryCacheScale = page.scale
+        }
+        let snapshot = DrawHoverSnapshot(page: page, document: document, cache: &entryCache)
+        self.snapshot = snapshot
+        return snapshot
+    }
+
+    private func runPendingQuery() {
+        lock.lock()
+        guard let query = pending else {
+            lock.unlock()
+            return
+        }
+        pending = nil
+        lock.unlock()
+
+        let snapshot = query.snapshot
+        guard let hit = snapshot.hit(at: query.point, isCancelled: { isStale(query.query) }) else {
+            return
+        }
+        DispatchQueue.main.async { [weak self] in
+            guard let self, !self.isStale(query.query) else { return }
+            self.publish(graphic: hit.index.map { snapshot.graphics[$0] }, handle: hit.handle)
+        }
+    }
+
+    private func publish(graphic: DrawGraphic?, handle: DrawHandle) {
+        if graphic === hoveredGraphic && DrawHandleEqual(handle, hoveredHandle) {
+            return
+        }
+        hoveredGraphic = graphic
+        hoveredHandle = handle
+        if let page, let tool = page.document?.currentTool {
+            tool.hoverDidChange(on: page)
+        }
+    }
+
+}
+
+/**
+ An immutable copy of the hit-testable geometry on a page, front to back. Everything it holds is either a value or a `DrawFlattenedPath`, so it can be queried from any thread. The graphics themselves are only carried along so results can be mapped back to them on the main thread.
+ */
+internal final class DrawHoverSnapshot {
+
+    internal struct Entry {
+        /// The index in `graphics` of the graphic a hit reports, which is the top level graphic for anything inside a group.
+        var owner : Int
+        var bounds : NSRect
+        var path : DrawFlattenedPath?
+        /// The width to test the stroke at, or `0.0` when the graphic isn't stroked.
+        var strokeWidth : CGFloat
+        var filled : Bool
+        var evenOdd : Bool
+    }
+
+    internal struct Hit {
+        var index : Int?
+        var handle : DrawHandle
+    }
+
+    /// Matches `-[DrawGraphic handleForPoint:]`.
+    internal static let handleAdjustment : CGFloat = 3.0
+
+    internal let scale : CGFloat
+    internal let graphics : [DrawGraphic]
+    internal let entries : [Entry]
+    /// The frames of the selected graphics, paired with their index in `graphics`.
+    internal let selectedFrames : [(owner: Int, frame: NSRect)]
+
+    /**
+     Snapshots the page. `cache` holds the entries of top level graphics from the last snapshot; graphics found there are reused rather than recomputed, and on return it holds just the graphics in this snapshot.
+     */
+    internal init(page: DrawPage, document: DrawDocument, cache: inout [ObjectIdentifier:[Entry]]) {
+        var graphics = [DrawGraphic]()
+        var entries = [Entry]()
+        var selectedFrames = [(owner: Int, frame: NSRect)]()
+        var nextCache = [ObjectIdentifier:[Entry]]()
+        let selection = document.selection
+
+        func addGraphic(_ graphic: DrawGraphic) {
+            let owner = graphics.count
+            let key = ObjectIdentifier(graphic)
+            let graphicEntries = cache[key] ?? DrawHoverSnapshot.entries(for: graphic, on: page)
+            nextCache[key] = graphicEntries
+            graphics.append(graphic)
+            if selection.contains(graphic) {
+                selectedFrames.append((owner, graphic.frame))
+            }
+            for var entry in graphicEntries {
+                entry.owner = owner
+                entries.append(entry)
+            }
+        }
+
+        if let group = document.focusedGroup {
+            for graphic in (group.subgraphics as? [DrawGraphic] ?? []).reversed() {
+                addGraphic(graphic)
+            }
+        } else {
+            for layer in document.layers.reversed() where !layer.locked && layer.visible {
+                for graphic in (page.graphics(for: layer) as? [DrawGraphic] ?? []).reversed() {
+                    addGraphic(graphic)
+                }
+            }
+        }
+
+        cache = nextCache
+        self.scale = page.scale
+        self.graphics = graphics
+        self.entries = entries
+        self.selectedFrames = selectedFrames
+    }
+
+    /// The entries for `graphic` and its subgraphics, front to back, all with an `owner` of `0`.
+    internal class func entries(for graphic: DrawGraphic, on page: DrawPage) -> [Entry] {
+        var entries = [Entry]()
+        let slop = page.error
+
+        func addEntries(for graphic: DrawGraphic) {
+            if graphic.ignore {
+                return
+            }
+            for subgraphic in (graphic.subgraphics as? [DrawGraphic] ?? []).reversed() {
+                addEntries(for: subgraphic)
+            }
+
+            var strokeWidth : CGFloat = 0.0
+            var filled = false
+            var evenOdd = false
+            var hasAspects = false
+            graphic.enumerateAspects { aspect in
+                guard aspect.isActive else { return }
+                hasAspects = true
+                if let stroke = aspect as? DrawStroke {
+                    strokeWidth = max(strokeWidth, stroke.hitWidth, 5.0)
+                } else if let fill = aspect as? DrawFill {
+                    filled = true
+                    evenOdd = fill.windingRule == .evenOdd
+                }
+            }
+
+            if strokeWidth == 0.0 && !filled {
+                if hasAspects {
+                    // Text, images, and the like: hover over the frame.
+                    entries.append(Entry(owner: 0, bounds: graphic.frame.insetBy(dx: -slop, dy: -slop), path: nil, strokeWidth: 0.0, filled: true, evenOdd: false))
+                    return
+                }
+                // Same as the fallback in graphicsHitByGraphicTest:.
+                strokeWidth = 3.0 / page.scale
+            }
+            entries.append(Entry(owner: 0, bounds: graphic.bounds.insetBy(dx: -slop, dy: -slop), path: graphic.flattenedPath, strokeWidth: strokeWidth, filled: filled, evenOdd: evenOdd))
+        }
+
+        addEntries(for: graphic)
+        return entries
+    }
+
+    /**
+     Finds the frontmost selection handle or graphic at `point`. Handles win, since they sit on top of everything.
+
+     - returns: The hit, which may be empty, or `nil` if `isCancelled` returned `true` along the way.
+     */
+    internal func hit(at point: NSPoint, isCancelled: () -> Bool) -> Hit? {
+        for (owner, frame) in selectedFrames {
+            let handle = DrawHoverSnapshot.handle(at: point, in: frame)
+            if handle.type != .missed {
+                return Hit(index: owner, handle: handle)
+            }
+        }
+
+        for (index, entry) in entries.enumerated() {
+            // Checking on every entry would cost more than the tests themselves.
+            if index % 64 == 0 && isCancelled() {
+                return nil
+            }
+            if !entry.bounds.contains(point) {
+                continue
+            }
+            guard let path = entry.path else {
+                return Hit(index: entry.owner, handle: DrawHandleMissed)
+            }
+            if (entry.filled && path.contains(point, evenOdd: entry.evenOdd))
+                || (entry.strokeWidth > 0.0 && path.isStrokeHit(by: point, width: entry.strokeWidth)) {
+                return Hit(index: entry.owner, handle: DrawHandleMissed)
+            }
+        }
+        return Hit(index: nil, handle: DrawHandleMissed)
+    }
+
+    /// The same test as `-[DrawGraphic handleForPoint:]`, against a copy of the frame.
+    internal class func handle(at point: NSPoint, in frame: NSRect) -> DrawHandle {
+        let adjustment = handleAdjustment
+        func near(_ value: CGFloat, _ target: CGFloat) -> Bool {
+            return value > target - adjustment && value < target + adjustment
+        }
+        var type = DrawHandleType.missed
+
+        if near(point.x, frame.minX) {
+            if near(point.y, frame.minY) { type = .topLeft }
+            else if near(point.y, frame.maxY) { type = .bottomLeft }
+            else if near(point.y, frame.midY) { type = .left }
+        } else if near(point.x, frame.maxX) {
+            if near(point.y, frame.minY) { type = .topRight }
+            else if near(point.y, frame.maxY) { type = .bottomRight }
+            else if near(point.y, frame.midY) { type = .right }
+        } else if near(point.x, frame.midX) {
+            if near(point.y, frame.minY) { type = .topCenter }
+            else if near(point.y, frame.maxY) { type = .bottomCenter }
+        }
+        return DrawHandleMake(type, 0, 0)
+    }
+
+}
@@ -151,8 +151,10 @@
 						[self addGraphic:graphic toLayer:[_document layer]];
 					}
 					
+					[_document beginSelectionChanges];
 					[_document clearSelection];
 					[_document addGraphicsToSelection:graphics];
+					[_document endSelectionChanges];
 				}
 			}
 			return YES;
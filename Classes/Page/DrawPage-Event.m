@@ -77,6 +77,8 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
 
 - (void)mouseDown:(NSEvent *)event {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    DrawEventTrace *trace = [DrawEventTracer traceEvent:drawEvent named:@"mouseDown" tool:_document.currentTool];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
@@ -85,26 +87,36 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
     } else {
         [[self window] makeFirstResponder:self];
     }
+
+    [trace endDispatch];
 }
 
 - (void)mouseDragged:(NSEvent *)event {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    DrawEventTrace *trace = [DrawEventTracer traceEvent:drawEvent named:@"mouseDragged" tool:_document.currentTool];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
     if (![[_document currentTool] mouseDragged:drawEvent]) {
         [self makeSelectionPerformSelector:@selector(mouseDragged:) withObject:drawEvent shortCircuit:YES];
     }
+
+    [trace endDispatch];
 }
 
 - (void)mouseUp:(NSEvent *)event {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    DrawEventTrace *trace = [DrawEventTracer traceEvent:drawEvent named:@"mouseUp" tool:_document.currentTool];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
     if (![[_document currentTool] mouseUp:drawEvent]) {
         [self makeSelectionPerformSelector:@selector(mouseUp:) withObject:drawEvent shortCircuit:YES];
     }
+
+    [trace endDispatch];
 }
 
 - (BOOL)acceptsFirstMouse:(NSEvent *)theEvent {
@@ -115,6 +127,8 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
 
 - (void)mouseMoved:(NSEvent *)event {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    DrawEventTrace *trace = [DrawEventTracer traceEvent:drawEvent named:@"mouseMoved" tool:_document.currentTool];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
@@ -123,6 +137,11 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
     } else {
         [[self window] makeFirstResponder:self];
     }
+
+    // Only the hover hit test moves off the main thread. It reports back to the tool when what's under the mouse changes.
+    [[self hoverTester] hoverAt:[drawEvent locationOnPage]];
+
+    [trace endDispatch];
 }
 
 - (void)mouseEntered:(NSEvent *)event {
@@ -150,6 +169,7 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
         [[self window] makeFirstResponder:self];
     }
 
+    [[self hoverTester] cancel];
     _mouseInPage = NO;
 }
 
@@ -161,6 +181,7 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
 
 - (void)rightMouseDown:(NSEvent *)event {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
@@ -175,6 +196,7 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
 
 - (void)rightMouseDragged:(NSEvent *)event {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
@@ -185,6 +207,7 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
 
 - (void)rightMouseUp:(NSEvent *)event  {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
@@ -231,6 +254,7 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
 
 - (void)keyDown:(NSEvent *)event {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
@@ -268,6 +292,7 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
 
 - (void)keyUp:(NSEvent *)event  {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
@@ -280,6 +305,7 @@ typedef BOOL (*DrawMethod)(id, SEL, id);
 
 - (void)flagsChanged:(NSEvent *)event {
     DrawEvent *drawEvent = [DrawEvent eventWithOriginalEvent:event document:_document page:self];
+    [DrawEventRecorder recordDrawEvent:drawEvent];
 
     [_document setPage:self];
 
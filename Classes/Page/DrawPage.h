@@ -32,7 +32,7 @@
 #import <AppKit/AppKit.h>
 #import <AJRInterface/AJRInterface.h>
 
-@class DrawGraphic, DrawLayer, DrawTool, DrawDocument;
+@class DrawGraphic, DrawHandleRenderer, DrawLayer, DrawLinkRouter, DrawPageOverlayView, DrawTool, DrawDocument, DrawHoverTester, DrawRenderStatistics;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -46,6 +46,12 @@ typedef void (^DrawGuestDrawer)(DrawPage *page, NSRect dirtyRect);
 extern const AJRInspectorIdentifier DrawInspectorIdentifierPage;
 extern const AJRInspectorContentIdentifier DrawInspectorContentIdentifierPage;
 
+// Defaults
+
+extern NSString * const DrawCollectRenderStatisticsKey;
+extern NSString * const DrawShowRenderStatisticsKey;
+extern NSString * const DrawMaximumSelectionHandleGraphicsKey;
+
 @interface DrawPage : NSView <NSCoding> {
     __weak DrawDocument *_document;
     NSMutableDictionary<NSString *, NSMutableArray<DrawGraphic *> *> *_layers;
@@ -75,6 +81,8 @@ extern const AJRInspectorContentIdentifier DrawInspectorContentIdentifierPage;
 @property (nonatomic,weak) DrawDocument *document;
 @property (nonatomic,strong,null_resettable) NSColor *paperColor;
 @property (nonatomic,readonly) BOOL isPrinting;
+/// `YES` while the page is inside -drawForExportInRect:. Graphics use this to stay at full fidelity, rather than dropping to a reduced level of detail.
+@property (nonatomic,readonly) BOOL isDrawingForExport;
 
 #pragma mark - Layout
 
@@ -99,6 +107,12 @@ extern const AJRInspectorContentIdentifier DrawInspectorContentIdentifierPage;
 #pragma mark - Layers
 
 - (void)drawLayer:(DrawLayer *)layer inRect:(NSRect)rect;
+/*! Draws the handles of the selected graphics on the page, above all the layers. When more than +maximumSelectionHandleGraphics graphics are selected, their handles are collapsed into a single outline around the selection. */
+- (void)drawSelectionHandlesInRect:(NSRect)rect;
+/*! Draws everything that goes in the page's overlay view: the page markings, the page number, the selection handles, and the guest drawers. Called by the overlay, so it must only be called while the overlay is drawing. */
+- (void)drawOverlayInRect:(NSRect)rect;
+/*! Draws the page the way it'll appear in an export: paper, plus the visible, printable layers. Unlike the page on screen, this doesn't draw the grid, or anything from the overlay view, such as markings, handles, or guest drawers. It doesn't depend on the view being in a window, so it can be called against any graphics context, including off the main thread. */
+- (void)drawForExportInRect:(NSRect)rect;
 - (void)drawPageNumber:(NSInteger)aPageNumber inRect:(NSRect)rect;
 - (void)drawMarksInRect:(NSRect)rect;
 - (void)drawPageMarkingsInRect:(NSRect)rect;
@@ -116,12 +130,53 @@ extern const AJRInspectorContentIdentifier DrawInspectorContentIdentifierPage;
 @property (nonatomic,readonly) CGFloat scale;
 @property (nonatomic,readonly) CGFloat error;
 
+#pragma mark - Render Statistics
+
+/*! When YES, every page records a DrawRenderStatistics for each frame it draws. */
++ (BOOL)collectsRenderStatistics;
++ (void)setCollectsRenderStatistics:(BOOL)flag;
+/*! When YES, pages collect statistics and draw them over the top left of their visible rect. */
++ (BOOL)showsRenderStatistics;
++ (void)setShowsRenderStatistics:(BOOL)flag;
+
+/*! The statistics for the frame being drawn. This is only non-nil while drawing, and only when collecting, so graphics and aspects can cheaply check it before reporting. */
+@property (nullable,nonatomic,readonly) DrawRenderStatistics *renderStatistics;
+/*! The statistics for the most recently completed frame. */
+@property (nullable,nonatomic,readonly) DrawRenderStatistics *lastRenderStatistics;
+
+#pragma mark - Handles
+
+/*! Above this many selected graphics, pages outline the selection rather than drawing each graphic's handles. */
++ (NSUInteger)maximumSelectionHandleGraphics;
++ (void)setMaximumSelectionHandleGraphics:(NSUInteger)count;
+
+/*! Collects handles while the page draws its selection, and draws them in one pass. Created on first use. */
+@property (nonatomic,readonly) DrawHandleRenderer *handleRenderer;
+
+#pragma mark - Overlay
+
+/*! The transparent view over the page that draws the selection, page markings, and guest drawers, so that they can change without redrawing the page's graphics. */
+@property (nonatomic,readonly) DrawPageOverlayView *overlayView;
+
+/*! Marks `rect` as needing display in the overlay only. Use this, rather than -setNeedsDisplayInRect:, when only the selection, the handles, or a guest drawer changed. Invalidating the page also invalidates the overlay, since handles follow their graphics. */
+- (void)setOverlayNeedsDisplayInRect:(NSRect)rect;
+
+#pragma mark - Hover
+
+/*! Finds the graphic and selection handle under the mouse on a background queue as the mouse moves. */
+@property (nonatomic,readonly) DrawHoverTester *hoverTester;
+
+#pragma mark - Links
+
+/*! Routes the page's orthogonal links, and keeps the spatial indexes they need. Created on first use. */
+@property (nonatomic,readonly) DrawLinkRouter *linkRouter;
+
 #pragma mark - Guest drawers
 
 /*!
- Adds a guest drawer to the page. This is a block added to the page called during the page's drawRect: method. Note that this method doesn't dirty the page. If you actually want the block called, you'll need to also call setNeedsDisplayInRect:. The block passed with be called with a reference to the page and the dirtyRect as passed into -drawRect:.
+ Adds a guest drawer to the page. This is a block called when the page's overlay view draws. Note that this method doesn't dirty the page. If you actually want the block called, you'll need to also call setOverlayNeedsDisplayInRect:. The block passed with be called with a reference to the page and the dirtyRect as passed to the overlay's -drawRect:.
 
- Currently, all guest drawing is done after everything else.
+ Guest drawing is done over the graphics and the selection handles.
 
  @param drawer The block to call when drawing is being done.
 
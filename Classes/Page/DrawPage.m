@@ -42,11 +42,27 @@
 const AJRInspectorIdentifier DrawInspectorIdentifierPage = @"page";
 const AJRInspectorContentIdentifier DrawInspectorContentIdentifierPage = @"page";
 
+NSString * const DrawCollectRenderStatisticsKey = @"DrawCollectRenderStatistics";
+NSString * const DrawShowRenderStatisticsKey = @"DrawShowRenderStatistics";
+NSString * const DrawMaximumSelectionHandleGraphicsKey = @"DrawMaximumSelectionHandleGraphics";
+
 @implementation DrawPage {
     NSMutableDictionary<NSString *, DrawGuestDrawer> *_guestDrawers;
+    DrawRenderStatistics *_renderStatistics;
+    DrawRenderStatistics *_lastRenderStatistics;
+    DrawHoverTester *_hoverTester;
+    DrawLinkRouter *_linkRouter;
+    NSInteger _exportDrawingDepth;
+    DrawHandleRenderer *_handleRenderer;
+    DrawPageOverlayView *_overlayView;
+    // The selection outline we last drew, if any, so we can erase it when it changes.
+    NSRect _selectionOutline;
 }
 
 static NSDictionary *_pageNumberAttributes = nil;
+static BOOL _collectsRenderStatistics = NO;
+static BOOL _showsRenderStatistics = NO;
+static NSUInteger _maximumSelectionHandleGraphics = 1000;
 
 + (void)initialize {
     static dispatch_once_t onceToken;
@@ -55,6 +71,14 @@ static NSDictionary *_pageNumberAttributes = nil;
         [style setAlignment:NSTextAlignmentRight];
         _pageNumberAttributes = @{NSForegroundColorAttributeName:NSColor.disabledControlTextColor,
                                   NSParagraphStyleAttributeName:style};
+
+        [[NSUserDefaults standardUserDefaults] registerDefaults:@{DrawCollectRenderStatisticsKey:@(NO),
+                                                                  DrawShowRenderStatisticsKey:@(NO),
+                                                                  DrawMaximumSelectionHandleGraphicsKey:@(1000),
+                                                                }];
+        _collectsRenderStatistics = [NSUserDefaults.standardUserDefaults boolForKey:DrawCollectRenderStatisticsKey];
+        _showsRenderStatistics = [NSUserDefaults.standardUserDefaults boolForKey:DrawShowRenderStatisticsKey];
+        _maximumSelectionHandleGraphics = (NSUInteger)[NSUserDefaults.standardUserDefaults integerForKey:DrawMaximumSelectionHandleGraphicsKey];
     });
 }
 
@@ -101,6 +125,10 @@ static NSDictionary *_pageNumberAttributes = nil;
 }
 
 - (void)setDocument:(DrawDocument *)document {
+    if (_document != document) {
+        // The tester only listens to one document.
+        _hoverTester = nil;
+    }
     _document = document;
     // Make sure all of our graphics will not point to the document.
     [_layers enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSMutableArray<DrawGraphic *> *graphics, BOOL *stop) {
@@ -157,6 +185,8 @@ static NSDictionary *_pageNumberAttributes = nil;
     graphics = [_layers objectForKey:[layer name]];
     focused = [_document focusedGroup];
 
+    [_hoverTester invalidate];
+
     if (focused && ([focused layer] == layer)) {
         [focused addSubgraphic:graphic];
         if (![DrawGraphic notificationsAreDisabled]) {
@@ -178,16 +208,20 @@ static NSDictionary *_pageNumberAttributes = nil;
     
     [graphic setLayer:layer];
     [graphic setPage:self];
+    [_linkRouter graphicWasAdded:graphic];
 
     if (select) {
+        [_document beginSelectionChanges];
         if (!byExtension) {
             [_document clearSelection];
         }
         [_document addGraphicToSelection:graphic];
+        [_document endSelectionChanges];
     }
 }
 
 - (void)removeGraphic:(DrawGraphic *)graphic {
+    [_hoverTester invalidateGraphic:graphic];
     if (graphic.layer == nil) {
         // This happens when an abandoned graphic, usually due to an error in related graphics, gets left around.
         for (NSString *layerName in _layers.keyEnumerator) {
@@ -208,6 +242,7 @@ static NSDictionary *_pageNumberAttributes = nil;
         [graphics removeObjectIdenticalTo:graphic];
         [graphic graphicDidRemoveFromPage:self];
     }
+    [_linkRouter graphicWasRemoved:graphic];
 }
 
 - (void)replaceGraphic:(DrawGraphic *)oldGraphic withGraphic:(DrawGraphic *)newGraphic; {
@@ -222,6 +257,7 @@ static NSDictionary *_pageNumberAttributes = nil;
     
     index = [graphics indexOfObjectIdenticalTo:oldGraphic];
     if (index != NSNotFound) {
+        [_hoverTester invalidateGraphic:oldGraphic];
         [oldGraphic graphicWillRemoveFromPage:self];
         [newGraphic graphicWillAddToPage:self];
         [graphics replaceObjectAtIndex:index withObject:newGraphic];
@@ -229,6 +265,8 @@ static NSDictionary *_pageNumberAttributes = nil;
         [newGraphic setPage:self];
         [newGraphic graphicDidAddToPage:self];
         [oldGraphic graphicDidRemoveFromPage:self];
+        [_linkRouter graphicWasRemoved:oldGraphic];
+        [_linkRouter graphicWasAdded:newGraphic];
 
         [self setGraphicNeedsDisplayInRect:[oldGraphic bounds]];
     }
@@ -319,22 +357,22 @@ static NSDictionary *_pageNumberAttributes = nil;
 }
 
 - (void)drawRect:(NSRect)rect {
-    NSRect bounds = [self bounds];
     BOOL isPrinting = [self.enclosingPagedView prepareViewForPrinting:self];
     
+    [DrawEventTracer noteDrawBegan];
+
+    if (_collectsRenderStatistics || _showsRenderStatistics) {
+        _renderStatistics = [[DrawRenderStatistics alloc] init];
+        [_renderStatistics beginFrameInRect:rect];
+    }
+
     if (!isPrinting) {
         // Draw the background.
         [self.paperColor set];
         NSRectFill([self centerScanRect:rect]);
         
         // Draw the Grid
-        [_document drawGridInRect:bounds inView:self];
-        
-        // Draw Page Markings
-        [self drawPageMarkingsInRect:bounds];
-
-        // Draw the page number
-        [self drawPageNumber:[_document pageNumberForPage:self] inRect:bounds];
+        [_document drawGridInRect:rect inView:self];
     }
     
     // Finally, draw our actual graphics.
@@ -344,36 +382,155 @@ static NSDictionary *_pageNumberAttributes = nil;
         }
     }
 
+    // Markings, handles, and guest drawers are drawn by our overlay view, so they can change without us redrawing.
     if (isPrinting) {
         [NSColor.blackColor set];
         [[AJRBezierPath bezierPathWithRect:self.bounds] stroke];
     }
-    
-    // Finally, draw our guest drawers, if we have any.
-    if (!isPrinting) {
-        for (DrawGuestDrawer block in [_guestDrawers objectEnumerator]) {
-            block(self, rect);
+
+    if (_renderStatistics) {
+        [_renderStatistics endFrame];
+        _lastRenderStatistics = _renderStatistics;
+        _renderStatistics = nil;
+        if (!isPrinting && _showsRenderStatistics) {
+            [_lastRenderStatistics drawOverlayInVisibleRect:[self visibleRect] scale:[self scale]];
         }
     }
     
     [self.enclosingPagedView concludePrintingInView:self];
+
+    [DrawEventTracer noteDrawEnded];
 }
 
 - (void)drawLayer:(DrawLayer *)layer inRect:(NSRect)rect {
     for (DrawGraphic *graphic in _layers[layer.name]) {
-        if ([self needsToDrawRect:graphic.bounds]) {
+        BOOL needsDraw = [self needsToDrawRect:graphic.bounds];
+        [_renderStatistics noteGraphicConsidered:graphic drawn:needsDraw];
+        if (needsDraw) {
             [graphic draw];
         }
     }
-    
-    if (!self.isPrinting) {
-        // We don't draw handles when printing.
-        for (DrawGraphic *graphic in [_document sortedSelection]) {
-            if ([self needsToDrawRect:graphic.bounds]) {
+}
+
+- (void)drawOverlayInRect:(NSRect)rect {
+    NSRect bounds = [self bounds];
+
+    [self drawPageMarkingsInRect:bounds];
+    [self drawPageNumber:[_document pageNumberForPage:self] inRect:bounds];
+
+    // Handles go over every layer, so we draw them once for the whole selection.
+    [self drawSelectionHandlesInRect:rect];
+
+    // Finally, draw our guest drawers, if we have any.
+    for (DrawGuestDrawer block in [_guestDrawers objectEnumerator]) {
+        block(self, rect);
+    }
+}
+
+- (void)drawSelectionHandlesInRect:(NSRect)rect {
+    NSMutableArray<DrawGraphic *> *selection = [NSMutableArray array];
+    NSRect outline = NSZeroRect;
+
+    for (DrawGraphic *graphic in [_document sortedSelection]) {
+        if (graphic.page == self) {
+            [selection addObject:graphic];
+        }
+    }
+
+    if ([selection count] > _maximumSelectionHandleGraphics) {
+        // Too many handles to be any use, so just show where the selection is.
+        outline = selection[0].frame;
+        for (DrawGraphic *graphic in selection) {
+            outline = NSUnionRect(outline, graphic.frame);
+        }
+        outline = [self centerScanRect:outline];
+
+        AJRBezierPath *path = [AJRBezierPath bezierPathWithRect:outline];
+        [path setLineWidth:AJRHairLineWidth];
+        [path strokeWithColor:[NSColor selectedControlColor]];
+    } else {
+        DrawHandleRenderer *handleRenderer = [self handleRenderer];
+
+        [handleRenderer beginBatch];
+        for (DrawGraphic *graphic in selection) {
+            // We're called while the overlay draws, so it's the overlay that knows what's dirty.
+            if ([[self overlayView] needsToDrawRect:graphic.dirtyBounds]) {
                 [graphic drawHandles];
             }
         }
+        [handleRenderer endBatch];
+    }
+
+    if (!NSEqualRects(outline, _selectionOutline)) {
+        // Graphics only invalidate their own bounds as the selection changes, which won't cover the whole of an outline around them all.
+        if (!NSIsEmptyRect(_selectionOutline)) {
+            [self _setNeedsDisplayInEdgesOfRect:_selectionOutline];
+        }
+        _selectionOutline = outline;
+    }
+}
+
+- (void)_setNeedsDisplayInEdgesOfRect:(NSRect)rect {
+    CGFloat width = ceil(2.0 / [self scale]);
+
+    [self setOverlayNeedsDisplayInRect:(NSRect){{NSMinX(rect) - width, NSMinY(rect) - width}, {NSWidth(rect) + 2.0 * width, 2.0 * width}}];
+    [self setOverlayNeedsDisplayInRect:(NSRect){{NSMinX(rect) - width, NSMaxY(rect) - width}, {NSWidth(rect) + 2.0 * width, 2.0 * width}}];
+    [self setOverlayNeedsDisplayInRect:(NSRect){{NSMinX(rect) - width, NSMinY(rect) - width}, {2.0 * width, NSHeight(rect) + 2.0 * width}}];
+    [self setOverlayNeedsDisplayInRect:(NSRect){{NSMaxX(rect) - width, NSMinY(rect) - width}, {2.0 * width, NSHeight(rect) + 2.0 * width}}];
+}
+
+#pragma mark - Handles
+
++ (NSUInteger)maximumSelectionHandleGraphics {
+    return _maximumSelectionHandleGraphics;
+}
+
++ (void)setMaximumSelectionHandleGraphics:(NSUInteger)count {
+    _maximumSelectionHandleGraphics = count;
+}
+
+- (DrawHandleRenderer *)handleRenderer {
+    if (_handleRenderer == nil) {
+        _handleRenderer = [[DrawHandleRenderer alloc] initWithPage:self];
+    }
+    return _handleRenderer;
+}
+
+- (BOOL)isDrawingForExport {
+    return _exportDrawingDepth > 0;
+}
+
+- (void)drawForExportInRect:(NSRect)rect {
+    _exportDrawingDepth += 1;
+
+    if (_collectsRenderStatistics) {
+        _renderStatistics = [[DrawRenderStatistics alloc] init];
+        [_renderStatistics beginFrameInRect:rect];
+    }
+
+    [self.paperColor set];
+    NSRectFill(rect);
+
+    for (DrawLayer *layer in [_document layers]) {
+        if ([layer visible] && [layer printable]) {
+            // Don't use -needsToDrawRect:, since we're not being called from within a display cycle.
+            for (DrawGraphic *graphic in _layers[layer.name]) {
+                BOOL needsDraw = NSIntersectsRect(rect, graphic.bounds);
+                [_renderStatistics noteGraphicConsidered:graphic drawn:needsDraw];
+                if (needsDraw) {
+                    [graphic draw];
+                }
+            }
+        }
+    }
+
+    if (_renderStatistics) {
+        [_renderStatistics endFrame];
+        _lastRenderStatistics = _renderStatistics;
+        _renderStatistics = nil;
     }
+
+    _exportDrawingDepth -= 1;
 }
 
 - (NSMutableArray<DrawGraphic *> *)graphicsForLayer:(DrawLayer *)layer {
@@ -385,6 +542,10 @@ static NSDictionary *_pageNumberAttributes = nil;
     NSArray<DrawGraphic *> *graphics;
     DrawGraphic *group = [_document focusedGroup];
     NSMutableArray<DrawGraphic *> *hitGraphics;
+    NSGraphicsContext *context = [NSGraphicsContext currentContext];
+
+    // Install the hit context once for the whole test, rather than having every graphic swap it in and out.
+    [NSGraphicsContext setCurrentContext:[DrawGraphic hitContext]];
 
     // This prehaps isn't the most efficient method, but we're going to create an array of all the graphic underneath the mouse down. This will allow us to process the current selection in a fairly complex way. See below for details.
     hitGraphics = [[NSMutableArray alloc] init];
@@ -408,6 +569,8 @@ static NSDictionary *_pageNumberAttributes = nil;
         }
     }
 
+    [NSGraphicsContext setCurrentContext:context];
+
     return hitGraphics;
 }
 
@@ -457,6 +620,8 @@ static NSDictionary *_pageNumberAttributes = nil;
 
 - (void)graphicWillChange:(DrawGraphic *)graphic {
     //AJRPrintf(@"%@\n", NSStringFromRect([graphic bounds]));
+    [DrawEventTracer noteMutation];
+    [_hoverTester invalidateGraphic:graphic];
     if (![_changedGraphics count]) {
         _updateRect = NSIntegralRect([graphic bounds]);
         [self performSelector:@selector(updateGraphics) withObject:nil afterDelay:0.00001];
@@ -521,16 +686,137 @@ static NSDictionary *_pageNumberAttributes = nil;
     return self.frame.size.width / self.bounds.size.width;
 }
 
+- (void)setFrameSize:(NSSize)newSize {
+    CGFloat oldScale = [self scale];
+
+    [super setFrameSize:newSize];
+    [self _updateOverlayFrame];
+
+    // A zoom. Draw everything at interactive quality until the zooming stops.
+    if ([self window] != nil && oldScale != [self scale]) {
+        [_document beginInteractiveDrawingOfGraphics:nil];
+        [_document endInteractiveDrawing];
+    }
+}
+
+- (void)setBoundsSize:(NSSize)newSize {
+    [super setBoundsSize:newSize];
+    [self _updateOverlayFrame];
+}
+
+- (void)setBoundsOrigin:(NSPoint)newOrigin {
+    [super setBoundsOrigin:newOrigin];
+    [self _updateOverlayFrame];
+}
+
 - (CGFloat)error {
     return 0.5 / (self.frame.size.width / self.bounds.size.width);
 }
 
 - (void)setNeedsDisplayInRect:(NSRect)invalidRect {
+    [DrawEventTracer noteInvalidation];
     if ([DrawGraphic showsDirtyBounds]) {
         [super setNeedsDisplayInRect:[self bounds]];
+        [_overlayView setNeedsDisplay:YES];
     } else {
         [super setNeedsDisplayInRect:invalidRect];
+        // Handles move with their graphics, so anything that dirties content may also dirty the selection.
+        [_overlayView setNeedsDisplayInRect:invalidRect];
+        if (_showsRenderStatistics) {
+            // Anything that redraws content also changes the numbers, so keep the statistics current.
+            [super setNeedsDisplayInRect:[DrawRenderStatistics overlayRectForVisibleRect:[self visibleRect] scale:[self scale]]];
+        }
+    }
+}
+
+- (void)setNeedsDisplay:(BOOL)flag {
+    [super setNeedsDisplay:flag];
+    [_overlayView setNeedsDisplay:flag];
+}
+
+#pragma mark - Overlay
+
+- (DrawPageOverlayView *)overlayView {
+    if (_overlayView == nil) {
+        _overlayView = [[DrawPageOverlayView alloc] initWithPage:self];
+        [self addSubview:_overlayView];
+        [self _updateOverlayFrame];
+    }
+    return _overlayView;
+}
+
+- (void)_updateOverlayFrame {
+    // The overlay covers our bounds and shares our coordinates, so rects pass between us unchanged. Our scale is applied to it by the view hierarchy.
+    if (_overlayView != nil) {
+        NSRect bounds = self.bounds;
+        if (!NSEqualRects(_overlayView.frame, bounds)) {
+            [_overlayView setFrame:bounds];
+        }
+        if (!NSEqualPoints(_overlayView.bounds.origin, bounds.origin)) {
+            [_overlayView setBoundsOrigin:bounds.origin];
+        }
+    }
+}
+
+- (void)setOverlayNeedsDisplayInRect:(NSRect)rect {
+    [DrawEventTracer noteInvalidation];
+    if ([DrawGraphic showsDirtyBounds]) {
+        [[self overlayView] setNeedsDisplay:YES];
+    } else {
+        [[self overlayView] setNeedsDisplayInRect:rect];
+    }
+}
+
+- (void)viewDidMoveToWindow {
+    [super viewDidMoveToWindow];
+    if (self.window != nil) {
+        // Make sure we have an overlay before we first draw, since it's what draws our markings.
+        [self overlayView];
+    }
+}
+
+#pragma mark - Render Statistics
+
++ (BOOL)collectsRenderStatistics {
+    return _collectsRenderStatistics;
+}
+
++ (void)setCollectsRenderStatistics:(BOOL)flag {
+    _collectsRenderStatistics = flag;
+}
+
++ (BOOL)showsRenderStatistics {
+    return _showsRenderStatistics;
+}
+
++ (void)setShowsRenderStatistics:(BOOL)flag {
+    _showsRenderStatistics = flag;
+}
+
+- (DrawRenderStatistics *)renderStatistics {
+    return _renderStatistics;
+}
+
+- (DrawRenderStatistics *)lastRenderStatistics {
+    return _lastRenderStatistics;
+}
+
+#pragma mark - Hover
+
+- (DrawHoverTester *)hoverTester {
+    if (_hoverTester == nil) {
+        _hoverTester = [[DrawHoverTester alloc] initWithPage:self];
+    }
+    return _hoverTester;
+}
+
+#pragma mark - Links
+
+- (DrawLinkRouter *)linkRouter {
+    if (_linkRouter == nil) {
+        _linkRouter = [[DrawLinkRouter alloc] initWithPage:self];
     }
+    return _linkRouter;
 }
 
 #pragma mark - Guest drawers
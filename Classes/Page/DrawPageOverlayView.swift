@@ -0,0 +1,80 @@
+/*
+ DrawPageOverlayView.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/**
+ Everything the page draws over its graphics that isn't part of the document: the margins and marks, the page number, the selection handles, and the guest drawers, such as the selection marquee or a tool's preview.
+
+ These used to be drawn at the end of `-[DrawPage drawRect:]`, which meant selecting a graphic, hovering, or animating the marquee redrew every graphic under the invalidated rect just to repaint a few handles. The overlay is a transparent, layer-backed subview covering the whole page, so its drawing is composited over the page's cached content, and invalidating it with `-[DrawPage setOverlayNeedsDisplayInRect:]` never causes a graphic to redraw.
+
+ The overlay shares the page's coordinate system, and takes no part in hit testing, so events still go to the page.
+ */
+@objcMembers
+open class DrawPageOverlayView : NSView {
+
+    open private(set) weak var page : DrawPage?
+
+    public init(page: DrawPage) {
+        self.page = page
+        super.init(frame: page.bounds)
+        wantsLayer = true
+        layerContentsRedrawPolicy = .onSetNeedsDisplay
+    }
+
+    public required init?(coder: NSCoder) {
+        super.init(coder: coder)
+    }
+
+    // MARK: - NSView
+
+    open override var isFlipped : Bool {
+        return page?.isFlipped ?? true
+    }
+
+    open override var isOpaque : Bool {
+        return false
+    }
+
+    open override func hitTest(_ point: NSPoint) -> NSView? {
+        return nil
+    }
+
+    open override func draw(_ dirtyRect: NSRect) {
+        // Nothing in the overlay belongs in a print or a PDF.
+        guard let page, NSGraphicsContext.currentContextDrawingToScreen(), !page.isPrinting else { return }
+        // Selection and hover changes often only redraw the overlay, so it has to count as a draw for event latency.
+        DrawEventTracer.noteDrawBegan()
+        page.drawOverlay(in: dirtyRect)
+        DrawEventTracer.noteDrawEnded()
+    }
+
+}
@@ -0,0 +1,172 @@
+/*
+ DrawRenderStatistics.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+
+/// Totals for one aspect class during a frame.
+@objcMembers
+open class DrawAspectRenderStatistics : NSObject {
+
+    open internal(set) var draws = 0
+    /// Seconds.
+    open internal(set) var time : TimeInterval = 0.0
+
+}
+
+/**
+ Counts what happens during a single `-[DrawPage drawRect:]`.
+
+ Collection is off by default, and when it's off, the page never creates one of these, so the only cost paid by drawing is a nil check. Turn it on with `DrawPage.collectsRenderStatistics`, or turn on `DrawPage.showsRenderStatistics` to also see the numbers drawn on the canvas.
+ */
+@objcMembers
+open class DrawRenderStatistics : NSObject {
+
+    // MARK: - Properties
+
+    /// Top level graphics looked at by the page.
+    open internal(set) var graphicsConsidered = 0
+    /// Graphics skipped because they didn't intersect the dirty rect.
+    open internal(set) var graphicsCulled = 0
+    /// Graphics actually drawn. This includes subgraphics, which are drawn by their group.
+    open internal(set) var graphicsDrawn = 0
+    open internal(set) var aspectDraws = 0
+    /// Keyed by the aspect's class name.
+    open internal(set) var aspectStatistics = [String:DrawAspectRenderStatistics]()
+    /// Wall time for the whole frame, in seconds.
+    open internal(set) var frameTime : TimeInterval = 0.0
+    open internal(set) var dirtyRect = NSRect.zero
+
+    private var frameStart : UInt64 = 0
+
+    // MARK: - Collecting
+
+    @objc(beginFrameInRect:)
+    open func beginFrame(in dirtyRect: NSRect) {
+        self.dirtyRect = dirtyRect
+        frameStart = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+    }
+
+    open func endFrame() {
+        frameTime = TimeInterval(clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - frameStart) / 1.0e9
+    }
+
+    @objc(noteGraphicConsidered:drawn:)
+    open func noteGraphicConsidered(_ graphic: DrawGraphic, drawn: Bool) {
+        graphicsConsidered += 1
+        if !drawn {
+            graphicsCulled += 1
+        }
+    }
+
+    open func noteGraphicDrawn(_ graphic: DrawGraphic) {
+        graphicsDrawn += 1
+    }
+
+    /// `duration` is in nanoseconds, since that's what the caller has on hand.
+    @objc(noteAspect:drewInNanoseconds:)
+    open func noteAspect(_ aspect: DrawAspect, drewIn duration: UInt64) {
+        let name = NSStringFromClass(type(of: aspect))
+        let statistics : DrawAspectRenderStatistics
+        if let existing = aspectStatistics[name] {
+            statistics = existing
+        } else {
+            statistics = DrawAspectRenderStatistics()
+            aspectStatistics[name] = statistics
+        }
+        statistics.draws += 1
+        statistics.time += TimeInterval(duration) / 1.0e9
+        aspectDraws += 1
+    }
+
+    // MARK: - Reporting
+
+    /// Aspect class names, most expensive first.
+    open var aspectNamesByTime : [String] {
+        return aspectStatistics.keys.sorted { aspectStatistics[$0]!.time > aspectStatistics[$1]!.time }
+    }
+
+    /// A property list representation, suitable for JSON.
+    open var dictionaryRepresentation : [String:Any] {
+        var aspects = [String:Any]()
+        for (name, statistics) in aspectStatistics {
+            aspects[name] = ["draws": statistics.draws, "time": statistics.time]
+        }
+        return ["graphicsConsidered": graphicsConsidered,
+                "graphicsCulled": graphicsCulled,
+                "graphicsDrawn": graphicsDrawn,
+                "aspectDraws": aspectDraws,
+                "frameTime": frameTime,
+                "aspects": aspects]
+    }
+
+    open override var description: String {
+        var lines = [String(format: "frame %.2f ms", frameTime * 1000.0),
+                     "graphics \(graphicsConsidered) considered, \(graphicsCulled) culled, \(graphicsDrawn) drawn",
+                     "aspects \(aspectDraws) draws"]
+        for name in aspectNamesByTime {
+            let statistics = aspectStatistics[name]!
+            // Strip the module, if any, since Swift class names are otherwise long.
+            let shortName = name.components(separatedBy: ".").last ?? name
+            lines.append(String(format: "  %@ %ld × %.2f ms", shortName, statistics.draws, statistics.time * 1000.0))
+        }
+        return lines.joined(separator: "\n")
+    }
+
+    // MARK: - Overlay
+
+    internal static var overlayAttributes : [NSAttributedString.Key:Any] = [
+        .font: NSFont.monospacedSystemFont(ofSize: 10.0, weight: .regular),
+        .foregroundColor: NSColor.white,
+    ]
+
+    /// The rect the overlay occupies, in page coordinates, for a page showing `visibleRect` at `scale`.
+    open class func overlayRect(forVisibleRect visibleRect: NSRect, scale: CGFloat) -> NSRect {
+        let size = NSSize(width: 260.0 / scale, height: 150.0 / scale)
+        return NSRect(x: visibleRect.minX + 8.0 / scale, y: visibleRect.minY + 8.0 / scale, width: size.width, height: size.height)
+    }
+
+    /// Draws the statistics into the top left corner of `visibleRect`. Text is kept at a constant size on screen, regardless of `scale`.
+    open func drawOverlay(inVisibleRect visibleRect: NSRect, scale: CGFloat) {
+        let rect = DrawRenderStatistics.overlayRect(forVisibleRect: visibleRect, scale: scale)
+
+        NSGraphicsContext.saveGraphicsState()
+        NSColor(calibratedWhite: 0.0, alpha: 0.7).set()
+        NSBezierPath(roundedRect: rect, xRadius: 4.0 / scale, yRadius: 4.0 / scale).fill()
+
+        let transform = NSAffineTransform()
+        transform.translateX(by: rect.minX + 6.0 / scale, yBy: rect.minY + 4.0 / scale)
+        transform.scale(by: 1.0 / scale)
+        transform.concat()
+        (description as NSString).draw(in: NSRect(x: 0.0, y: 0.0, width: rect.width * scale - 12.0, height: rect.height * scale - 8.0), withAttributes: DrawRenderStatistics.overlayAttributes)
+        NSGraphicsContext.restoreGraphicsState()
+    }
+
+}
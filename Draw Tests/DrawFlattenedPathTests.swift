@@ -0,0 +1,146 @@
+/*
+ DrawFlattenedPathTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawFlattenedPathTests: XCTestCase {
+
+    func makeSquare() -> DrawFlattenedPath {
+        let path = AJRBezierPath()
+        path.move(to: NSPoint(x: 0.0, y: 0.0))
+        path.line(to: NSPoint(x: 100.0, y: 0.0))
+        path.line(to: NSPoint(x: 100.0, y: 100.0))
+        path.line(to: NSPoint(x: 0.0, y: 100.0))
+        return DrawFlattenedPath(path: path, flatness: 1.0)
+    }
+
+    func testStrokeHitByPoint() {
+        let square = makeSquare()
+
+        XCTAssert(square.isStrokeHit(by: NSPoint(x: 50.0, y: 1.0), width: 4.0))
+        XCTAssertFalse(square.isStrokeHit(by: NSPoint(x: 50.0, y: 3.0), width: 4.0))
+        // The subpath is open, so the left edge isn't stroked.
+        XCTAssertFalse(square.isStrokeHit(by: NSPoint(x: 0.0, y: 50.0), width: 4.0))
+    }
+
+    func testStrokeHitByRect() {
+        let square = makeSquare()
+
+        XCTAssert(square.isStrokeHit(by: NSRect(x: 90.0, y: 40.0, width: 20.0, height: 20.0), width: 1.0))
+        XCTAssertFalse(square.isStrokeHit(by: NSRect(x: 40.0, y: 40.0, width: 20.0, height: 20.0), width: 1.0))
+    }
+
+    func testFill() {
+        let square = makeSquare()
+
+        // Fills close open subpaths.
+        XCTAssert(square.contains(NSPoint(x: 50.0, y: 50.0), evenOdd: false))
+        XCTAssertFalse(square.contains(NSPoint(x: 150.0, y: 50.0), evenOdd: false))
+        XCTAssert(square.intersects(NSRect(x: 40.0, y: 40.0, width: 20.0, height: 20.0), evenOdd: false))
+        XCTAssert(square.intersects(NSRect(x: -10.0, y: 40.0, width: 20.0, height: 20.0), evenOdd: false))
+        XCTAssertFalse(square.intersects(NSRect(x: 200.0, y: 40.0, width: 20.0, height: 20.0), evenOdd: false))
+    }
+
+    func testWindingRules() {
+        let path = AJRBezierPath()
+        path.appendRect(NSRect(x: 0.0, y: 0.0, width: 100.0, height: 100.0))
+        path.appendRect(NSRect(x: 25.0, y: 25.0, width: 50.0, height: 50.0))
+        let flattened = DrawFlattenedPath(path: path, flatness: 1.0)
+
+        XCTAssert(flattened.contains(NSPoint(x: 50.0, y: 50.0), evenOdd: false))
+        XCTAssertFalse(flattened.contains(NSPoint(x: 50.0, y: 50.0), evenOdd: true))
+        XCTAssert(flattened.contains(NSPoint(x: 10.0, y: 10.0), evenOdd: true))
+    }
+
+    func testCurvesStayWithinFlatness() {
+        let path = AJRBezierPath()
+        path.appendOval(in: NSRect(x: 0.0, y: 0.0, width: 200.0, height: 200.0))
+        let flattened = DrawFlattenedPath(path: path, flatness: 0.5)
+
+        XCTAssert(flattened.segments.count > 8)
+        for angle in stride(from: 0.0, to: 2.0 * Double.pi, by: 0.1) {
+            let point = NSPoint(x: 100.0 + 100.0 * cos(angle), y: 100.0 + 100.0 * sin(angle))
+            XCTAssert(flattened.isStrokeHit(by: point, width: 1.0), "Missed \(point)")
+        }
+    }
+
+    func testHierarchyMatchesLinearScan() {
+        // A long zig-zag, so the path gets a segment hierarchy.
+        let path = AJRBezierPath()
+        path.move(to: NSPoint(x: 0.0, y: 0.0))
+        for index in 1 ... 2_000 {
+            path.line(to: NSPoint(x: CGFloat(index), y: index % 2 == 0 ? 0.0 : 50.0 + CGFloat(index % 7)))
+        }
+        let flattened = DrawFlattenedPath(path: path, flatness: 1.0)
+        XCTAssertNotNil(flattened.hierarchy)
+
+        var random = DrawSeededGenerator(seed: 37)
+        for _ in 0 ..< 500 {
+            let point = NSPoint(x: CGFloat.random(in: -10.0 ... 2010.0, using: &random), y: CGFloat.random(in: -10.0 ... 70.0, using: &random))
+            let radiusSquared = 4.0
+            let linearStroke = flattened.segments.contains { DrawFlattenedPath.distanceSquared(from: point, to: $0) <= radiusSquared }
+            XCTAssertEqual(flattened.isStrokeHit(by: point, width: 4.0), linearStroke, "Stroke mismatch at \(point)")
+
+            let linearWinding = DrawFlattenedPath.winding(of: point, in: flattened.segments) + DrawFlattenedPath.winding(of: point, in: flattened.closingSegments)
+            XCTAssertEqual(flattened.contains(point, evenOdd: false), linearWinding != 0, "Fill mismatch at \(point)")
+        }
+    }
+
+    func testDecimatedPathStaysWithinTolerance() {
+        let path = AJRBezierPath()
+        path.appendOval(in: NSRect(x: 0.0, y: 0.0, width: 200.0, height: 200.0))
+        let flattened = DrawFlattenedPath(path: path, flatness: 0.05)
+        let decimated = DrawFlattenedPath(path: flattened.decimatedPath(tolerance: 4.0), flatness: 0.05)
+
+        XCTAssert(decimated.segments.count < flattened.segments.count)
+        for segment in flattened.segments {
+            XCTAssert(decimated.isStrokeHit(by: segment.end, width: 10.0), "Drifted at \(segment.end)")
+        }
+        // The oval closes on itself, so the decimated copy should too.
+        XCTAssert(decimated.closingSegments.isEmpty)
+        XCTAssert(decimated.contains(NSPoint(x: 100.0, y: 100.0), evenOdd: false))
+    }
+
+    func testConcurrentQueries() {
+        let square = makeSquare()
+        var hits = [Bool](repeating: false, count: 1_000)
+
+        hits.withUnsafeMutableBufferPointer { buffer in
+            DispatchQueue.concurrentPerform(iterations: buffer.count) { index in
+                buffer[index] = square.isStrokeHit(by: NSPoint(x: CGFloat(index % 100), y: 0.0), width: 2.0)
+            }
+        }
+        XCTAssert(hits.allSatisfy { $0 })
+    }
+
+}
@@ -0,0 +1,165 @@
+/*
+ DrawGraphicTransformTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawGraphicTransformTests: XCTestCase {
+
+    override class func setUp() {
+        _ = AJRPlugInManager.shared
+    }
+
+    func makeSquiggle(pointCount: Int, on page: DrawPage) -> (DrawSquiggle, [NSPoint]) {
+        let points = DrawSyntheticDocumentGenerator.freehandPoints(count: pointCount)
+        let path = AJRBezierPath()
+        path.move(to: points[0])
+        for point in points.dropFirst() {
+            path.line(to: point)
+        }
+        let squiggle = DrawSquiggle(frame: path.bounds, path: path)
+        page.addGraphic(squiggle)
+        return (squiggle, points)
+    }
+
+    func makeGroup(childCount: Int, on page: DrawPage) -> DrawGraphic {
+        let generator = DrawSyntheticDocumentGenerator()
+        generator.groupSize = childCount
+        var random = DrawSeededGenerator(seed: 45)
+        let group = generator.createGroup(in: NSRect(x: 100.0, y: 100.0, width: 400.0, height: 400.0), using: &random)
+        page.addGraphic(group)
+        return group
+    }
+
+    func assertEqual(_ rect: NSRect, _ expected: NSRect, file: StaticString = #file, line: UInt = #line) {
+        XCTAssertEqual(rect.minX, expected.minX, accuracy: 1e-6, file: file, line: line)
+        XCTAssertEqual(rect.minY, expected.minY, accuracy: 1e-6, file: file, line: line)
+        XCTAssertEqual(rect.width, expected.width, accuracy: 1e-6, file: file, line: line)
+        XCTAssertEqual(rect.height, expected.height, accuracy: 1e-6, file: file, line: line)
+    }
+
+    // MARK: - Paths
+
+    func testMovedPathKeepsItsShape() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let (squiggle, points) = makeSquiggle(pointCount: 2_000, on: document.page)
+        let frame = squiggle.frame
+
+        for _ in 0 ..< 10 {
+            squiggle.frame = squiggle.frame.offsetBy(dx: 1.0, dy: 2.0)
+        }
+
+        let expected = frame.offsetBy(dx: 10.0, dy: 20.0)
+        assertEqual(squiggle.frame, expected)
+        assertEqual(squiggle.path.controlPointBounds, expected)
+        let first = squiggle.path.point(at: 0)
+        XCTAssertEqual(first.x, points[0].x + 10.0, accuracy: 1e-6)
+        XCTAssertEqual(first.y, points[0].y + 20.0, accuracy: 1e-6)
+    }
+
+    func testMovedPathHitsAtItsNewLocation() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let (squiggle, points) = makeSquiggle(pointCount: 500, on: document.page)
+
+        squiggle.frame = squiggle.frame.offsetBy(dx: 50.0, dy: 0.0)
+
+        XCTAssertTrue(squiggle.flattenedPath.isStrokeHit(by: NSPoint(x: points[250].x + 50.0, y: points[250].y), width: 3.0))
+    }
+
+    // MARK: - Groups
+
+    func testResizingGroupScalesChildren() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let group = makeGroup(childCount: 200, on: document.page)
+        let frame = group.frame
+        let children = try XCTUnwrap(group.subgraphics as? [DrawGraphic])
+        let childFrames = children.map { $0.frame }
+        let resized = NSRect(x: frame.minX - 20.0, y: frame.minY + 10.0, width: frame.width * 2.0, height: frame.height * 0.5)
+
+        group.frame = resized
+
+        for (child, childFrame) in zip(children, childFrames) {
+            let expected = NSRect(x: resized.minX + (childFrame.minX - frame.minX) * 2.0,
+                                  y: resized.minY + (childFrame.minY - frame.minY) * 0.5,
+                                  width: childFrame.width * 2.0,
+                                  height: childFrame.height * 0.5)
+            assertEqual(child.frame, expected)
+        }
+
+        // And back again.
+        group.frame = frame
+        for (child, childFrame) in zip(children, childFrames) {
+            assertEqual(child.frame, childFrame)
+        }
+    }
+
+    func testMovingGroupTranslatesChildren() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let group = makeGroup(childCount: 50, on: document.page)
+        let children = try XCTUnwrap(group.subgraphics as? [DrawGraphic])
+        let childFrames = children.map { $0.frame }
+        let pathBounds = children.map { $0.path.controlPointBounds }
+
+        group.frame = group.frame.offsetBy(dx: 30.0, dy: -15.0)
+
+        for (index, child) in children.enumerated() {
+            assertEqual(child.frame, childFrames[index].offsetBy(dx: 30.0, dy: -15.0))
+            assertEqual(child.path.controlPointBounds, pathBounds[index].offsetBy(dx: 30.0, dy: -15.0))
+        }
+    }
+
+    func testMovingGroupOffsetsLargeChildren() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let (squiggle, points) = makeSquiggle(pointCount: 2_000, on: document.page)
+        let group = DrawRectangle(frame: squiggle.frame.insetBy(dx: -10.0, dy: -10.0))
+        document.page.addGraphic(group)
+        document.page.removeGraphic(squiggle)
+        group.editing = true
+        group.addSubgraphic(squiggle)
+        group.editing = false
+        let frame = squiggle.frame
+        let bounds = squiggle.bounds
+
+        for _ in 0 ..< 10 {
+            group.frame = group.frame.offsetBy(dx: 3.0, dy: -1.0)
+        }
+
+        // The bounds come from the offset, before anything reads the path.
+        assertEqual(squiggle.bounds, bounds.offsetBy(dx: 30.0, dy: -10.0))
+        assertEqual(squiggle.frame, frame.offsetBy(dx: 30.0, dy: -10.0))
+        assertEqual(squiggle.path.controlPointBounds, frame.offsetBy(dx: 30.0, dy: -10.0))
+        let last = squiggle.path.point(at: points.count - 1)
+        XCTAssertEqual(last.x, points[points.count - 1].x + 30.0, accuracy: 1e-6)
+        XCTAssertEqual(last.y, points[points.count - 1].y - 10.0, accuracy: 1e-6)
+    }
+
+}
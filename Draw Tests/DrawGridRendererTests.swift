@@ -0,0 +1,62 @@
+/*
+ DrawGridRendererTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+@testable import Draw
+
+class DrawGridRendererTests: XCTestCase {
+
+    func testCellsPerTileLandsOnWholePixels() {
+        XCTAssertEqual(DrawGridRenderer.cellsPerTile(spacing: 9.0, deviceScale: 1.0), 1)
+        XCTAssertEqual(DrawGridRenderer.cellsPerTile(spacing: 7.2, deviceScale: 1.0), 5)
+        XCTAssertEqual(DrawGridRenderer.cellsPerTile(spacing: 7.2, deviceScale: 2.0), 5)
+        XCTAssertEqual(DrawGridRenderer.cellsPerTile(spacing: 7.25, deviceScale: 2.0), 2)
+        XCTAssertNil(DrawGridRenderer.cellsPerTile(spacing: 0.1 / 3.0, deviceScale: 1.0))
+    }
+
+    func testTilesAreCachedPerSpacingAndScale() throws {
+        let tile = try XCTUnwrap(DrawGridRenderer.tile(spacing: 7.2, deviceScale: 1.0, color: .gray))
+
+        XCTAssertEqual(tile.size, 36.0, accuracy: 1e-9)
+        XCTAssertEqual(tile.image.width, 36)
+        XCTAssertTrue(DrawGridRenderer.tile(spacing: 7.2, deviceScale: 1.0, color: .gray)?.image === tile.image)
+        XCTAssertEqual(try XCTUnwrap(DrawGridRenderer.tile(spacing: 7.2, deviceScale: 2.0, color: .gray)).image.width, 72)
+    }
+
+    func testTileCacheIsBounded() {
+        for index in 0 ..< DrawGridRenderer.maximumCachedTiles * 2 {
+            _ = DrawGridRenderer.tile(spacing: 4.0 + CGFloat(index), deviceScale: 1.0, color: .gray)
+        }
+        XCTAssertLessThanOrEqual(DrawGridRenderer.tiles.count, DrawGridRenderer.maximumCachedTiles)
+        XCTAssertEqual(DrawGridRenderer.tiles.count, DrawGridRenderer.tileOrder.count)
+    }
+
+}
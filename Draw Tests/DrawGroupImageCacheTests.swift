@@ -0,0 +1,93 @@
+/*
+ DrawGroupImageCacheTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawGroupImageCacheTests: XCTestCase {
+
+    func makeImage(width: Int, height: Int) throws -> CGImage {
+        let colorSpace = CGColorSpace(name: CGColorSpace.sRGB)!
+        let context = try XCTUnwrap(CGContext(data: nil, width: width, height: height, bitsPerComponent: 8, bytesPerRow: 0, space: colorSpace, bitmapInfo: CGImageAlphaInfo.premultipliedFirst.rawValue))
+        return try XCTUnwrap(context.makeImage())
+    }
+
+    func testLeastRecentlyUsedImagesAreDroppedToStayWithinBudget() throws {
+        let image = try makeImage(width: 100, height: 100)
+        let cost = image.bytesPerRow * image.height
+        let cache = DrawGroupImageCache(byteLimit: cost * 2)
+        let first = DrawGraphic(frame: NSRect(x: 0.0, y: 0.0, width: 10.0, height: 10.0))
+        let second = DrawGraphic(frame: NSRect(x: 0.0, y: 0.0, width: 10.0, height: 10.0))
+        let third = DrawGraphic(frame: NSRect(x: 0.0, y: 0.0, width: 10.0, height: 10.0))
+
+        XCTAssertTrue(cache.setImage(image, for: first))
+        XCTAssertTrue(cache.setImage(image, for: second))
+        // Drawing first again makes second the oldest.
+        XCTAssertNotNil(cache.image(for: first))
+        XCTAssertTrue(cache.setImage(image, for: third))
+
+        XCTAssertEqual(cache.count, 2)
+        XCTAssertLessThanOrEqual(cache.totalCost, cache.byteLimit)
+        XCTAssertNotNil(cache.image(for: first))
+        XCTAssertNil(cache.image(for: second))
+        XCTAssertNotNil(cache.image(for: third))
+
+        cache.byteLimit = cost
+        XCTAssertEqual(cache.count, 1)
+        XCTAssertNotNil(cache.image(for: third))
+    }
+
+    func testImagesLargerThanTheBudgetAreNotCached() throws {
+        let image = try makeImage(width: 100, height: 100)
+        let cache = DrawGroupImageCache(byteLimit: image.bytesPerRow * image.height - 1)
+        let graphic = DrawGraphic(frame: NSRect(x: 0.0, y: 0.0, width: 10.0, height: 10.0))
+
+        XCTAssertFalse(cache.setImage(image, for: graphic))
+        XCTAssertNil(cache.image(for: graphic))
+        XCTAssertEqual(cache.totalCost, 0)
+    }
+
+    func testMemoryPressureDropsEverything() throws {
+        let image = try makeImage(width: 100, height: 100)
+        let cache = DrawGroupImageCache(byteLimit: DrawGroupImageCache.defaultByteLimit)
+        let graphics = (0 ..< 4).map { _ in DrawGraphic(frame: NSRect(x: 0.0, y: 0.0, width: 10.0, height: 10.0)) }
+        for graphic in graphics {
+            cache.setImage(image, for: graphic)
+        }
+        XCTAssertEqual(cache.count, 4)
+
+        cache.didReceiveMemoryPressure()
+        XCTAssertEqual(cache.count, 0)
+        XCTAssertEqual(cache.totalCost, 0)
+    }
+
+}
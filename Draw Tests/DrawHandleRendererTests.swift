@@ -0,0 +1,83 @@
+/*
+ DrawHandleRendererTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawHandleRendererTests: XCTestCase {
+
+    override class func setUp() {
+        _ = AJRPlugInManager.shared
+    }
+
+    func withBitmapContext(_ size: NSSize, _ block: () throws -> Void) rethrows {
+        let context = CGContext(data: nil, width: Int(size.width), height: Int(size.height), bitsPerComponent: 8, bytesPerRow: 0, space: CGColorSpace(name: CGColorSpace.sRGB)!, bitmapInfo: CGImageAlphaInfo.premultipliedLast.rawValue)!
+        NSGraphicsContext.saveGraphicsState()
+        defer { NSGraphicsContext.restoreGraphicsState() }
+        NSGraphicsContext.current = NSGraphicsContext(cgContext: context, flipped: true)
+        try block()
+    }
+
+    func testBatchCollectsHandlesUntilEnded() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let page = document.page
+        let graphics = (0 ..< 10).map { DrawRectangle(frame: NSRect(x: CGFloat($0) * 30.0, y: 20.0, width: 20.0, height: 20.0)) }
+        for graphic in graphics {
+            page.addGraphic(graphic)
+        }
+        let renderer = page.handleRenderer
+
+        withBitmapContext(page.bounds.size) {
+            renderer.beginBatch()
+            XCTAssertTrue(renderer.isBatching)
+            graphics[0].drawHandles()
+            let perGraphic = renderer.points.count
+            XCTAssertGreaterThan(perGraphic, 0)
+            for graphic in graphics.dropFirst() {
+                graphic.drawHandles()
+            }
+            XCTAssertEqual(renderer.points.count, perGraphic * graphics.count)
+            renderer.endBatch()
+        }
+
+        XCTAssertFalse(renderer.isBatching)
+        XCTAssertTrue(renderer.points.isEmpty)
+    }
+
+    func testHandleImagesAreSharedPerSize() {
+        let first = DrawHandleRenderer.handleImage(pixelsWide: 8, pixelsHigh: 8)
+        XCTAssertNotNil(first)
+        XCTAssertTrue(first === DrawHandleRenderer.handleImage(pixelsWide: 8, pixelsHigh: 8))
+        XCTAssertFalse(first === DrawHandleRenderer.handleImage(pixelsWide: 16, pixelsHigh: 16))
+    }
+
+}
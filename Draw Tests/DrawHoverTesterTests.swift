@@ -0,0 +1,107 @@
+/*
+ DrawHoverTesterTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawHoverTesterTests: XCTestCase {
+
+    override class func setUp() {
+        _ = AJRPlugInManager.shared
+    }
+
+    func makeGraphic(frame: NSRect, on page: DrawPage) -> DrawGraphic {
+        let graphic = DrawRectangle(frame: frame)
+        graphic.addAspect(DrawFill(graphic: graphic, color: .red), with: .background)
+        page.addGraphic(graphic)
+        return graphic
+    }
+
+    func hit(_ tester: DrawHoverTester, at point: NSPoint) throws -> (graphic: DrawGraphic?, handle: DrawHandle) {
+        let snapshot = try XCTUnwrap(tester.currentSnapshot())
+        let hit = try XCTUnwrap(snapshot.hit(at: point, isCancelled: { false }))
+        return (hit.index.map { snapshot.graphics[$0] }, hit.handle)
+    }
+
+    func testFindsTheFrontmostGraphic() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let page = document.page
+        let back = makeGraphic(frame: NSRect(x: 100.0, y: 100.0, width: 100.0, height: 100.0), on: page)
+        let front = makeGraphic(frame: NSRect(x: 150.0, y: 150.0, width: 100.0, height: 100.0), on: page)
+        let tester = page.hoverTester
+
+        XCTAssertTrue(try hit(tester, at: NSPoint(x: 175.0, y: 175.0)).graphic === front)
+        XCTAssertTrue(try hit(tester, at: NSPoint(x: 120.0, y: 120.0)).graphic === back)
+        XCTAssertNil(try hit(tester, at: NSPoint(x: 400.0, y: 400.0)).graphic)
+    }
+
+    func testSelectedHandlesWin() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let page = document.page
+        let graphic = makeGraphic(frame: NSRect(x: 100.0, y: 100.0, width: 100.0, height: 100.0), on: page)
+        let tester = page.hoverTester
+
+        XCTAssertEqual(try hit(tester, at: NSPoint(x: 200.0, y: 200.0)).handle.type, .missed)
+        document.addGraphic(toSelection: graphic)
+        let result = try hit(tester, at: NSPoint(x: 200.0, y: 200.0))
+        XCTAssertTrue(result.graphic === graphic)
+        XCTAssertNotEqual(result.handle.type, .missed)
+    }
+
+    func testEditedGraphicIsFoundAtItsNewLocation() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let page = document.page
+        let moved = makeGraphic(frame: NSRect(x: 100.0, y: 100.0, width: 50.0, height: 50.0), on: page)
+        let other = makeGraphic(frame: NSRect(x: 300.0, y: 100.0, width: 50.0, height: 50.0), on: page)
+        let tester = page.hoverTester
+        XCTAssertTrue(try hit(tester, at: NSPoint(x: 125.0, y: 125.0)).graphic === moved)
+
+        moved.frame = moved.frame.offsetBy(dx: 0.0, dy: 200.0)
+        tester.invalidate(moved)
+
+        XCTAssertNil(try hit(tester, at: NSPoint(x: 125.0, y: 125.0)).graphic)
+        XCTAssertTrue(try hit(tester, at: NSPoint(x: 125.0, y: 325.0)).graphic === moved)
+        XCTAssertTrue(try hit(tester, at: NSPoint(x: 325.0, y: 125.0)).graphic === other)
+    }
+
+    func testStaleQueriesAreCancelled() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let page = document.page
+        for index in 0 ..< 200 {
+            _ = makeGraphic(frame: NSRect(x: CGFloat(index), y: 0.0, width: 1.0, height: 1.0), on: page)
+        }
+        let snapshot = try XCTUnwrap(page.hoverTester.currentSnapshot())
+
+        XCTAssertNil(snapshot.hit(at: NSPoint(x: 1000.0, y: 1000.0), isCancelled: { true }))
+    }
+
+}
@@ -0,0 +1,83 @@
+/*
+ DrawLevelOfDetailTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawLevelOfDetailTests: XCTestCase {
+
+    override class func setUp() {
+        _ = AJRPlugInManager.shared
+    }
+
+    func makeContext(scale: CGFloat) -> NSGraphicsContext {
+        let context = CGContext(data: nil, width: 64, height: 64, bitsPerComponent: 8, bytesPerRow: 0, space: CGColorSpace(name: CGColorSpace.sRGB)!, bitmapInfo: CGImageAlphaInfo.premultipliedLast.rawValue)!
+        context.scaleBy(x: scale, y: scale)
+        return NSGraphicsContext(cgContext: context, flipped: false)
+    }
+
+    func makeGraphic(size: CGFloat, on page: DrawPage?) -> DrawGraphic {
+        let graphic = DrawRectangle(frame: NSRect(x: 10.0, y: 10.0, width: size, height: size / 2.0))
+        page?.addGraphic(graphic)
+        return graphic
+    }
+
+    func testLevelFollowsDeviceSize() throws {
+        let page = try DrawDocument(type: "com.ajr.papel").page
+        let context = makeContext(scale: 1.0)
+        let placeholder = DrawGraphic.placeholderDetailSize
+        let reduced = DrawGraphic.reducedDetailSize
+        try XCTSkipIf(placeholder <= 0.0 || reduced <= placeholder, "Level of detail is turned off in the user defaults.")
+
+        XCTAssertEqual(makeGraphic(size: placeholder / 2.0, on: page).levelOfDetail(in: context), .placeholder)
+        XCTAssertEqual(makeGraphic(size: (placeholder + reduced) / 2.0, on: page).levelOfDetail(in: context), .reduced)
+        XCTAssertEqual(makeGraphic(size: reduced * 2.0, on: page).levelOfDetail(in: context), .full)
+    }
+
+    func testZoomingInRestoresDetail() throws {
+        let page = try DrawDocument(type: "com.ajr.papel").page
+        let placeholder = DrawGraphic.placeholderDetailSize
+        let reduced = DrawGraphic.reducedDetailSize
+        try XCTSkipIf(placeholder <= 0.0 || reduced <= placeholder, "Level of detail is turned off in the user defaults.")
+        let graphic = makeGraphic(size: placeholder / 2.0, on: page)
+
+        // The longer side is what counts, so this is just over the reduced size in device pixels.
+        let zoom = (reduced / (placeholder / 2.0)) * 1.01
+        XCTAssertEqual(graphic.levelOfDetail(in: makeContext(scale: zoom)), .full)
+    }
+
+    func testGraphicsOffThePageDrawInFull() {
+        let graphic = makeGraphic(size: 1.0, on: nil)
+        XCTAssertEqual(graphic.levelOfDetail(in: makeContext(scale: 1.0)), .full)
+    }
+
+}
@@ -0,0 +1,101 @@
+/*
+ DrawLinkRouterTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawLinkRouterTests: XCTestCase {
+
+    func assertOrthogonal(_ route: [NSPoint], file: StaticString = #file, line: UInt = #line) {
+        XCTAssert(route.count >= 2, file: file, line: line)
+        for (a, b) in zip(route, route.dropFirst()) {
+            XCTAssert(a.x == b.x || a.y == b.y, "\(a) -> \(b) isn't horizontal or vertical", file: file, line: line)
+        }
+    }
+
+    func route(_ route: [NSPoint], crosses rect: NSRect) -> Bool {
+        for (a, b) in zip(route, route.dropFirst()) {
+            let segment = NSRect(x: min(a.x, b.x), y: min(a.y, b.y), width: abs(a.x - b.x), height: abs(a.y - b.y))
+            if segment.minX < rect.maxX && segment.maxX > rect.minX && segment.minY < rect.maxY && segment.maxY > rect.minY {
+                return true
+            }
+        }
+        return false
+    }
+
+    func testStraightAcross() {
+        let source = NSRect(x: 0.0, y: 0.0, width: 50.0, height: 50.0)
+        let destination = NSRect(x: 200.0, y: 0.0, width: 50.0, height: 50.0)
+        let route = DrawLinkRouter.orthogonalRoute(from: source, to: destination, avoiding: [], margin: 12.0)
+
+        XCTAssertEqual(route, [NSPoint(x: 50.0, y: 25.0), NSPoint(x: 200.0, y: 25.0)])
+    }
+
+    func testRoutesAroundObstacle() {
+        let source = NSRect(x: 0.0, y: 0.0, width: 50.0, height: 50.0)
+        let destination = NSRect(x: 300.0, y: 0.0, width: 50.0, height: 50.0)
+        let obstacle = NSRect(x: 125.0, y: -50.0, width: 50.0, height: 150.0)
+        let route = DrawLinkRouter.orthogonalRoute(from: source, to: destination, avoiding: [obstacle], margin: 12.0)
+
+        assertOrthogonal(route)
+        XCTAssertFalse(self.route(route, crosses: obstacle))
+        XCTAssertFalse(self.route(route, crosses: source.insetBy(dx: 1.0, dy: 1.0)))
+        XCTAssertFalse(self.route(route, crosses: destination.insetBy(dx: 1.0, dy: 1.0)))
+    }
+
+    func testElbowFallback() {
+        let route = DrawLinkRouter.elbow(from: NSRect(x: 0.0, y: 0.0, width: 50.0, height: 50.0), to: NSRect(x: 200.0, y: 100.0, width: 50.0, height: 50.0))
+
+        assertOrthogonal(route)
+        XCTAssertEqual(route.first, NSPoint(x: 50.0, y: 25.0))
+        XCTAssertEqual(route.last, NSPoint(x: 200.0, y: 125.0))
+    }
+
+    func testSpatialIndex() {
+        let index = DrawSpatialIndex<NSObject>(cellSize: 100.0)
+        let near = NSObject(), far = NSObject()
+        index.insert(near, rect: NSRect(x: 10.0, y: 10.0, width: 20.0, height: 20.0))
+        index.insert(far, rect: NSRect(x: 1000.0, y: 1000.0, width: 20.0, height: 20.0))
+
+        XCTAssert(index.elements(intersecting: NSRect(x: 0.0, y: 0.0, width: 50.0, height: 50.0)) == [near])
+        index.insert(near, rect: NSRect(x: 990.0, y: 990.0, width: 20.0, height: 20.0))
+        XCTAssert(index.elements(intersecting: NSRect(x: 0.0, y: 0.0, width: 50.0, height: 50.0)).isEmpty)
+        // Moving out of a cell doesn't leave it behind, empty.
+        XCTAssertEqual(index.occupiedCellCount, 4)
+        XCTAssertEqual(index.elements(intersecting: NSRect(x: 980.0, y: 980.0, width: 100.0, height: 100.0)).count, 2)
+        index.remove(far)
+        XCTAssertEqual(index.count, 1)
+        index.remove(near)
+        XCTAssertEqual(index.occupiedCellCount, 0)
+    }
+
+}
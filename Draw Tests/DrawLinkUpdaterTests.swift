@@ -0,0 +1,67 @@
+/*
+ DrawLinkUpdaterTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawLinkUpdaterTests: XCTestCase {
+
+    override class func setUp() {
+        _ = AJRPlugInManager.shared
+    }
+
+    func testShapeChangesWaitForTheEventLoopUntilFlushed() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let graphic = DrawRectangle(frame: NSRect(x: 100.0, y: 100.0, width: 50.0, height: 50.0))
+        document.page.addGraphic(graphic)
+        DrawLinkUpdater.flush()
+
+        graphic.frame = graphic.frame.offsetBy(dx: 10.0, dy: 0.0)
+        graphic.frame = graphic.frame.offsetBy(dx: 10.0, dy: 0.0)
+        XCTAssertEqual(DrawLinkUpdater.shared.changedGraphics.filter { $0 === graphic }.count, 1)
+
+        DrawLinkUpdater.flush()
+        XCTAssertFalse(DrawLinkUpdater.shared.hasPendingChanges)
+    }
+
+    func testScheduledShapeChangesRunWhileTracking() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let graphic = DrawRectangle(frame: NSRect(x: 100.0, y: 100.0, width: 50.0, height: 50.0))
+        document.page.addGraphic(graphic)
+        DrawLinkUpdater.flush()
+
+        graphic.frame = graphic.frame.offsetBy(dx: 10.0, dy: 0.0)
+        RunLoop.current.run(mode: .eventTracking, before: Date(timeIntervalSinceNow: 0.1))
+        XCTAssertFalse(DrawLinkUpdater.shared.hasPendingChanges)
+    }
+
+}
@@ -0,0 +1,477 @@
+/*
+ DrawPerformanceTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+/// One benchmark's timings, in seconds.
+struct DrawBenchmarkResult : Codable {
+
+    var name : String
+    var iterations : Int
+    var min : Double
+    var median : Double
+    var mean : Double
+    var max : Double
+    var parameters : [String:Int]
+
+}
+
+/**
+ Performance coverage for the common document operations.
+
+ Every benchmark runs against a document from `DrawSyntheticDocumentGenerator`, so numbers are comparable across builds. When the class finishes, all results are written as JSON to the path in the `DRAW_BENCHMARK_OUTPUT` environment variable, or to `DrawBenchmarks.json` in the temporary directory when it's not set.
+ */
+class DrawPerformanceTests: XCTestCase {
+
+    static var results = [DrawBenchmarkResult]()
+    static let iterations = 5
+
+    override class func setUp() {
+        _ = AJRPlugInManager.shared
+    }
+
+    override class func tearDown() {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        guard let data = try? encoder.encode(results) else { return }
+
+        let path = ProcessInfo.processInfo.environment["DRAW_BENCHMARK_OUTPUT"] ?? FileManager.default.temporaryDirectory.appendingPathComponent("DrawBenchmarks.json").path
+        do {
+            try data.write(to: URL(fileURLWithPath: path))
+            print("Wrote benchmark results to \(path)")
+        } catch {
+            print("Failed to write benchmark results to \(path): \(error)")
+        }
+        if let string = String(data: data, encoding: .utf8) {
+            print(string)
+        }
+    }
+
+    // MARK: - Utilities
+
+    func makeGenerator() -> DrawSyntheticDocumentGenerator {
+        let generator = DrawSyntheticDocumentGenerator()
+        generator.pageCount = 2
+        generator.layerCount = 2
+        generator.graphicsPerPage = 5_000
+        generator.linksPerPage = 100
+        return generator
+    }
+
+    func makeDocument() throws -> DrawDocument {
+        let document = try makeGenerator().createDocument()
+        // We're not running in an event loop, so we have to group undo ourselves.
+        document.undoManager?.groupsByEvent = false
+        return document
+    }
+
+    /// Times `block` `iterations` times. `prepare` runs before each iteration and isn't timed. `generator` is the one that built the document under test, and defaults to `makeGenerator()`'s.
+    func benchmark(_ name: String, generator: DrawSyntheticDocumentGenerator? = nil, iterations: Int = DrawPerformanceTests.iterations, prepare: (() throws -> Void)? = nil, _ block: () throws -> Void) rethrows {
+        var samples = [Double]()
+
+        for _ in 0 ..< iterations {
+            try prepare?()
+            let start = DispatchTime.now()
+            try autoreleasepool {
+                try block()
+            }
+            samples.append(Double(DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds) / 1.0e9)
+        }
+
+        samples.sort()
+        let generator = generator ?? makeGenerator()
+        let result = DrawBenchmarkResult(name: name,
+                                         iterations: iterations,
+                                         min: samples.first ?? 0.0,
+                                         median: samples.isEmpty ? 0.0 : samples[samples.count / 2],
+                                         mean: samples.reduce(0.0, +) / Double(Swift.max(samples.count, 1)),
+                                         max: samples.last ?? 0.0,
+                                         parameters: ["pages": generator.pageCount,
+                                                      "layers": generator.layerCount,
+                                                      "graphicsPerPage": generator.graphicsPerPage,
+                                                      "linksPerPage": generator.linksPerPage,
+                                                      "groupSize": generator.groupSize])
+        DrawPerformanceTests.results.append(result)
+        print(String(format: "%@: median %.2f ms (min %.2f, max %.2f)", name, result.median * 1000.0, result.min * 1000.0, result.max * 1000.0))
+    }
+
+    func allGraphics(in document: DrawDocument) -> [DrawGraphic] {
+        var graphics = [DrawGraphic]()
+        for page in document.pages {
+            for layer in document.layers {
+                for graphic in page.graphics(for: layer) {
+                    if let graphic = graphic as? DrawGraphic {
+                        graphics.append(graphic)
+                    }
+                }
+            }
+        }
+        return graphics
+    }
+
+    /// Runs `block` with a bitmap the size of `page` set as the current, flipped, graphics context.
+    func drawing(on page: DrawPage, _ block: (CGContext) throws -> Void) throws {
+        let size = page.bounds.size
+        let context = try XCTUnwrap(CGContext(data: nil, width: Int(size.width), height: Int(size.height), bitsPerComponent: 8, bytesPerRow: 0, space: CGColorSpace(name: CGColorSpace.sRGB)!, bitmapInfo: CGImageAlphaInfo.premultipliedLast.rawValue))
+
+        context.translateBy(x: 0.0, y: size.height)
+        context.scaleBy(x: 1.0, y: -1.0)
+        NSGraphicsContext.saveGraphicsState()
+        defer { NSGraphicsContext.restoreGraphicsState() }
+        NSGraphicsContext.current = NSGraphicsContext(cgContext: context, flipped: true)
+        try block(context)
+    }
+
+    // MARK: - I/O
+
+    func testSave() throws {
+        let document = try makeDocument()
+        try benchmark("save") {
+            _ = try document.fileWrapper(ofType: "com.ajr.papel")
+        }
+    }
+
+    func testOpen() throws {
+        let wrapper = try makeDocument().fileWrapper(ofType: "com.ajr.papel")
+        try benchmark("open") {
+            let document = try DrawDocument(type: "com.ajr.papel")
+            try document.read(from: wrapper, ofType: "com.ajr.papel")
+        }
+    }
+
+    // MARK: - Drawing
+
+    func testDrawPage() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        let exporter = DrawBatchExporter(outputDirectory: FileManager.default.temporaryDirectory)
+
+        try drawing(on: page) { context in
+            benchmark("drawPage") {
+                exporter.draw(page, in: context)
+            }
+        }
+    }
+
+    // MARK: - Hit Testing
+
+    func testPointHitTest() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        var random = DrawSeededGenerator(seed: 42)
+        let points = (0 ..< 1_000).map { _ in NSPoint(x: CGFloat.random(in: 0 ..< page.bounds.width, using: &random), y: CGFloat.random(in: 0 ..< page.bounds.height, using: &random)) }
+
+        benchmark("hitTestPoint x1000") {
+            for point in points {
+                _ = page.graphicsHit(by: point)
+            }
+        }
+    }
+
+    func testRectHitTest() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        var random = DrawSeededGenerator(seed: 42)
+        let rects = (0 ..< 100).map { _ in NSRect(x: CGFloat.random(in: 0 ..< page.bounds.width, using: &random), y: CGFloat.random(in: 0 ..< page.bounds.height, using: &random), width: 72.0, height: 72.0) }
+
+        benchmark("hitTestRect x100") {
+            for rect in rects {
+                _ = page.graphicsHit(by: rect)
+            }
+        }
+    }
+
+    func testHoverHitTest() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        var random = DrawSeededGenerator(seed: 42)
+        let points = (0 ..< 1_000).map { _ in NSPoint(x: CGFloat.random(in: 0 ..< page.bounds.width, using: &random), y: CGFloat.random(in: 0 ..< page.bounds.height, using: &random)) }
+
+        benchmark("hoverSnapshot") {
+            page.hoverTester.invalidate()
+            _ = page.hoverTester.currentSnapshot()
+        }
+        let edited = try XCTUnwrap(allGraphics(in: document).first { $0.page === page })
+        benchmark("hoverSnapshot after edit") {
+            page.hoverTester.invalidate(edited)
+            _ = page.hoverTester.currentSnapshot()
+        }
+
+        let snapshot = try XCTUnwrap(page.hoverTester.currentSnapshot())
+        benchmark("hoverHitTest x1000") {
+            for point in points {
+                _ = snapshot.hit(at: point, isCancelled: { false })
+            }
+        }
+    }
+
+    func testLongPathHitTest() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        let squiggle = makeSquiggle(with: DrawSyntheticDocumentGenerator.freehandPoints(count: 10_000), on: page)
+        var random = DrawSeededGenerator(seed: 42)
+        let bounds = squiggle.frame
+        let points = (0 ..< 1_000).map { _ in NSPoint(x: CGFloat.random(in: bounds.minX ... bounds.maxX, using: &random), y: CGFloat.random(in: bounds.minY ... bounds.maxY, using: &random)) }
+
+        benchmark("hitTestLongPath x1000") {
+            for point in points {
+                _ = squiggle.flattenedPath.isStrokeHit(by: point, width: 3.0)
+            }
+        }
+    }
+
+    // MARK: - Squiggles
+
+    func makeSquiggle(with points: [NSPoint], on page: DrawPage) -> DrawSquiggle {
+        let path = AJRBezierPath()
+        path.move(to: points[0])
+        for point in points.dropFirst() {
+            path.line(to: point)
+        }
+        let squiggle = DrawSquiggle(frame: path.bounds, path: path)
+        page.addGraphic(squiggle)
+        return squiggle
+    }
+
+    func testSquiggleSimplification() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        let raw = DrawSyntheticDocumentGenerator.freehandPoints(count: 5_000)
+        let tolerance = DrawSquiggleSimplifier.tolerance(forScale: 1.0)
+        let simplified = DrawSquiggleSimplifier.simplify(raw, tolerance: tolerance)
+        let ratio = 1.0 - Double(simplified.count) / Double(raw.count)
+
+        print(String(format: "squiggle: %ld points simplified to %ld (%.1f%% reduction)", raw.count, simplified.count, ratio * 100.0))
+
+        let rawSquiggle = makeSquiggle(with: raw, on: page)
+        let simplifiedSquiggle = makeSquiggle(with: simplified, on: page)
+        let probes = stride(from: 0, to: raw.count, by: 50).map { raw[$0] }
+
+        try drawing(on: page) { _ in
+            benchmark("drawSquiggle raw") {
+                rawSquiggle.draw()
+            }
+            benchmark("drawSquiggle simplified") {
+                simplifiedSquiggle.draw()
+            }
+        }
+
+        benchmark("hitTestSquiggle raw x\(probes.count)") {
+            for point in probes {
+                _ = rawSquiggle.graphicsHit(by: point)
+            }
+        }
+        benchmark("hitTestSquiggle simplified x\(probes.count)") {
+            for point in probes {
+                _ = simplifiedSquiggle.graphicsHit(by: point)
+            }
+        }
+    }
+
+    // MARK: - Selection & Editing
+
+    func testSelectAll() throws {
+        let document = try makeDocument()
+        benchmark("selectAll", prepare: { document.clearSelection() }) {
+            document.selectAll(nil)
+        }
+    }
+
+    func testSelectIndividually() throws {
+        let document = try makeDocument()
+        let graphics = allGraphics(in: document)
+        let select = {
+            document.changeSelection {
+                for graphic in graphics {
+                    document.addGraphic(toSelection: graphic)
+                }
+            }
+        }
+        benchmark("selectIndividually x\(graphics.count)", prepare: { document.clearSelection() }) {
+            select()
+        }
+    }
+
+    func testMoveSelection() throws {
+        let document = try makeDocument()
+        document.selectAll(nil)
+        let selection = Array(document.selection)
+
+        benchmark("moveSelection") {
+            document.undoManager?.beginUndoGrouping()
+            for graphic in selection {
+                graphic.frame = graphic.frame.offsetBy(dx: 5.0, dy: 5.0)
+            }
+            document.undoManager?.endUndoGrouping()
+        }
+    }
+
+    func testMoveLinkedHub() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        let generator = makeGenerator()
+        var random = DrawSeededGenerator(seed: 11)
+        let hub = generator.createGraphic(in: page.bounds, using: &random)
+        page.addGraphic(hub, to: document.layers[0])
+        let others = (page.graphics(for: document.layers[0]) as? [DrawGraphic] ?? []).filter { !($0 is DrawLink) && $0 !== hub }.prefix(500)
+        for other in others {
+            let link = DrawLink(source: hub)
+            link.destination = other
+            page.addGraphic(link, to: document.layers[0])
+        }
+        DrawLinkUpdater.flush()
+
+        // One mouse event's worth of work: move the hub, then let the links catch up.
+        benchmark("moveHub x500 links", generator: generator) {
+            hub.frame = hub.frame.offsetBy(dx: 5.0, dy: 5.0)
+            DrawLinkUpdater.graphicDidChangeShape(hub)
+            DrawLinkUpdater.flush()
+        }
+    }
+
+    func testMoveWithOrthogonalLinks() throws {
+        let generator = makeGenerator()
+        generator.pageCount = 1
+        generator.linksPerPage = 2_000
+        let document = try generator.createDocument()
+        document.undoManager?.groupsByEvent = false
+        let page = document.pages[0]
+        let graphics = document.layers.flatMap { page.graphics(for: $0) as? [DrawGraphic] ?? [] }
+        for case let link as DrawLink in graphics {
+            link.routing = .orthogonal
+        }
+        DrawLinkUpdater.flush()
+        let node = try XCTUnwrap(graphics.first { !($0 is DrawLink) && !$0.relatedGraphics.isEmpty })
+
+        // One mouse event's worth of work: move a node, then re-route whatever it affected.
+        benchmark("moveNode x2000 orthogonal links", generator: generator) {
+            node.frame = node.frame.offsetBy(dx: 5.0, dy: 5.0)
+            DrawLinkUpdater.graphicDidChangeShape(node)
+            DrawLinkUpdater.flush()
+        }
+    }
+
+    func testMoveLargePath() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        let squiggle = makeSquiggle(with: DrawSyntheticDocumentGenerator.freehandPoints(count: 20_000), on: page)
+
+        // One drag tick's worth of work per iteration.
+        benchmark("moveLargePath x20000") {
+            squiggle.frame = squiggle.frame.offsetBy(dx: 1.0, dy: 1.0)
+        }
+    }
+
+    func testResizeLargeGroup() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        let generator = makeGenerator()
+        generator.groupSize = 10_000
+        var random = DrawSeededGenerator(seed: 45)
+        let group = generator.createGroup(in: page.bounds, using: &random)
+        page.addGraphic(group, to: document.layers[0])
+        let frame = group.frame
+
+        var grow = true
+        benchmark("resizeGroup x10000", generator: generator) {
+            group.frame = grow ? frame.insetBy(dx: -frame.width / 4.0, dy: -frame.height / 4.0) : frame
+            grow.toggle()
+        }
+    }
+
+    func testDrawHandles() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        let graphics = allGraphics(in: document).filter { $0.page === page }
+        let renderer = page.handleRenderer
+
+        try drawing(on: page) { _ in
+            benchmark("drawHandles x\(graphics.count)") {
+                renderer.beginBatch()
+                for graphic in graphics {
+                    graphic.drawHandles()
+                }
+                renderer.endBatch()
+            }
+        }
+    }
+
+    func testDrawGrid() throws {
+        let document = try makeDocument()
+        let page = document.pages[0]
+        let dirtyRect = NSRect(x: 100.0, y: 100.0, width: 200.0, height: 150.0)
+        document.gridVisible = true
+        document.gridSpacing = 9.0
+
+        try drawing(on: page) { _ in
+            benchmark("drawGrid full page") {
+                document.drawGrid(in: page.bounds, in: page)
+            }
+            benchmark("drawGrid dirty rect") {
+                document.drawGrid(in: dirtyRect, in: page)
+            }
+        }
+    }
+
+    func testUndo() throws {
+        let document = try makeDocument()
+        document.selectAll(nil)
+        let selection = Array(document.selection)
+
+        benchmark("undoMove", prepare: {
+            document.undoManager?.beginUndoGrouping()
+            for graphic in selection {
+                graphic.frame = graphic.frame.offsetBy(dx: 5.0, dy: 5.0)
+            }
+            document.undoManager?.endUndoGrouping()
+        }) {
+            document.undoManager?.undo()
+        }
+    }
+
+    func testCopyPaste() throws {
+        let document = try makeDocument()
+        // Use a private pasteboard, so running the tests doesn't clobber whatever the user has copied.
+        let pasteboard = NSPasteboard(name: NSPasteboard.Name("com.ajr.draw.tests.\(UUID().uuidString)"))
+        defer { pasteboard.releaseGlobally() }
+        document.selectAll(nil)
+
+        benchmark("copy") {
+            _ = document.copy(to: pasteboard)
+        }
+        benchmark("paste") {
+            document.paste(from: pasteboard)
+        }
+    }
+
+}
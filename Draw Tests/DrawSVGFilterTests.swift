@@ -0,0 +1,160 @@
+/*
+ DrawSVGFilterTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawSVGFilterTests: XCTestCase {
+
+    override class func setUp() {
+        _ = AJRPlugInManager.shared
+    }
+
+    func createDocument(graphicCount: Int) throws -> DrawDocument {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let page = document.page
+        let fills = [DrawFill(graphic: nil, color: .red),
+                     DrawFill(graphic: nil, startColor: .white, endColor: .blue, angle: 90.0, colorSpace: .sRGB)]
+        let columns = 100
+
+        DrawGraphic.disableNotifications()
+        defer { DrawGraphic.enableNotifications() }
+        document.editWithoutUndoTracking {
+            for index in 0 ..< graphicCount {
+                let frame = NSRect(x: CGFloat(index % columns) * 6.0, y: CGFloat(index / columns % 120) * 6.0, width: 5.0, height: 5.0)
+                let graphic = DrawRectangle(frame: frame)
+                let fill = fills[index % fills.count].copy() as! DrawFill
+                fill.graphic = graphic
+                graphic.addAspect(fill, with: .background)
+                graphic.addAspect(DrawStroke(graphic: graphic), with: .foreground)
+                if index % 10 == 0 {
+                    graphic.addAspect(DrawShadow(graphic: graphic), with: .beforeBackground)
+                }
+                page.addGraphic(graphic)
+            }
+        }
+
+        return document
+    }
+
+    func write(_ document: DrawDocument) throws -> Data {
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString).appendingPathExtension("svg")
+        defer { try? FileManager.default.removeItem(at: url) }
+        try DrawSVGFilter().write(document, to: url)
+        return try Data(contentsOf: url)
+    }
+
+    func count(_ needle: String, in haystack: String) -> Int {
+        return haystack.components(separatedBy: needle).count - 1
+    }
+
+    func testSharedDefinitions() throws {
+        let document = try createDocument(graphicCount: 100)
+        let string = String(data: try write(document), encoding: .utf8) ?? ""
+
+        XCTAssert(string.hasPrefix("<?xml"))
+        XCTAssert(string.hasSuffix("</svg>\n"))
+        // 50 graphics share the gradient, 10 share the shadow, but each is only defined once.
+        XCTAssertEqual(count("<linearGradient", in: string), 1)
+        XCTAssertEqual(count("<filter", in: string), 1)
+        // Fill and stroke are folded into a single element per graphic.
+        XCTAssertEqual(count("<path", in: string), 100)
+        XCTAssertNotNil(DrawFilter.writeFilter(forType: "svg"))
+    }
+
+    func testPatternsDependOnSizing() throws {
+        let writer = DrawSVGWriter(fileHandle: FileHandle.nullDevice)
+        let image = NSImage(size: NSSize(width: 4.0, height: 4.0), flipped: false) { rect in
+            NSColor.red.set()
+            rect.fill()
+            return true
+        }
+        let fillers = [DrawFillImage.Sizing.tile, .tile, .stretch].map { sizing -> DrawFillImage in
+            let filler = DrawFillImage()
+            filler.image = image
+            filler.sizing = sizing
+            return filler
+        }
+
+        XCTAssertEqual(writer.patternId(for: fillers[0]), writer.patternId(for: fillers[1]))
+        XCTAssertNotEqual(writer.patternId(for: fillers[0]), writer.patternId(for: fillers[2]))
+        fillers[1].scale = 2.0
+        XCTAssertNotEqual(writer.patternId(for: fillers[0]), writer.patternId(for: fillers[1]))
+    }
+
+    func testStyleStringsUseCSSEscapes() {
+        let writer = DrawSVGWriter(fileHandle: FileHandle.nullDevice)
+        XCTAssertEqual(writer.cssEscape("Joe's <Font> & Co"), "Joe\\'s \\3C Font\\3E  \\26  Co")
+    }
+
+    func testGroupChildrenAreClippedBelowTheForeground() throws {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let group = DrawRectangle(frame: NSRect(x: 10.0, y: 10.0, width: 100.0, height: 100.0))
+        let groupFill = DrawFill(graphic: nil, color: .red)
+        groupFill.graphic = group
+        group.addAspect(groupFill, with: .background)
+        group.addAspect(DrawStroke(graphic: group), with: .foreground)
+        let child = DrawRectangle(frame: NSRect(x: 60.0, y: 60.0, width: 100.0, height: 100.0))
+        let childFill = DrawFill(graphic: nil, color: .blue)
+        childFill.graphic = child
+        child.addAspect(childFill, with: .background)
+
+        // Editing keeps the group from growing to fit the child.
+        group.editing = true
+        group.addSubgraphic(child)
+        group.editing = false
+        document.page.addGraphic(group)
+        XCTAssertFalse(group.frame.contains(child.frame))
+
+        let string = String(data: try write(document), encoding: .utf8) ?? ""
+        let clipPath = try XCTUnwrap(string.range(of: "<clipPath"))
+        let clipped = try XCTUnwrap(string.range(of: "clip-path=\"url(#"))
+        let clippedEnd = try XCTUnwrap(string.range(of: "</g>", range: clipped.upperBound ..< string.endIndex))
+
+        // The group's fill, on its own rather than folded with the stroke, then the clipped child, then the group's stroke.
+        XCTAssertEqual(count("<path", in: String(string[..<clipPath.lowerBound])), 1)
+        XCTAssertEqual(count("<path", in: String(string[clipPath.lowerBound ..< clipped.lowerBound])), 1)
+        XCTAssertEqual(count("<path", in: String(string[clipped.upperBound ..< clippedEnd.lowerBound])), 1)
+        XCTAssertEqual(count("<path", in: String(string[clippedEnd.upperBound...])), 1)
+    }
+
+    func testLargeDocumentBenchmark() throws {
+        let document = try createDocument(graphicCount: 100_000)
+        let start = DispatchTime.now()
+        let data = try write(document)
+        let elapsed = Double(DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds) / 1.0e9
+
+        print(String(format: "SVG: 100k graphics, %.1f MB, %.2f s (%.0f graphics/s)", Double(data.count) / (1024.0 * 1024.0), elapsed, 100_000.0 / elapsed))
+        XCTAssertGreaterThan(data.count, 0)
+    }
+
+}
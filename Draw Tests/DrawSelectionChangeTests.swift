@@ -0,0 +1,113 @@
+/*
+ DrawSelectionChangeTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawSelectionChangeTests: XCTestCase {
+
+    override class func setUp() {
+        _ = AJRPlugInManager.shared
+    }
+
+    func makeDocument(graphicCount: Int) throws -> (DrawDocument, [DrawGraphic]) {
+        let document = try DrawDocument(type: "com.ajr.papel")
+        let graphics = (0 ..< graphicCount).map { index -> DrawGraphic in
+            let graphic = DrawRectangle(frame: NSRect(x: CGFloat(index % 20) * 25.0, y: CGFloat(index / 20) * 25.0, width: 20.0, height: 20.0))
+            document.page.addGraphic(graphic)
+            return graphic
+        }
+        return (document, graphics)
+    }
+
+    func testObserversHearAboutAGroupedChangeOnce() throws {
+        let (document, graphics) = try makeDocument(graphicCount: 100)
+        var notifications = 0
+        let observation = document.observe(\.selection) { _, _ in notifications += 1 }
+        defer { observation.invalidate() }
+
+        document.changeSelection {
+            for graphic in graphics {
+                document.addGraphic(toSelection: graphic)
+            }
+            XCTAssertTrue(document.isChangingSelection)
+            XCTAssertEqual(notifications, 0)
+        }
+
+        XCTAssertEqual(notifications, 1)
+        XCTAssertFalse(document.isChangingSelection)
+        XCTAssertEqual(document.selection.count, graphics.count)
+    }
+
+    func testNestedChangesCommitAtTheOutermostEnd() throws {
+        let (document, graphics) = try makeDocument(graphicCount: 4)
+        var notifications = 0
+        let observation = document.observe(\.selection) { _, _ in notifications += 1 }
+        defer { observation.invalidate() }
+
+        document.beginSelectionChanges()
+        document.changeSelection {
+            document.addGraphics(toSelection: graphics as NSArray)
+        }
+        XCTAssertEqual(notifications, 0)
+        XCTAssertTrue(document.isChangingSelection)
+        document.endSelectionChanges()
+
+        XCTAssertEqual(notifications, 1)
+    }
+
+    func testUnchangedSelectionDoesNotNotify() throws {
+        let (document, graphics) = try makeDocument(graphicCount: 4)
+        document.addGraphics(toSelection: graphics as NSArray)
+        var notifications = 0
+        let observation = document.observe(\.selection) { _, _ in notifications += 1 }
+        defer { observation.invalidate() }
+
+        document.addGraphics(toSelection: graphics as NSArray)
+
+        XCTAssertEqual(notifications, 0)
+    }
+
+    func testOverlayIsInvalidatedWhenTheChangeCommits() throws {
+        let (document, graphics) = try makeDocument(graphicCount: 10)
+        let overlay = document.page.overlayView
+        overlay.needsDisplay = false
+
+        document.changeSelection {
+            document.addGraphic(toSelection: graphics[3])
+            XCTAssertFalse(overlay.needsDisplay)
+        }
+
+        XCTAssertTrue(overlay.needsDisplay)
+    }
+
+}
@@ -0,0 +1,123 @@
+/*
+ DrawSelectionSummaryTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawSelectionSummaryTests: XCTestCase {
+
+    var graphicCount = 0
+
+    func makeGraphic(flatness: CGFloat) -> DrawGraphic {
+        // Graphics compare by content, so keep them apart.
+        graphicCount += 1
+        let graphic = DrawGraphic(frame: NSRect(x: CGFloat(graphicCount) * 20.0, y: 0.0, width: 10.0, height: 10.0))
+        graphic.flatness = flatness
+        return graphic
+    }
+
+    func testHistogramTracksAddsRemovesAndChanges() {
+        let graphics = [makeGraphic(flatness: 1.0), makeGraphic(flatness: 1.0), makeGraphic(flatness: 3.0)]
+        let summary = DrawSelectionSummary()
+
+        summary.addGraphic(graphics[0])
+        let histogram = summary.histogram(forKeyPath: "flatness")
+        XCTAssertFalse(histogram.isMixed)
+        XCTAssertEqual((histogram.commonValue as? NSNumber)?.doubleValue, 1.0)
+
+        summary.addGraphic(graphics[1])
+        summary.addGraphic(graphics[2])
+        XCTAssertEqual(summary.count, 3)
+        XCTAssertTrue(histogram.isMixed)
+        XCTAssertNil(histogram.commonValue)
+        XCTAssertEqual(histogram.count(of: 1.0), 2)
+        XCTAssertEqual(histogram.minimum?.doubleValue, 1.0)
+        XCTAssertEqual(histogram.maximum?.doubleValue, 3.0)
+
+        // Changing the only graphic at the maximum should move the maximum.
+        graphics[2].flatness = 2.0
+        summary.graphicDidChange(graphics[2])
+        XCTAssertEqual(histogram.maximum?.doubleValue, 2.0)
+
+        graphics[2].flatness = 1.0
+        summary.graphicDidChange(graphics[2])
+        XCTAssertFalse(histogram.isMixed)
+        XCTAssertEqual(histogram.count(of: 1.0), 3)
+
+        summary.removeGraphic(graphics[0])
+        XCTAssertEqual(summary.count, 2)
+        XCTAssertEqual(histogram.count(of: 1.0), 2)
+
+        // Graphics that aren't in the summary are ignored.
+        summary.graphicDidChange(graphics[0])
+        XCTAssertEqual(summary.count, 2)
+
+        summary.removeAllGraphics()
+        XCTAssertEqual(histogram.distinctValueCount, 0)
+        XCTAssertNil(histogram.minimum)
+    }
+
+    func testMutableValuesAreCountedAsTheyWereRead() {
+        let value = NSMutableString(string: "a")
+        let key = DrawSelectionHistogram.key(for: value)
+        value.append("b")
+
+        XCTAssertEqual(key, DrawSelectionHistogram.key(for: "a" as NSString))
+        XCTAssertNotEqual(key, DrawSelectionHistogram.key(for: value))
+    }
+
+    func testUncopyableValuesAreCountedByIdentity() {
+        let value = NSObject()
+
+        XCTAssertEqual(DrawSelectionHistogram.key(for: value), DrawSelectionHistogram.key(for: value))
+        XCTAssertNotEqual(DrawSelectionHistogram.key(for: value), DrawSelectionHistogram.key(for: NSObject()))
+    }
+
+    func testGroups() {
+        let group = makeGraphic(flatness: 1.0)
+        let other = makeGraphic(flatness: 1.0)
+        let summary = DrawSelectionSummary(graphics: [group, other])
+        XCTAssertEqual(summary.groupCount, 0)
+        XCTAssertNil(summary.group)
+
+        let child = makeGraphic(flatness: 1.0)
+        group.addSubgraphic(child)
+        summary.graphicDidChange(group)
+        XCTAssertEqual(summary.groupCount, 1)
+        XCTAssertTrue(summary.group === group)
+
+        child.removeFromSupergraphic()
+        summary.graphicDidChange(group)
+        XCTAssertEqual(summary.groupCount, 0)
+    }
+
+}
@@ -0,0 +1,82 @@
+/*
+ DrawSquiggleSimplifierTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+@testable import Draw
+
+class DrawSquiggleSimplifierTests: XCTestCase {
+
+    func distance(from point: NSPoint, toSegmentFrom a: NSPoint, to b: NSPoint) -> CGFloat {
+        let dx = b.x - a.x
+        let dy = b.y - a.y
+        let lengthSquared = dx * dx + dy * dy
+        let t = lengthSquared == 0.0 ? 0.0 : max(0.0, min(1.0, ((point.x - a.x) * dx + (point.y - a.y) * dy) / lengthSquared))
+        return hypot(point.x - (a.x + t * dx), point.y - (a.y + t * dy))
+    }
+
+    func testFreehandStrokeStaysWithinTolerance() {
+        let raw = DrawSyntheticDocumentGenerator.freehandPoints(count: 5_000)
+        let tolerance = DrawSquiggleSimplifier.tolerance(forScale: 1.0)
+        let simplified = DrawSquiggleSimplifier.simplify(raw, tolerance: tolerance)
+
+        XCTAssertLessThan(simplified.count, raw.count / 2)
+        XCTAssertEqual(simplified.first, raw.first)
+        XCTAssertEqual(simplified.last, raw.last)
+
+        // Each raw point lies within tolerance of the simplified stroke. The points arrive in order, so only the segments from the current one on need checking.
+        var segment = 0
+        for point in raw {
+            while segment < simplified.count - 2 && distance(from: point, toSegmentFrom: simplified[segment], to: simplified[segment + 1]) > tolerance {
+                segment += 1
+            }
+            XCTAssertLessThanOrEqual(distance(from: point, toSegmentFrom: simplified[segment], to: simplified[segment + 1]), tolerance + 1e-9)
+        }
+    }
+
+    func testStraightLineCollapses() {
+        let line = (0 ... 50).map { NSPoint(x: CGFloat($0) * 2.0, y: CGFloat($0)) }
+        XCTAssertEqual(DrawSquiggleSimplifier.simplify(line, tolerance: 0.5), [line.first!, line.last!])
+    }
+
+    func testZoomKeepsMoreDetail() {
+        XCTAssertLessThan(DrawSquiggleSimplifier.tolerance(forScale: 4.0), DrawSquiggleSimplifier.tolerance(forScale: 1.0))
+    }
+
+    func testIncrementalCounts() {
+        let simplifier = DrawSquiggleSimplifier(anchor: .zero, tolerance: 0.5)
+        XCTAssertTrue(simplifier.add(NSPoint(x: 10.0, y: 0.0)))
+        XCTAssertFalse(simplifier.add(NSPoint(x: 20.0, y: 0.0)))
+        XCTAssertTrue(simplifier.add(NSPoint(x: 20.0, y: 10.0)))
+        XCTAssertEqual(simplifier.inputPointCount, 4)
+        XCTAssertEqual(simplifier.outputPointCount, 3)
+    }
+
+}
@@ -0,0 +1,97 @@
+/*
+ DrawSubgraphicHierarchyTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawSubgraphicHierarchyTests: XCTestCase {
+
+    func makeGraphics(_ count: Int) -> [(graphic: DrawGraphic, frame: NSRect)] {
+        var generator = DrawSeededGenerator(seed: 44)
+        return (0 ..< count).map { _ in
+            let frame = NSRect(x: CGFloat.random(in: 0.0 ..< 2000.0, using: &generator),
+                               y: CGFloat.random(in: 0.0 ..< 2000.0, using: &generator),
+                               width: CGFloat.random(in: 1.0 ..< 80.0, using: &generator),
+                               height: CGFloat.random(in: 1.0 ..< 80.0, using: &generator))
+            return (DrawGraphic(frame: frame), frame)
+        }
+    }
+
+    func scan(_ graphics: [(graphic: DrawGraphic, frame: NSRect)], intersecting rect: NSRect) -> [DrawGraphic] {
+        return graphics.filter { DrawSubgraphicHierarchy.overlaps($0.frame, rect) }.map { $0.graphic }
+    }
+
+    func testQueriesMatchLinearScan() {
+        var graphics = makeGraphics(500)
+        let hierarchy = DrawSubgraphicHierarchy(inset: 0.0)
+        for (graphic, frame) in graphics {
+            hierarchy.append(graphic, frame: frame, bounds: frame)
+        }
+        XCTAssertEqual(hierarchy.count, 500)
+        XCTAssertLessThanOrEqual(hierarchy.height, 2 * Int(log2(500.0)) + 2)
+
+        // Move some, remove some, and insert one in the middle.
+        for index in stride(from: 0, to: graphics.count, by: 7) {
+            let frame = graphics[index].frame.offsetBy(dx: 300.0, dy: -150.0)
+            graphics[index].frame = frame
+            XCTAssertTrue(hierarchy.update(graphics[index].graphic, frame: frame, bounds: frame))
+        }
+        for index in stride(from: graphics.count - 1, through: 0, by: -11) {
+            hierarchy.remove(graphics[index].graphic)
+            graphics.remove(at: index)
+        }
+        let inserted = NSRect(x: 500.0, y: 500.0, width: 20.0, height: 20.0)
+        let graphic = DrawGraphic(frame: inserted)
+        hierarchy.insert(graphic, frame: inserted, bounds: inserted, between: graphics[9].graphic, and: graphics[10].graphic)
+        graphics.insert((graphic, inserted), at: 10)
+
+        XCTAssertEqual(hierarchy.count, graphics.count)
+        for rect in [NSRect(x: 400.0, y: 400.0, width: 300.0, height: 300.0), NSRect(x: 0.0, y: 0.0, width: 3000.0, height: 3000.0), NSRect(x: 1000.0, y: 1000.0, width: 0.0, height: 0.0)] {
+            XCTAssertEqual(hierarchy.graphics(intersecting: rect), scan(graphics, intersecting: rect))
+        }
+        let union = graphics.dropFirst().reduce(graphics[0].frame) { $0.union($1.frame) }
+        XCTAssertEqual(hierarchy.frame, union)
+    }
+
+    func testOffset() {
+        let graphics = makeGraphics(64)
+        let hierarchy = DrawSubgraphicHierarchy(inset: 0.0)
+        for (graphic, frame) in graphics {
+            hierarchy.append(graphic, frame: frame, bounds: frame)
+        }
+        let frame = hierarchy.frame
+        hierarchy.offset(byX: 25.0, y: -10.0)
+        XCTAssertEqual(hierarchy.frame, frame.offsetBy(dx: 25.0, dy: -10.0))
+        XCTAssertEqual(hierarchy.graphics(intersecting: graphics[3].frame.offsetBy(dx: 25.0, dy: -10.0)).contains(graphics[3].graphic), true)
+    }
+
+}
@@ -0,0 +1,226 @@
+/*
+ DrawSyntheticDocumentGenerator.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRInterface
+@testable import Draw
+
+/// A small, fast, seedable PRNG (SplitMix64), so generated documents are identical from run to run and machine to machine.
+struct DrawSeededGenerator : RandomNumberGenerator {
+
+    private var state : UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+
+}
+
+/**
+ Builds synthetic documents for tests and benchmarks.
+
+ Everything is driven by `seed`, so two generators with the same settings produce documents with identical graphics, in identical order, with identical aspects.
+ */
+class DrawSyntheticDocumentGenerator {
+
+    // MARK: - Settings
+
+    var seed : UInt64 = 0x5EED
+    var pageCount = 1
+    var layerCount = 1
+    var graphicsPerPage = 1_000
+
+    /// The probability that a graphic gets each kind of aspect. Fill and stroke are independent, so a graphic can have both, either, or neither.
+    var fillProbability = 0.8
+    var gradientProbability = 0.2  // Of the fills, how many are gradients rather than colors.
+    var strokeProbability = 0.9
+    var shadowProbability = 0.1
+    var textProbability = 0.05
+
+    /// The probability that a graphic is a group, and how many children each group gets.
+    var groupProbability = 0.02
+    var groupSize = 5
+    /// Links per page. Each joins two graphics chosen at random from that page.
+    var linksPerPage = 0
+
+    /// Graphics are scattered over the page in cells of this size.
+    var graphicSize = NSSize(width: 24.0, height: 18.0)
+
+    // MARK: - Generation
+
+    func createDocument() throws -> DrawDocument {
+        var random = DrawSeededGenerator(seed: seed)
+        let document = try DrawDocument(type: "com.ajr.papel")
+
+        DrawGraphic.disableNotifications()
+        defer { DrawGraphic.enableNotifications() }
+
+        document.editWithoutUndoTracking {
+            for index in 1 ..< max(layerCount, 1) {
+                document.addLayer(withName: "Layer \(index + 1)")
+            }
+            while document.pages.count < pageCount {
+                document.appendPage(nil)
+            }
+            for page in document.pages {
+                populate(page, in: document, using: &random)
+            }
+        }
+
+        return document
+    }
+
+    func populate(_ page: DrawPage, in document: DrawDocument, using random: inout DrawSeededGenerator) {
+        let layers = document.layers
+        var placed = [DrawGraphic]()
+
+        placed.reserveCapacity(graphicsPerPage)
+        for index in 0 ..< graphicsPerPage {
+            let layer = layers[index % layers.count]
+            let graphic : DrawGraphic
+            if Double.random(in: 0 ..< 1, using: &random) < groupProbability {
+                graphic = createGroup(in: page.bounds, using: &random)
+            } else {
+                graphic = createGraphic(in: page.bounds, using: &random)
+            }
+            page.addGraphic(graphic, to: layer)
+            placed.append(graphic)
+        }
+
+        if placed.count >= 2 {
+            for _ in 0 ..< linksPerPage {
+                let source = placed[Int.random(in: 0 ..< placed.count, using: &random)]
+                let destination = placed[Int.random(in: 0 ..< placed.count, using: &random)]
+                if source !== destination {
+                    let link = DrawLink(source: source)
+                    link.destination = destination
+                    link.addAspect(DrawStroke(graphic: link), with: .foreground)
+                    page.addGraphic(link, to: layers[0])
+                }
+            }
+        }
+    }
+
+    func randomFrame(in bounds: NSRect, using random: inout DrawSeededGenerator) -> NSRect {
+        let width = graphicSize.width * CGFloat.random(in: 0.5 ... 1.5, using: &random)
+        let height = graphicSize.height * CGFloat.random(in: 0.5 ... 1.5, using: &random)
+        let x = CGFloat.random(in: bounds.minX ... max(bounds.minX, bounds.maxX - width), using: &random)
+        let y = CGFloat.random(in: bounds.minY ... max(bounds.minY, bounds.maxY - height), using: &random)
+        return NSRect(x: x.rounded(), y: y.rounded(), width: width.rounded(), height: height.rounded())
+    }
+
+    func createShape(frame: NSRect, using random: inout DrawSeededGenerator) -> DrawGraphic {
+        switch Int.random(in: 0 ..< 3, using: &random) {
+        case 0:
+            return DrawRectangle(frame: frame)
+        case 1:
+            return DrawCircle(frame: frame)
+        default:
+            let path = AJRBezierPath()
+            path.move(to: NSPoint(x: frame.minX, y: frame.maxY))
+            for _ in 0 ..< Int.random(in: 2 ... 6, using: &random) {
+                path.line(to: NSPoint(x: CGFloat.random(in: frame.minX ... frame.maxX, using: &random).rounded(),
+                                      y: CGFloat.random(in: frame.minY ... frame.maxY, using: &random).rounded()))
+            }
+            return DrawPen(frame: frame, path: path)
+        }
+    }
+
+    func color(using random: inout DrawSeededGenerator) -> NSColor {
+        // Keep the palette small so that styles get shared, like they would be in a real drawing.
+        let palette : [NSColor] = [.red, .orange, .yellow, .green, .blue, .purple, .gray, .black]
+        return palette[Int.random(in: 0 ..< palette.count, using: &random)]
+    }
+
+    func createGraphic(in bounds: NSRect, using random: inout DrawSeededGenerator) -> DrawGraphic {
+        let graphic = createShape(frame: randomFrame(in: bounds, using: &random), using: &random)
+        addAspects(to: graphic, using: &random)
+        return graphic
+    }
+
+    func addAspects(to graphic: DrawGraphic, using random: inout DrawSeededGenerator) {
+        if Double.random(in: 0 ..< 1, using: &random) < shadowProbability {
+            graphic.addAspect(DrawShadow(graphic: graphic), with: .beforeBackground)
+        }
+        if Double.random(in: 0 ..< 1, using: &random) < fillProbability {
+            if Double.random(in: 0 ..< 1, using: &random) < gradientProbability {
+                graphic.addAspect(DrawFill(graphic: graphic, startColor: color(using: &random), endColor: color(using: &random), angle: 90.0, colorSpace: .sRGB), with: .background)
+            } else {
+                graphic.addAspect(DrawFill(graphic: graphic, color: color(using: &random)), with: .background)
+            }
+        }
+        if Double.random(in: 0 ..< 1, using: &random) < textProbability {
+            graphic.addAspect(DrawText(graphic: graphic, text: NSAttributedString(string: "Text \(Int.random(in: 0 ..< 1000, using: &random))")), with: .afterBackground)
+        }
+        if Double.random(in: 0 ..< 1, using: &random) < strokeProbability {
+            let stroke = DrawStroke(graphic: graphic)
+            stroke.color = color(using: &random)
+            graphic.addAspect(stroke, with: .foreground)
+        }
+    }
+
+    func createGroup(in bounds: NSRect, using random: inout DrawSeededGenerator) -> DrawGraphic {
+        // Same construction as -[DrawDocument group:].
+        let frame = randomFrame(in: bounds, using: &random).insetBy(dx: -graphicSize.width, dy: -graphicSize.height)
+        let group = DrawRectangle(frame: NSRect.zero)
+        group.removeAllAspects()
+        for _ in 0 ..< max(groupSize, 1) {
+            group.addSubgraphic(createGraphic(in: frame, using: &random))
+        }
+        return group
+    }
+
+    // MARK: - Freehand Strokes
+
+    /// A seeded freehand stroke: a heading that drifts a little with every sample, plus some hand jitter.
+    class func freehandPoints(count: Int, seed: UInt64 = 7) -> [NSPoint] {
+        var random = DrawSeededGenerator(seed: seed)
+        var point = NSPoint(x: 300.0, y: 300.0)
+        var angle : CGFloat = 0.0
+        var points = [point]
+
+        for _ in 1 ..< count {
+            angle += CGFloat.random(in: -0.15 ... 0.15, using: &random)
+            point.x += cos(angle) * 2.0 + CGFloat.random(in: -0.2 ... 0.2, using: &random)
+            point.y += sin(angle) * 2.0 + CGFloat.random(in: -0.2 ... 0.2, using: &random)
+            points.append(point)
+        }
+        return points
+    }
+
+}
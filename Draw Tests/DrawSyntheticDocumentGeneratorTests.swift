@@ -0,0 +1,85 @@
+/*
+ DrawSyntheticDocumentGeneratorTests.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import XCTest
+import AJRFoundation
+@testable import Draw
+
+class DrawSyntheticDocumentGeneratorTests: XCTestCase {
+
+    override class func setUp() {
+        _ = AJRPlugInManager.shared
+    }
+
+    func frames(in document: DrawDocument) -> [NSRect] {
+        var frames = [NSRect]()
+        for page in document.pages {
+            for layer in document.layers {
+                for case let graphic as DrawGraphic in page.graphics(for: layer) {
+                    frames.append(graphic.frame)
+                }
+            }
+        }
+        return frames
+    }
+
+    func makeGenerator() -> DrawSyntheticDocumentGenerator {
+        let generator = DrawSyntheticDocumentGenerator()
+        generator.pageCount = 2
+        generator.layerCount = 2
+        generator.graphicsPerPage = 500
+        generator.linksPerPage = 20
+        return generator
+    }
+
+    func testGeneratorIsDeterministic() throws {
+        let first = frames(in: try makeGenerator().createDocument())
+        let second = frames(in: try makeGenerator().createDocument())
+
+        // Every graphic, plus the links, less any that picked the same graphic at both ends.
+        XCTAssertGreaterThanOrEqual(first.count, 2 * 500)
+        XCTAssertLessThanOrEqual(first.count, 2 * (500 + 20))
+        XCTAssertEqual(first, second)
+    }
+
+    func testSeedChangesTheDocument() throws {
+        let other = makeGenerator()
+        other.seed += 1
+
+        XCTAssertNotEqual(frames(in: try makeGenerator().createDocument()), frames(in: try other.createDocument()))
+    }
+
+    func testFreehandPointsAreDeterministic() {
+        XCTAssertEqual(DrawSyntheticDocumentGenerator.freehandPoints(count: 100), DrawSyntheticDocumentGenerator.freehandPoints(count: 100))
+        XCTAssertEqual(DrawSyntheticDocumentGenerator.freehandPoints(count: 100).count, 100)
+    }
+
+}
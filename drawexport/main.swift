@@ -0,0 +1,145 @@
+/*
+ main.swift
+ Draw
+
+ Copyright © 2022, AJ Raftis and Draw authors
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of Draw nor the names of its contributors may be
+   used to endorse or promote products derived from this software without
+   specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL AJ RAFTIS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+import AJRFoundation
+import AppKit
+import Draw
+
+// drawexport: Renders Draw documents to PNG or PDF without bringing up any user interface.
+
+func printUsage() -> Never {
+    let usage = """
+    usage: drawexport [options] document ...
+
+      -f, --format png|pdf    Output format (default png).
+      -o, --output directory  Where to write the rendered pages (default is the current directory).
+      -p, --pages list        Pages to render, one based, e.g. "1,3-5" (default all).
+      -s, --scale factor      Raster scale for PNG output (default 1).
+      -j, --jobs count        Maximum pages rendered concurrently (default is the number of cores).
+      -b, --benchmark count   Export everything count times and report documents per minute.
+      -q, --quiet             Don't report per page timings.
+
+    """
+    FileHandle.standardError.write(usage.data(using: .utf8)!)
+    exit(64)
+}
+
+func parsePages(_ string: String) -> IndexSet? {
+    var pages = IndexSet()
+    for component in string.split(separator: ",") {
+        let bounds = component.split(separator: "-").map { Int($0.trimmingCharacters(in: .whitespaces)) }
+        if bounds.count == 1, let page = bounds[0] {
+            pages.insert(page)
+        } else if bounds.count == 2, let first = bounds[0], let last = bounds[1], first <= last {
+            pages.insert(integersIn: first ... last)
+        } else {
+            return nil
+        }
+    }
+    return pages
+}
+
+var arguments = CommandLine.arguments.dropFirst()
+let exporter = DrawBatchExporter(outputDirectory: URL(fileURLWithPath: FileManager.default.currentDirectoryPath))
+var benchmarkIterations = 0
+var quiet = false
+var documentURLs = [URL]()
+
+while let argument = arguments.popFirst() {
+    switch argument {
+    case "-f", "--format":
+        switch arguments.popFirst() {
+        case "png": exporter.format = .png
+        case "pdf": exporter.format = .pdf
+        default: printUsage()
+        }
+    case "-o", "--output":
+        guard let path = arguments.popFirst() else { printUsage() }
+        exporter.outputDirectory = URL(fileURLWithPath: path, isDirectory: true)
+    case "-p", "--pages":
+        guard let string = arguments.popFirst(), let pages = parsePages(string) else { printUsage() }
+        exporter.pageNumbers = pages
+    case "-s", "--scale":
+        guard let string = arguments.popFirst(), let scale = Double(string), scale > 0.0 else { printUsage() }
+        exporter.scale = CGFloat(scale)
+    case "-j", "--jobs":
+        guard let string = arguments.popFirst(), let jobs = Int(string), jobs > 0 else { printUsage() }
+        exporter.maxConcurrentPages = jobs
+    case "-b", "--benchmark":
+        guard let string = arguments.popFirst(), let count = Int(string), count > 0 else { printUsage() }
+        benchmarkIterations = count
+    case "-q", "--quiet":
+        quiet = true
+    case "-h", "--help":
+        printUsage()
+    default:
+        if argument.hasPrefix("-") {
+            printUsage()
+        }
+        documentURLs.append(URL(fileURLWithPath: argument))
+    }
+}
+
+if documentURLs.isEmpty {
+    printUsage()
+}
+
+// Graphics, aspects, and filters are all registered by the plug-in manager. We also need AppKit initialized for fonts and colors, but we never run the application.
+_ = NSApplication.shared
+_ = AJRPlugInManager.shared
+
+do {
+    try FileManager.default.createDirectory(at: exporter.outputDirectory, withIntermediateDirectories: true)
+} catch {
+    FileHandle.standardError.write("drawexport: \(error.localizedDescription)\n".data(using: .utf8)!)
+    exit(73)
+}
+
+var failures = 0
+let start = DispatchTime.now()
+let results = exporter.export(documentsAt: documentURLs) { result in
+    if result.error != nil {
+        failures += 1
+        print(result.description)
+    } else if !quiet {
+        print(result.description)
+    }
+}
+let elapsed = Double(DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds) / 1.0e9
+let rendered = results.filter { $0.error == nil }
+print(String(format: "%ld pages from %ld documents in %.2f s, process peak memory %.1f MB", rendered.count, documentURLs.count, elapsed, Double(DrawBatchExporter.peakResidentMemory) / (1024.0 * 1024.0)))
+
+if benchmarkIterations > 0 {
+    let documentsPerMinute = exporter.benchmark(documentsAt: documentURLs, iterations: benchmarkIterations)
+    print(String(format: "throughput: %.1f documents/minute over %ld iterations", documentsPerMinute, benchmarkIterations))
+}
+
+exit(failures == 0 ? 0 : 1)